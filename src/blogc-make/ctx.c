@@ -37,9 +37,8 @@ bm_filectx_new(bm_ctx_t *ctx, const char *filename, const char *slug,
     rv->short_path = bc_strdup(filename);
     rv->slug = bc_strdup(slug);
 
+    struct stat buf;
     if (st == NULL) {
-        struct stat buf;
-
         if (0 != stat(f, &buf)) {
             rv->tv_sec = 0;
             rv->tv_nsec = 0;
@@ -58,8 +57,9 @@ bm_filectx_new(bm_ctx_t *ctx, const char *filename, const char *slug,
 }
 
 
-bc_slist_t*
-bm_filectx_new_r(bc_slist_t *l, bm_ctx_t *ctx, const char *filename)
+static bc_slist_t*
+filectx_new_r(bc_slist_t *l, bc_slist_t **tail, bm_ctx_t *ctx,
+    const char *filename)
 {
     if (ctx == NULL || filename == NULL)
         return NULL;
@@ -85,7 +85,7 @@ bm_filectx_new_r(bc_slist_t *l, bm_ctx_t *ctx, const char *filename)
             if ((0 == strcmp(e->d_name, ".")) || (0 == strcmp(e->d_name, "..")))
                 continue;
             char *tmp = bc_strdup_printf("%s/%s", filename, e->d_name);
-            l = bm_filectx_new_r(l, ctx, tmp);
+            l = filectx_new_r(l, tail, ctx, tmp);
             free(tmp);
         }
 
@@ -94,12 +94,21 @@ bm_filectx_new_r(bc_slist_t *l, bm_ctx_t *ctx, const char *filename)
         return l;
     }
 
-    l = bc_slist_append(l, bm_filectx_new(ctx, filename, NULL, &buf));
+    l = bc_slist_append_tail(l, tail,
+        bm_filectx_new(ctx, filename, NULL, &buf));
     free(f);
     return l;
 }
 
 
+bc_slist_t*
+bm_filectx_new_r(bc_slist_t *l, bm_ctx_t *ctx, const char *filename)
+{
+    bc_slist_t *tail = NULL;
+    return filectx_new_r(l, &tail, ctx, filename);
+}
+
+
 bool
 bm_filectx_changed(bm_filectx_t *ctx, time_t *tv_sec, long *tv_nsec)
 {
@@ -264,32 +273,36 @@ bm_ctx_new(bm_ctx_t *base, const char *settings_file, const char *argv0,
         free(f);
     }
 
+    bc_slist_t *tail = NULL;
+
     rv->posts_fctx = NULL;
     if (settings->posts != NULL) {
         for (size_t i = 0; settings->posts[i] != NULL; i++) {
             char *f = bm_generate_filename(content_dir, blog_prefix, post_prefix,
                 settings->posts[i], source_ext);
-            rv->posts_fctx = bc_slist_append(rv->posts_fctx,
+            rv->posts_fctx = bc_slist_append_tail(rv->posts_fctx, &tail,
                 bm_filectx_new(rv, f, settings->posts[i], NULL));
             free(f);
         }
     }
 
+    tail = NULL;
     rv->pages_fctx = NULL;
     if (settings->pages != NULL) {
         for (size_t i = 0; settings->pages[i] != NULL; i++) {
             char *f = bm_generate_filename(content_dir, NULL, NULL, settings->pages[i],
                 source_ext);
-            rv->pages_fctx = bc_slist_append(rv->pages_fctx,
+            rv->pages_fctx = bc_slist_append_tail(rv->pages_fctx, &tail,
                 bm_filectx_new(rv, f, settings->pages[i], NULL));
             free(f);
         }
     }
 
+    tail = NULL;
     rv->copy_fctx = NULL;
     if (settings->copy != NULL) {
         for (size_t i = 0; settings->copy[i] != NULL; i++) {
-            rv->copy_fctx = bm_filectx_new_r(rv->copy_fctx, rv,
+            rv->copy_fctx = filectx_new_r(rv->copy_fctx, &tail, rv,
                 settings->copy[i]);
         }
     }
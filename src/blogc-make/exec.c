@@ -174,7 +174,7 @@ bm_exec_command(const char *cmd, const char *input, char **output,
             return 1;
         }
         if (out == NULL) {
-            out = bc_string_new();
+            out = bc_string_new_sized(BC_FILE_CHUNK_SIZE);
         }
         bc_string_append_len(out, buffer, s);
     }
@@ -193,7 +193,7 @@ bm_exec_command(const char *cmd, const char *input, char **output,
             return 1;
         }
         if (out == NULL)
-            out = bc_string_new();
+            out = bc_string_new_sized(BC_FILE_CHUNK_SIZE);
         bc_string_append_len(out, buffer, s);
     }
     if (out != NULL) {
@@ -198,6 +198,7 @@ atom_tags_outputlist(bm_ctx_t *ctx)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     const char *blog_prefix = bm_ctx_settings_lookup(ctx, "blog_prefix");
     const char *atom_prefix = bm_ctx_settings_lookup(ctx, "atom_prefix");
@@ -206,7 +207,8 @@ atom_tags_outputlist(bm_ctx_t *ctx)
     for (size_t i = 0; ctx->settings->tags[i] != NULL; i++) {
         char *f = bm_generate_filename(ctx->short_output_dir, blog_prefix,
             atom_prefix, ctx->settings->tags[i], atom_ext);
-        rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+        rv = bc_slist_append_tail(rv, &tail,
+            bm_filectx_new(ctx, f, NULL, NULL));
         free(f);
     }
 
@@ -280,6 +282,7 @@ pagination_outputlist(bm_ctx_t *ctx)
     free(last_page);
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     const char *blog_prefix = bm_ctx_settings_lookup(ctx, "blog_prefix");
     const char *pagination_prefix = bm_ctx_settings_lookup(ctx, "pagination_prefix");
@@ -289,7 +292,8 @@ pagination_outputlist(bm_ctx_t *ctx)
         char *j = bc_strdup_printf("%d", i + 1);
         char *f = bm_generate_filename(ctx->short_output_dir, blog_prefix,
             pagination_prefix, j, html_ext);
-        rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+        rv = bc_slist_append_tail(rv, &tail,
+            bm_filectx_new(ctx, f, NULL, NULL));
         free(j);
         free(f);
     }
@@ -357,33 +361,49 @@ pagination_tags_outputlist(bm_ctx_t *ctx)
     const char *pagination_prefix = bm_ctx_settings_lookup(ctx, "pagination_prefix");
     const char *html_ext = bm_ctx_settings_lookup(ctx, "html_ext");
 
+    // a single blogc call reports the page counts of every tag, as
+    // "tag:pages" pairs.
+    char *last_pages = bm_exec_blogc_get_variable(ctx, variables, NULL,
+        "TAG_LAST_PAGES", true, ctx->posts_fctx, false);
+
+    bc_trie_t *tag_pages = bc_trie_new(free);
+    bc_strview_t iter = bc_strview(last_pages);
+    bc_strview_t pair;
+    while (last_pages != NULL && bc_strview_split_next(&iter, ' ', &pair)) {
+        size_t sep = pair.len;
+        while (sep > 0 && pair.str[sep - 1] != ':')
+            sep--;
+        if (sep == 0)
+            continue;
+        char *tag = bc_strndup(pair.str, sep - 1);
+        bc_trie_insert(tag_pages, tag,
+            bc_strndup(pair.str + sep, pair.len - sep));
+        free(tag);
+    }
+    free(last_pages);
+
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     for (size_t k = 0; ctx->settings->tags[k] != NULL; k++) {
-        bc_trie_t *local = bc_trie_new(free);
-        bc_trie_insert(local, "FILTER_TAG", bc_strdup(ctx->settings->tags[k]));
-
-        char *last_page = bm_exec_blogc_get_variable(ctx, variables, local,
-            "LAST_PAGE", true, ctx->posts_fctx, false);
-
-        bc_trie_free(local);
-
+        const char *last_page = bc_trie_lookup(tag_pages, ctx->settings->tags[k]);
         if (last_page == NULL)
             continue;
 
         long pages = strtol(last_page, NULL, 10);
-        free(last_page);
 
         for (size_t i = 0; i < pages; i++) {
             char *j = bc_strdup_printf("%d", i + 1);
             char *f = bm_generate_filename2(ctx->short_output_dir, blog_prefix,
                 tag_prefix, ctx->settings->tags[k], pagination_prefix, j, html_ext);
-            rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+            rv = bc_slist_append_tail(rv, &tail,
+                bm_filectx_new(ctx, f, NULL, NULL));
             free(j);
             free(f);
         }
     }
 
+    bc_trie_free(tag_pages);
     bc_trie_free(variables);
 
     return rv;
@@ -475,6 +495,7 @@ posts_outputlist(bm_ctx_t *ctx)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     const char *blog_prefix = bm_ctx_settings_lookup(ctx, "blog_prefix");
     const char *post_prefix = bm_ctx_settings_lookup(ctx, "post_prefix");
@@ -483,7 +504,8 @@ posts_outputlist(bm_ctx_t *ctx)
     for (size_t i = 0; ctx->settings->posts[i] != NULL; i++) {
         char *f = bm_generate_filename(ctx->short_output_dir, blog_prefix,
             post_prefix, ctx->settings->posts[i], html_ext);
-        rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+        rv = bc_slist_append_tail(rv, &tail,
+            bm_filectx_new(ctx, f, NULL, NULL));
         free(f);
     }
 
@@ -546,6 +568,7 @@ tags_outputlist(bm_ctx_t *ctx)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     const char *blog_prefix = bm_ctx_settings_lookup(ctx, "blog_prefix");
     const char *tag_prefix = bm_ctx_settings_lookup(ctx, "tag_prefix");
@@ -554,7 +577,8 @@ tags_outputlist(bm_ctx_t *ctx)
     for (size_t i = 0; ctx->settings->tags[i] != NULL; i++) {
         char *f = bm_generate_filename(ctx->short_output_dir, blog_prefix,
             tag_prefix, ctx->settings->tags[i], html_ext);
-        rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+        rv = bc_slist_append_tail(rv, &tail,
+            bm_filectx_new(ctx, f, NULL, NULL));
         free(f);
     }
 
@@ -611,13 +635,15 @@ pages_outputlist(bm_ctx_t *ctx)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     const char *html_ext = bm_ctx_settings_lookup(ctx, "html_ext");
 
     for (size_t i = 0; ctx->settings->pages[i] != NULL; i++) {
         char *f = bm_generate_filename(ctx->short_output_dir, NULL,
             NULL, ctx->settings->pages[i], html_ext);
-        rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+        rv = bc_slist_append_tail(rv, &tail,
+            bm_filectx_new(ctx, f, NULL, NULL));
         free(f);
     }
 
@@ -675,13 +701,15 @@ copy_outputlist(bm_ctx_t *ctx)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
 
     // we iterate over ctx->copy_fctx list instead of ctx->settings->copy,
     // because bm_ctx_new() expands directories into its files, recursively.
     for (bc_slist_t *s = ctx->copy_fctx; s != NULL; s = s->next) {
         char *f = bc_strdup_printf("%s/%s", ctx->short_output_dir,
             ((bm_filectx_t*) s->data)->short_path);
-        rv = bc_slist_append(rv, bm_filectx_new(ctx, f, NULL, NULL));
+        rv = bc_slist_append_tail(rv, &tail,
+            bm_filectx_new(ctx, f, NULL, NULL));
         free(f);
     }
 
@@ -990,6 +1018,20 @@ bm_rule_execute(bm_ctx_t *ctx, const bm_rule_t *rule, bc_trie_t *args)
 }
 
 
+static bool
+source_changed(bm_filectx_t *source, bm_filectx_t *output)
+{
+    if (source == NULL || !source->readable) {
+        // this is unlikely to happen, but lets just say that we need
+        // a rebuild and let blogc bail out.
+        return true;
+    }
+    if (source->tv_sec == output->tv_sec)
+        return source->tv_nsec > output->tv_nsec;
+    return source->tv_sec > output->tv_sec;
+}
+
+
 bool
 bm_rule_need_rebuild(bc_slist_t *sources, bm_filectx_t *settings,
     bm_filectx_t *listing_entry, bm_filectx_t *template, bm_filectx_t *output,
@@ -998,45 +1040,21 @@ bm_rule_need_rebuild(bc_slist_t *sources, bm_filectx_t *settings,
     if (output == NULL || !output->readable)
         return true;
 
-    bool rv = false;
-
-    bc_slist_t *s = NULL;
-    if (settings != NULL)
-        s = bc_slist_append(s, settings);
-    if (template != NULL)
-        s = bc_slist_append(s, template);
-    if (listing_entry != NULL)
-        s = bc_slist_append(s, listing_entry);
+    if (settings != NULL && source_changed(settings, output))
+        return true;
+    if (template != NULL && source_changed(template, output))
+        return true;
+    if (listing_entry != NULL && source_changed(listing_entry, output))
+        return true;
 
     for (bc_slist_t *l = sources; l != NULL; l = l->next) {
-        s = bc_slist_append(s, l->data);
+        if (source_changed(l->data, output))
+            return true;
         if (only_first_source)
             break;
     }
 
-    for (bc_slist_t *l = s; l != NULL; l = l->next) {
-        bm_filectx_t *source = l->data;
-        if (source == NULL || !source->readable) {
-            // this is unlikely to happen, but lets just say that we need
-            // a rebuild and let blogc bail out.
-            rv = true;
-            break;
-        }
-        if (source->tv_sec == output->tv_sec) {
-            if (source->tv_nsec > output->tv_nsec) {
-                rv = true;
-                break;
-            }
-        }
-        else if (source->tv_sec > output->tv_sec) {
-            rv = true;
-            break;
-        }
-    }
-
-    bc_slist_free(s);
-
-    return rv;
+    return false;
 }
 
 
@@ -1047,6 +1065,7 @@ bm_rule_list_built_files(bm_ctx_t *ctx)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
     for (size_t i = 0; rules[i].name != NULL; i++) {
         if (rules[i].outputlist_func == NULL) {
             continue;
@@ -1054,7 +1073,7 @@ bm_rule_list_built_files(bm_ctx_t *ctx)
 
         bc_slist_t *o = rules[i].outputlist_func(ctx);
         for (bc_slist_t *l = o; l != NULL; l = l->next) {
-            rv = bc_slist_append(rv, l->data);
+            rv = bc_slist_append_tail(rv, &tail, l->data);
         }
         bc_slist_free(o);
     }
@@ -51,14 +51,14 @@ br_hextoi(const char c)
 
 
 char*
-br_urldecode(const char *str)
+br_urldecode_len(const char *str, size_t len)
 {
-    bc_string_t *rv = bc_string_new();
+    bc_string_t *rv = bc_string_new_sized(len);
 
-    for (size_t i = 0; i < strlen(str); i++) {
+    for (size_t i = 0; i < len; i++) {
         switch (str[i]) {
             case '%':
-                if (i + 2 < strlen(str)) {
+                if (i + 2 < len) {
                     int p1 = br_hextoi(str[i + 1]) * 16;
                     int p2 = br_hextoi(str[i + 2]);
                     if (p1 >= 0 && p2 >= 0) {
@@ -81,6 +81,13 @@ br_urldecode(const char *str)
 }
 
 
+char*
+br_urldecode(const char *str)
+{
+    return br_urldecode_len(str, strlen(str));
+}
+
+
 const char*
 br_get_extension(const char *filename)
 {
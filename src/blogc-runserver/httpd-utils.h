@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #define READLINE_BUFFER_SIZE 2048
 
 char* br_readline(int socket);
 int br_hextoi(const char c);
+char* br_urldecode_len(const char *str, size_t len);
 char* br_urldecode(const char *str);
 const char* br_get_extension(const char *filename);
@@ -69,22 +69,27 @@ handle_request(void *arg)
 
     unsigned short status_code = 200;
 
-    char **pieces = bc_str_split(conn_line, ' ', 3);
-    if (bc_strv_length(pieces) != 3) {
+    // request line is "METHOD TARGET VERSION", and VERSION is left alone.
+    bc_strview_t iter = bc_strview(conn_line);
+    bc_strview_t method;
+    bc_strview_t target;
+    if (!bc_strview_split_next(&iter, ' ', &method) ||
+        !bc_strview_split_next(&iter, ' ', &target) || iter.str == NULL)
+    {
         status_code = 400;
         error(client_socket, 400, "Bad Request");
         goto point1;
     }
 
-    if (strcmp(pieces[0], "GET") != 0) {
+    if (!bc_strview_equal_str(method, "GET")) {
         status_code = 405;
         error(client_socket, 405, "Method Not Allowed");
         goto point1;
     }
 
-    char **pieces2 = bc_str_split(pieces[1], '?', 2);
-    char *path = br_urldecode(pieces2[0]);
-    bc_strv_free(pieces2);
+    bc_strview_t target_path;
+    bc_strview_split_next(&target, '?', &target_path);
+    char *path = br_urldecode_len(target_path.str, target_path.len);
 
     if (path == NULL) {
         status_code = 400;
@@ -208,7 +213,6 @@ point1:
     fprintf(stderr, "[Thread-%zu] %s - - \"%s\" %d\n", thread_id + 1,
         ip, conn_line, status_code);
     free(conn_line);
-    bc_strv_free(pieces);
 point0:
     free(ip);
     close(client_socket);
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif /* HAVE_SYS_STAT_H */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "../common/error.h"
+#include "../common/file.h"
+#include "../common/utils.h"
+
+#ifndef PACKAGE_VERSION
+#define PACKAGE_VERSION "Unknown"
+#endif
+
+
+const char*
+blogc_cache_dir(void)
+{
+    const char *rv = getenv("BLOGC_CACHE_DIR");
+    if (rv == NULL || rv[0] == '\0')
+        return NULL;
+    return rv;
+}
+
+
+uint64_t
+blogc_cache_hash_init(const char *kind)
+{
+    // the blogc version is part of the hash, so upgrading blogc invalidates
+    // entries created by parsers that may behave differently.
+    uint64_t hash = blogc_cache_hash(14695981039346656037ULL, PACKAGE_VERSION,
+        strlen(PACKAGE_VERSION) + 1);
+    return blogc_cache_hash(hash, kind, strlen(kind) + 1);
+}
+
+
+uint64_t
+blogc_cache_hash(uint64_t hash, const void *data, size_t len)
+{
+    // FNV-1a
+    const unsigned char *str = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= str[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+char*
+blogc_cache_path(const char *dir, uint64_t hash)
+{
+    if (dir == NULL)
+        return NULL;
+    return bc_strdup_printf("%s/%016llx.cache", dir, (unsigned long long) hash);
+}
+
+
+bc_file_map_t*
+blogc_cache_map(const char *dir, uint64_t hash)
+{
+    char *path = blogc_cache_path(dir, hash);
+    if (path == NULL)
+        return NULL;
+    bc_error_t *err = NULL;
+    bc_file_map_t *rv = bc_file_map(path, false, &err);
+    bc_error_free(err);
+    free(path);
+    return rv;
+}
+
+
+bc_file_writer_t*
+blogc_cache_writer_new(const char *dir, char **tmp_path)
+{
+    if (dir == NULL || tmp_path == NULL)
+        return NULL;
+
+#ifdef HAVE_SYS_STAT_H
+#if defined(WIN32) || defined(_WIN32)
+    if (-1 == mkdir(dir) && errno != EEXIST)
+#else
+    if (-1 == mkdir(dir, 0777) && errno != EEXIST)
+#endif
+        return NULL;
+#endif /* HAVE_SYS_STAT_H */
+
+    *tmp_path = bc_strdup_printf("%s/.tmp-XXXXXX", dir);
+    int fd = mkstemp(*tmp_path);
+    if (fd < 0) {
+        free(*tmp_path);
+        *tmp_path = NULL;
+        return NULL;
+    }
+    return bc_file_writer_new(fd);
+}
+
+
+bool
+blogc_cache_writer_commit(const char *dir, uint64_t hash, bc_file_writer_t *w,
+    char *tmp_path)
+{
+    if (w == NULL || tmp_path == NULL)
+        return false;
+
+    bc_error_t *err = NULL;
+    bool rv = bc_file_writer_flush(w, tmp_path, &err);
+    bc_error_free(err);
+    close(w->fd);
+    bc_file_writer_free(w);
+
+    char *path = blogc_cache_path(dir, hash);
+    if (!rv || 0 != rename(tmp_path, path)) {
+        unlink(tmp_path);
+        rv = false;
+    }
+    free(path);
+    free(tmp_path);
+    return rv;
+}
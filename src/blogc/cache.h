@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../common/file.h"
+
+// helpers for the on-disk caches. entries are files named after a hash of
+// everything that changes their contents, and are written to a temporary file
+// that is renamed into place, so concurrent builds never see partial entries.
+// entries are always optional: any error is just a cache miss.
+
+const char* blogc_cache_dir(void);
+uint64_t blogc_cache_hash_init(const char *kind);
+uint64_t blogc_cache_hash(uint64_t hash, const void *data, size_t len);
+char* blogc_cache_path(const char *dir, uint64_t hash);
+bc_file_map_t* blogc_cache_map(const char *dir, uint64_t hash);
+bc_file_writer_t* blogc_cache_writer_new(const char *dir, char **tmp_path);
+bool blogc_cache_writer_commit(const char *dir, uint64_t hash,
+    bc_file_writer_t *w, char *tmp_path);
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -172,511 +173,636 @@ typedef enum {
 } blogc_content_parser_inline_state_t;
 
 
-static char*
-blogc_content_parse_inline_internal(const char *src, size_t src_len)
+// inline markers are only searched inside the span being parsed. failed
+// searches are remembered, because a marker that is missing from the rest of
+// the span will still be missing when searched again from a later position.
+typedef enum {
+    CONTENT_INLINE_MARKER_ASTERISK = 0,
+    CONTENT_INLINE_MARKER_ASTERISK_DOUBLE,
+    CONTENT_INLINE_MARKER_UNDERSCORE,
+    CONTENT_INLINE_MARKER_UNDERSCORE_DOUBLE,
+    CONTENT_INLINE_MARKER_BACKTICKS,
+    CONTENT_INLINE_MARKER_BACKTICKS_DOUBLE,
+    CONTENT_INLINE_MARKER_LINK_AUTO,
+    CONTENT_INLINE_MARKER_URL,
+    CONTENT_INLINE_MARKER_LAST,
+} blogc_content_parser_inline_marker_t;
+
+
+static size_t
+find_marker(const char *src, size_t start, size_t end, size_t limit, char c,
+    bool twice, size_t *miss)
+{
+    // similar to bc_str_find, but bounded to the span. returns end if not
+    // found.
+    if (start >= *miss)
+        return end;
+    for (size_t i = start; i < end; i++) {
+        if (src[i] == '\\') {
+            i++;
+            continue;
+        }
+        if (src[i] == c && (!twice || (i + 1 < limit && src[i + 1] == c)))
+            return i;
+    }
+    *miss = start;
+    return end;
+}
+
+
+static void
+append_escaped_len(bc_string_t *str, const char *suffix, size_t len)
+{
+    bool escaped = false;
+    for (size_t i = 0; i < len; i++) {
+        if (suffix[i] == '\\' && !escaped) {
+            escaped = true;
+            continue;
+        }
+        escaped = false;
+        bc_string_append_c(str, suffix[i]);
+    }
+}
+
+
+static void
+strip_escapes(bc_string_t *str, size_t from)
+{
+    // same as append_escaped_len, but in place.
+    bool escaped = false;
+    size_t j = from;
+    for (size_t i = from; i < str->len; i++) {
+        if (str->str[i] == '\\' && !escaped) {
+            escaped = true;
+            continue;
+        }
+        escaped = false;
+        str->str[j++] = str->str[i];
+    }
+    str->len = j;
+    str->str[j] = '\0';
+}
+
+
+// parses src[0:src_len] into rv. src[src_len:limit] is the rest of the
+// string that contains the span, that is looked at when parsing runs past
+// the end of the span.
+static void
+blogc_content_parse_inline_internal(bc_string_t *rv, const char *src,
+    size_t src_len, size_t limit)
 {
     size_t current = 0;
     size_t start = 0;
     size_t count = 0;
-
-    const char *tmp = NULL;
-    char *tmp2 = NULL;
-    char *tmp3 = NULL;
+    size_t end = 0;
 
     size_t start_link = 0;
-    char *link1 = NULL;
+    size_t end_link = 0;
 
-    bc_string_t *rv = bc_string_new();
+    size_t misses[CONTENT_INLINE_MARKER_LAST];
+    for (size_t i = 0; i < CONTENT_INLINE_MARKER_LAST; i++)
+        misses[i] = SIZE_MAX;
+
+    size_t *reparsed = NULL;
+    size_t reparsed_len = 0;
 
     blogc_content_parser_inline_state_t state = CONTENT_INLINE_START;
 
-    while (current < src_len) {
-        char c = src[current];
-        bool is_last = current == src_len - 1;
+    bool reparse;
+    do {
+        while (current < src_len) {
+            char c = src[current];
+            bool is_last = current == src_len - 1;
 
-        switch (state) {
-            case CONTENT_INLINE_START:
-                if (is_last) {
+            switch (state) {
+                case CONTENT_INLINE_START:
+                    if (is_last) {
+                        htmlentities_append(rv, c);
+                        break;
+                    }
+                    if (c == '\\') {
+                        htmlentities_append(rv, src[++current]);
+                        break;
+                    }
+                    if (c == '*') {
+                        state = CONTENT_INLINE_ASTERISK;
+                        break;
+                    }
+                    if (c == '_') {
+                        state = CONTENT_INLINE_UNDERSCORE;
+                        break;
+                    }
+                    if (c == '`') {
+                        state = CONTENT_INLINE_BACKTICKS;
+                        break;
+                    }
+                    if (c == '[') {
+                        state = CONTENT_INLINE_LINK_START;
+                        break;
+                    }
+                    if (c == '!') {
+                        state = CONTENT_INLINE_IMAGE_START;
+                        break;
+                    }
+                    if (c == '-') {
+                        state = CONTENT_INLINE_ENDASH;
+                        break;
+                    }
+                    if (c == ' ') {
+                        state = CONTENT_INLINE_LINE_BREAK_START;
+                        break;
+                    }
                     htmlentities_append(rv, c);
                     break;
-                }
-                if (c == '\\') {
-                    htmlentities_append(rv, src[++current]);
-                    break;
-                }
-                if (c == '*') {
-                    state = CONTENT_INLINE_ASTERISK;
-                    break;
-                }
-                if (c == '_') {
-                    state = CONTENT_INLINE_UNDERSCORE;
-                    break;
-                }
-                if (c == '`') {
-                    state = CONTENT_INLINE_BACKTICKS;
-                    break;
-                }
-                if (c == '[') {
-                    state = CONTENT_INLINE_LINK_START;
-                    break;
-                }
-                if (c == '!') {
-                    state = CONTENT_INLINE_IMAGE_START;
-                    break;
-                }
-                if (c == '-') {
-                    state = CONTENT_INLINE_ENDASH;
-                    break;
-                }
-                if (c == ' ') {
-                    state = CONTENT_INLINE_LINE_BREAK_START;
-                    break;
-                }
-                htmlentities_append(rv, c);
-                break;
 
-            case CONTENT_INLINE_ASTERISK:
-                if (c == '*') {
-                    state = CONTENT_INLINE_ASTERISK_DOUBLE;
+                case CONTENT_INLINE_ASTERISK:
+                    if (c == '*') {
+                        state = CONTENT_INLINE_ASTERISK_DOUBLE;
+                        break;
+                    }
+                    end = find_marker(src, current, src_len, limit, '*', false,
+                        misses + CONTENT_INLINE_MARKER_ASTERISK);
+                    if (end == src_len) {
+                        bc_string_append_c(rv, '*');
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<em>");
+                    blogc_content_parse_inline_internal(rv, src + current,
+                        end - current, limit - current);
+                    bc_string_append(rv, "</em>");
+                    current = end;
+                    state = CONTENT_INLINE_START;
                     break;
-                }
-                tmp = bc_str_find(src + current, '*');
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '*');
+
+                case CONTENT_INLINE_ASTERISK_DOUBLE:
+                    end = find_marker(src, current, src_len, limit, '*', true,
+                        misses + CONTENT_INLINE_MARKER_ASTERISK_DOUBLE);
+                    if (end == src_len) {
+                        bc_string_append(rv, "**");
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<strong>");
+                    blogc_content_parse_inline_internal(rv, src + current,
+                        end - current, limit - current);
+                    bc_string_append(rv, "</strong>");
+                    current = end + 1;
                     state = CONTENT_INLINE_START;
-                    continue;
-                }
-                tmp2 = blogc_content_parse_inline_internal(
-                    src + current, (tmp - src) - current);
-                bc_string_append_printf(rv, "<em>%s</em>", tmp2);
-                current = tmp - src;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
+                    break;
 
-            case CONTENT_INLINE_ASTERISK_DOUBLE:
-                tmp = src + current;
-                do {
-                    tmp = bc_str_find(tmp, '*');
-                    if (((tmp - src) < src_len) && *(tmp + 1) == '*') {
+                case CONTENT_INLINE_UNDERSCORE:
+                    if (c == '_') {
+                        state = CONTENT_INLINE_UNDERSCORE_DOUBLE;
                         break;
                     }
-                    tmp++;
-                } while (tmp != NULL && (tmp - src) < src_len);
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '*');
-                    bc_string_append_c(rv, '*');
+                    end = find_marker(src, current, src_len, limit, '_', false,
+                        misses + CONTENT_INLINE_MARKER_UNDERSCORE);
+                    if (end == src_len) {
+                        bc_string_append_c(rv, '_');
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<em>");
+                    blogc_content_parse_inline_internal(rv, src + current,
+                        end - current, limit - current);
+                    bc_string_append(rv, "</em>");
+                    current = end;
                     state = CONTENT_INLINE_START;
-                    continue;
-                }
-                tmp2 = blogc_content_parse_inline_internal(
-                    src + current, (tmp - src) - current);
-                bc_string_append_printf(rv, "<strong>%s</strong>", tmp2);
-                current = tmp - src + 1;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
-
-            case CONTENT_INLINE_UNDERSCORE:
-                if (c == '_') {
-                    state = CONTENT_INLINE_UNDERSCORE_DOUBLE;
                     break;
-                }
-                tmp = bc_str_find(src + current, '_');
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '_');
+
+                case CONTENT_INLINE_UNDERSCORE_DOUBLE:
+                    end = find_marker(src, current, src_len, limit, '_', true,
+                        misses + CONTENT_INLINE_MARKER_UNDERSCORE_DOUBLE);
+                    if (end == src_len) {
+                        bc_string_append(rv, "__");
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<strong>");
+                    blogc_content_parse_inline_internal(rv, src + current,
+                        end - current, limit - current);
+                    bc_string_append(rv, "</strong>");
+                    current = end + 1;
                     state = CONTENT_INLINE_START;
-                    continue;
-                }
-                tmp2 = blogc_content_parse_inline_internal(
-                    src + current, (tmp - src) - current);
-                bc_string_append_printf(rv, "<em>%s</em>", tmp2);
-                current = tmp - src;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
+                    break;
 
-            case CONTENT_INLINE_UNDERSCORE_DOUBLE:
-                tmp = src + current;
-                do {
-                    tmp = bc_str_find(tmp, '_');
-                    if (((tmp - src) < src_len) && *(tmp + 1) == '_') {
+                case CONTENT_INLINE_BACKTICKS:
+                    if (c == '`') {
+                        state = CONTENT_INLINE_BACKTICKS_DOUBLE;
                         break;
                     }
-                    tmp++;
-                } while (tmp != NULL && (tmp - src) < src_len);
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '_');
-                    bc_string_append_c(rv, '_');
+                    end = find_marker(src, current, src_len, limit, '`', false,
+                        misses + CONTENT_INLINE_MARKER_BACKTICKS);
+                    if (end == src_len) {
+                        bc_string_append_c(rv, '`');
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<code>");
+                    for (size_t i = current; i < end; i++)
+                        htmlentities_append(rv, src[i]);
+                    bc_string_append(rv, "</code>");
+                    current = end;
                     state = CONTENT_INLINE_START;
-                    continue;
-                }
-                tmp2 = blogc_content_parse_inline_internal(
-                    src + current, (tmp - src) - current);
-                bc_string_append_printf(rv, "<strong>%s</strong>", tmp2);
-                current = tmp - src + 1;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
-
-            case CONTENT_INLINE_BACKTICKS:
-                if (c == '`') {
-                    state = CONTENT_INLINE_BACKTICKS_DOUBLE;
                     break;
-                }
-                tmp = bc_str_find(src + current, '`');
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '`');
+
+                case CONTENT_INLINE_BACKTICKS_DOUBLE:
+                    end = find_marker(src, current, src_len, limit, '`', true,
+                        misses + CONTENT_INLINE_MARKER_BACKTICKS_DOUBLE);
+                    if (end == src_len) {
+                        bc_string_append(rv, "``");
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<code>");
+                    for (size_t i = current; i < end; i++)
+                        htmlentities_append(rv, src[i]);
+                    bc_string_append(rv, "</code>");
+                    current = end + 1;
                     state = CONTENT_INLINE_START;
-                    continue;
-                }
-                tmp3 = bc_strndup(src + current, (tmp - src) - current);
-                tmp2 = blogc_htmlentities(tmp3);
-                free(tmp3);
-                tmp3 = NULL;
-                bc_string_append(rv, "<code>");
-                bc_string_append(rv, tmp2);
-                bc_string_append(rv, "</code>");
-                current = tmp - src;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
+                    break;
 
-            case CONTENT_INLINE_BACKTICKS_DOUBLE:
-                tmp = src + current;
-                do {
-                    tmp = bc_str_find(tmp, '`');
-                    if (((tmp - src) < src_len) && *(tmp + 1) == '`') {
+                case CONTENT_INLINE_LINK_START:
+                    if (c == '[') {
+                        state = CONTENT_INLINE_LINK_AUTO;
                         break;
                     }
-                    tmp++;
-                } while (tmp != NULL && (tmp - src) < src_len);
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '`');
-                    bc_string_append_c(rv, '`');
+                    start_link = current;
+                    count = 1;
+                    state = CONTENT_INLINE_LINK_CONTENT;
+                    break;
+
+                case CONTENT_INLINE_LINK_AUTO:
+                    end = find_marker(src, current, src_len, limit, ']', true,
+                        misses + CONTENT_INLINE_MARKER_LINK_AUTO);
+                    if (end == src_len) {
+                        bc_string_append(rv, "[[");
+                        state = CONTENT_INLINE_START;
+                        continue;
+                    }
+                    bc_string_append(rv, "<a href=\"");
+                    append_escaped_len(rv, src + current, end - current);
+                    bc_string_append(rv, "\">");
+                    append_escaped_len(rv, src + current, end - current);
+                    bc_string_append(rv, "</a>");
+                    current = end + 1;
                     state = CONTENT_INLINE_START;
-                    continue;
-                }
-                tmp3 = bc_strndup(src + current, (tmp - src) - current);
-                tmp2 = blogc_htmlentities(tmp3);
-                free(tmp3);
-                tmp3 = NULL;
-                bc_string_append(rv, "<code>");
-                bc_string_append(rv, tmp2);
-                bc_string_append(rv, "</code>");
-                current = tmp - src + 1;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
+                    break;
 
-            case CONTENT_INLINE_LINK_START:
-                if (c == '[') {
-                    state = CONTENT_INLINE_LINK_AUTO;
+                case CONTENT_INLINE_LINK_CONTENT:
+                    if (c == '\\') {
+                        current++;
+                        break;
+                    }
+                    if (c == '[') {  // links can be nested :/
+                        count++;
+                        break;
+                    }
+                    if (c == ']') {
+                        if (--count == 0) {
+                            end_link = current;
+                            state = CONTENT_INLINE_LINK_URL_START;
+                        }
+                    }
                     break;
-                }
-                start_link = current;
-                count = 1;
-                state = CONTENT_INLINE_LINK_CONTENT;
-                break;
 
-            case CONTENT_INLINE_LINK_AUTO:
-                tmp = src + current;
-                do {
-                    tmp = bc_str_find(tmp, ']');
-                    if (((tmp - src) < src_len) && *(tmp + 1) == ']') {
+                case CONTENT_INLINE_LINK_URL_START:
+                    if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                        break;
+                    if (c == '(') {
+                        state = CONTENT_INLINE_LINK_URL;
+                        start = current + 1;
                         break;
                     }
-                    tmp++;
-                } while (tmp != NULL && (tmp - src) < src_len);
-                if (tmp == NULL || ((tmp - src) >= src_len)) {
-                    bc_string_append_c(rv, '[');
                     bc_string_append_c(rv, '[');
                     state = CONTENT_INLINE_START;
+                    current = start_link;
+                    start_link = 0;
                     continue;
-                }
-                tmp2 = bc_strndup(src + current, (tmp - src) - current);
-                bc_string_append(rv, "<a href=\"");
-                bc_string_append_escaped(rv, tmp2);
-                bc_string_append(rv, "\">");
-                bc_string_append_escaped(rv, tmp2);
-                bc_string_append(rv, "</a>");
-                current = tmp - src + 1;
-                tmp = NULL;
-                free(tmp2);
-                tmp2 = NULL;
-                state = CONTENT_INLINE_START;
-                break;
 
-            case CONTENT_INLINE_LINK_CONTENT:
-                if (c == '\\') {
-                    current++;
-                    break;
-                }
-                if (c == '[') {  // links can be nested :/
-                    count++;
-                    break;
-                }
-                if (c == ']') {
-                    if (--count == 0) {
-                        link1 = bc_strndup(src + start_link, current - start_link);
-                        state = CONTENT_INLINE_LINK_URL_START;
+                case CONTENT_INLINE_LINK_URL:
+                    end = find_marker(src, current, src_len, limit, ')', false,
+                        misses + CONTENT_INLINE_MARKER_URL);
+                    if (end == src_len) {
+                        current = src_len;
+                        continue;
                     }
-                }
-                break;
-
-            case CONTENT_INLINE_LINK_URL_START:
-                if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
-                    break;
-                if (c == '(') {
-                    state = CONTENT_INLINE_LINK_URL;
-                    start = current + 1;
-                    break;
-                }
-                bc_string_append_c(rv, '[');
-                state = CONTENT_INLINE_START;
-                current = start_link;
-                start_link = 0;
-                continue;
-
-            case CONTENT_INLINE_LINK_URL:
-                if (c == '\\') {
-                    current++;
-                    break;
-                }
-                if (c == ')') {
-                    tmp2 = bc_strndup(src + start, current - start);
-                    tmp3 = blogc_content_parse_inline(link1);
-                    free(link1);
-                    link1 = NULL;
                     bc_string_append(rv, "<a href=\"");
-                    bc_string_append_escaped(rv, tmp2);
-                    bc_string_append_printf(rv, "\">%s</a>", tmp3);
-                    free(tmp2);
-                    tmp2 = NULL;
-                    free(tmp3);
-                    tmp3 = NULL;
+                    append_escaped_len(rv, src + start, end - start);
+                    bc_string_append(rv, "\">");
+                    blogc_content_parse_inline_internal(rv, src + start_link,
+                        end_link - start_link, end_link - start_link);
+                    bc_string_append(rv, "</a>");
+                    current = end;
                     state = CONTENT_INLINE_START;
                     break;
-                }
-                break;
 
-            case CONTENT_INLINE_IMAGE_START:
-                // we use the same variables used for links, because why not?
-                if (c == '[') {
-                    state = CONTENT_INLINE_IMAGE_ALT;
-                    start_link = current + 1;
-                    break;
-                }
-                bc_string_append_c(rv, '!');
-                state = CONTENT_INLINE_START;
-                continue;
+                case CONTENT_INLINE_IMAGE_START:
+                    // we use the same variables used for links, because why not?
+                    if (c == '[') {
+                        state = CONTENT_INLINE_IMAGE_ALT;
+                        start_link = current + 1;
+                        break;
+                    }
+                    bc_string_append_c(rv, '!');
+                    state = CONTENT_INLINE_START;
+                    continue;
 
-            case CONTENT_INLINE_IMAGE_ALT:
-                if (c == '\\') {
-                    current++;
+                case CONTENT_INLINE_IMAGE_ALT:
+                    if (c == '\\') {
+                        current++;
+                        break;
+                    }
+                    if (c == ']') {
+                        end_link = current;
+                        state = CONTENT_INLINE_IMAGE_URL_START;
+                    }
                     break;
-                }
-                if (c == ']') {
-                    link1 = bc_strndup(src + start_link, current - start_link);
-                    state = CONTENT_INLINE_IMAGE_URL_START;
-                }
-                break;
 
-            case CONTENT_INLINE_IMAGE_URL_START:
-                if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
-                    break;
-                if (c == '(') {
-                    state = CONTENT_INLINE_IMAGE_URL;
-                    start = current + 1;
-                    break;
-                }
-                bc_string_append_c(rv, '!');
-                bc_string_append_c(rv, '[');
-                state = CONTENT_INLINE_START;
-                current = start_link;
-                start_link = 0;
-                continue;
+                case CONTENT_INLINE_IMAGE_URL_START:
+                    if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                        break;
+                    if (c == '(') {
+                        state = CONTENT_INLINE_IMAGE_URL;
+                        start = current + 1;
+                        break;
+                    }
+                    bc_string_append_c(rv, '!');
+                    bc_string_append_c(rv, '[');
+                    state = CONTENT_INLINE_START;
+                    current = start_link;
+                    start_link = 0;
+                    continue;
 
-            case CONTENT_INLINE_IMAGE_URL:
-                if (c == '\\') {
-                    current++;
-                    break;
-                }
-                if (c == ')') {
-                    tmp2 = bc_strndup(src + start, current - start);
+                case CONTENT_INLINE_IMAGE_URL:
+                    end = find_marker(src, current, src_len, limit, ')', false,
+                        misses + CONTENT_INLINE_MARKER_URL);
+                    if (end == src_len) {
+                        current = src_len;
+                        continue;
+                    }
                     bc_string_append(rv, "<img src=\"");
-                    bc_string_append_escaped(rv, tmp2);
+                    append_escaped_len(rv, src + start, end - start);
                     bc_string_append(rv, "\" alt=\"");
-                    bc_string_append_escaped(rv, link1);
+                    append_escaped_len(rv, src + start_link, end_link - start_link);
                     bc_string_append(rv, "\">");
-                    free(tmp2);
-                    tmp2 = NULL;
-                    free(link1);
-                    link1 = NULL;
+                    current = end;
                     state = CONTENT_INLINE_START;
                     break;
-                }
-                break;
 
-            case CONTENT_INLINE_ENDASH:
-                if (c == '-') {
-                    if (is_last) {
-                        bc_string_append(rv, "&ndash;");
-                        state = CONTENT_INLINE_START;  // wat
+                case CONTENT_INLINE_ENDASH:
+                    if (c == '-') {
+                        if (is_last) {
+                            bc_string_append(rv, "&ndash;");
+                            state = CONTENT_INLINE_START;  // wat
+                            break;
+                        }
+                        state = CONTENT_INLINE_EMDASH;
                         break;
                     }
-                    state = CONTENT_INLINE_EMDASH;
-                    break;
-                }
-                bc_string_append_c(rv, '-');
-                state = CONTENT_INLINE_START;
-                continue;
+                    bc_string_append_c(rv, '-');
+                    state = CONTENT_INLINE_START;
+                    continue;
 
-            case CONTENT_INLINE_EMDASH:
-                if (c == '-') {
-                    bc_string_append(rv, "&mdash;");
+                case CONTENT_INLINE_EMDASH:
+                    if (c == '-') {
+                        bc_string_append(rv, "&mdash;");
+                        state = CONTENT_INLINE_START;
+                        break;
+                    }
+                    bc_string_append(rv, "&ndash;");
                     state = CONTENT_INLINE_START;
-                    break;
-                }
-                bc_string_append(rv, "&ndash;");
-                state = CONTENT_INLINE_START;
-                continue;
+                    continue;
 
-            case CONTENT_INLINE_LINE_BREAK_START:
-                if (c == ' ') {
-                    if (is_last) {
-                        bc_string_append(rv, "<br />");
-                        state = CONTENT_INLINE_START;  // wat
+                case CONTENT_INLINE_LINE_BREAK_START:
+                    if (c == ' ') {
+                        if (is_last) {
+                            bc_string_append(rv, "<br />");
+                            state = CONTENT_INLINE_START;  // wat
+                            break;
+                        }
+                        count = 2;
+                        state = CONTENT_INLINE_LINE_BREAK;
                         break;
                     }
-                    count = 2;
-                    state = CONTENT_INLINE_LINE_BREAK;
-                    break;
-                }
-                bc_string_append_c(rv, ' ');
-                state = CONTENT_INLINE_START;
-                continue;
+                    bc_string_append_c(rv, ' ');
+                    state = CONTENT_INLINE_START;
+                    continue;
 
-            case CONTENT_INLINE_LINE_BREAK:
-                if (c == ' ') {
-                    if (is_last) {
+                case CONTENT_INLINE_LINE_BREAK:
+                    if (c == ' ') {
+                        if (is_last) {
+                            bc_string_append(rv, "<br />");
+                            state = CONTENT_INLINE_START;  // wat
+                            break;
+                        }
+                        count++;
+                        break;
+                    }
+                    if (c == '\n' || c == '\r') {
                         bc_string_append(rv, "<br />");
-                        state = CONTENT_INLINE_START;  // wat
+                        bc_string_append_c(rv, c);
+                        state = CONTENT_INLINE_START;
                         break;
                     }
-                    count++;
-                    break;
-                }
-                if (c == '\n' || c == '\r') {
-                    bc_string_append_printf(rv, "<br />%c", c);
+                    for (size_t i = 0; i < count; i++)
+                        bc_string_append_c(rv, ' ');
                     state = CONTENT_INLINE_START;
-                    break;
-                }
-                for (size_t i = 0; i < count; i++)
-                    bc_string_append_c(rv, ' ');
-                state = CONTENT_INLINE_START;
-                continue;
+                    continue;
+            }
+            current++;
         }
-        current++;
-    }
 
-    switch (state) {
-
-        // if after the end of the loop we are on any of the following states,
-        // we must call the parser again, from start_link
-        case CONTENT_INLINE_IMAGE_START:
-        case CONTENT_INLINE_IMAGE_ALT:
-        case CONTENT_INLINE_IMAGE_URL_START:
-        case CONTENT_INLINE_IMAGE_URL:
-            bc_string_append_c(rv, '!');
-
-        case CONTENT_INLINE_LINK_CONTENT:
-        case CONTENT_INLINE_LINK_URL_START:
-        case CONTENT_INLINE_LINK_URL:
-            tmp2 = blogc_content_parse_inline(src + start_link);
-            bc_string_append_c(rv, '[');
-            bc_string_append_escaped(rv, tmp2);  // no need to free, as it wil be done below.
-            break;
+        reparse = false;
 
-        // add all the other states here explicitly, so the compiler helps us
-        // not missing any new state that should be handled.
-        case CONTENT_INLINE_START:
-        case CONTENT_INLINE_ASTERISK:
-        case CONTENT_INLINE_ASTERISK_DOUBLE:
-        case CONTENT_INLINE_UNDERSCORE:
-        case CONTENT_INLINE_UNDERSCORE_DOUBLE:
-        case CONTENT_INLINE_BACKTICKS:
-        case CONTENT_INLINE_BACKTICKS_DOUBLE:
-        case CONTENT_INLINE_LINK_START:
-        case CONTENT_INLINE_LINK_AUTO:
-        case CONTENT_INLINE_ENDASH:
-        case CONTENT_INLINE_EMDASH:
-        case CONTENT_INLINE_LINE_BREAK_START:
-        case CONTENT_INLINE_LINE_BREAK:
-            break;
-    }
+        switch (state) {
 
-    free(tmp2);
-    free(tmp3);
-    free(link1);
+            // if after the end of the loop we are on any of the following
+            // states, we must parse the rest of the string again, from
+            // start_link, with escapes stripped from the output.
+            case CONTENT_INLINE_IMAGE_START:
+            case CONTENT_INLINE_IMAGE_ALT:
+            case CONTENT_INLINE_IMAGE_URL_START:
+            case CONTENT_INLINE_IMAGE_URL:
+                bc_string_append_c(rv, '!');
 
-    return bc_string_free(rv, false);
+            case CONTENT_INLINE_LINK_CONTENT:
+            case CONTENT_INLINE_LINK_URL_START:
+            case CONTENT_INLINE_LINK_URL:
+                bc_string_append_c(rv, '[');
+                reparsed = bc_realloc(reparsed,
+                    (reparsed_len + 1) * sizeof(size_t));
+                reparsed[reparsed_len++] = rv->len;
+                if (src_len != limit) {
+                    src_len = limit;
+                    for (size_t i = 0; i < CONTENT_INLINE_MARKER_LAST; i++)
+                        misses[i] = SIZE_MAX;
+                }
+                current = start_link;
+                state = CONTENT_INLINE_START;
+                reparse = true;
+                break;
+
+            // add all the other states here explicitly, so the compiler helps us
+            // not missing any new state that should be handled.
+            case CONTENT_INLINE_START:
+            case CONTENT_INLINE_ASTERISK:
+            case CONTENT_INLINE_ASTERISK_DOUBLE:
+            case CONTENT_INLINE_UNDERSCORE:
+            case CONTENT_INLINE_UNDERSCORE_DOUBLE:
+            case CONTENT_INLINE_BACKTICKS:
+            case CONTENT_INLINE_BACKTICKS_DOUBLE:
+            case CONTENT_INLINE_LINK_START:
+            case CONTENT_INLINE_LINK_AUTO:
+            case CONTENT_INLINE_ENDASH:
+            case CONTENT_INLINE_EMDASH:
+            case CONTENT_INLINE_LINE_BREAK_START:
+            case CONTENT_INLINE_LINE_BREAK:
+                break;
+        }
+    } while (reparse);
+
+    // innermost reparsed output is stripped first. most of the times there's
+    // nothing to strip at all.
+    if (reparsed_len > 0 && NULL != memchr(rv->str + reparsed[0], '\\',
+            rv->len - reparsed[0]))
+    {
+        for (size_t i = reparsed_len; i > 0; i--)
+            strip_escapes(rv, reparsed[i - 1]);
+    }
+    free(reparsed);
 }
 
 
 char*
 blogc_content_parse_inline(const char *src)
 {
-    return blogc_content_parse_inline_internal(src, strlen(src));
+    bc_string_t *rv = bc_string_new();
+    size_t src_len = strlen(src);
+    blogc_content_parse_inline_internal(rv, src, src_len, src_len);
+    return bc_string_free(rv, false);
 }
 
 
-bool
-blogc_is_ordered_list_item(const char *str, size_t prefix_len)
+static bool
+is_ordered_list_item(const char *str, size_t len, size_t prefix_len)
 {
-    if (str == NULL)
-        return false;
-
-    if (strlen(str) < 2)
+    if (len < 2)
         return false;
 
     size_t i;
 
-    for (i = 0; str[i] >= '0' && str[i] <= '9'; i++);
+    for (i = 0; i < len && str[i] >= '0' && str[i] <= '9'; i++);
 
     if (i == 0)
         return false;
-    if (str[i] != '.')
+    if (i == len || str[i] != '.')
         return false;
 
-    for (i++; i < prefix_len && (str[i] == ' ' || str[i] == '\t'); i++);
+    for (i++; i < prefix_len && i < len && (str[i] == ' ' || str[i] == '\t'); i++);
 
-    if (str[i] == '\0')
+    if (i == len)
         return false;
 
     return i == prefix_len;
 }
 
 
-char*
-blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
-    char **description, char **endl, bc_slist_t **headers)
+bool
+blogc_is_ordered_list_item(const char *str, size_t prefix_len)
 {
-    // src is always nul-terminated.
-    size_t src_len = strlen(src);
+    if (str == NULL)
+        return false;
+    return is_ordered_list_item(str, strlen(str), prefix_len);
+}
+
+
+// block lines are kept as spans of the source, instead of copies.
+typedef struct {
+    bc_strview_t *spans;
+    size_t len;
+    size_t allocated_len;
+} blogc_content_lines_t;
+
+
+static void
+lines_append(blogc_content_lines_t *lines, const char *str, size_t len)
+{
+    if (lines->len == lines->allocated_len) {
+        lines->allocated_len = lines->allocated_len == 0 ? 16 :
+            2 * lines->allocated_len;
+        lines->spans = bc_realloc(lines->spans,
+            lines->allocated_len * sizeof(bc_strview_t));
+    }
+    lines->spans[lines->len++] = bc_strview_len(str, len);
+}
+
+
+static void
+lines_join(bc_string_t *str, blogc_content_lines_t *lines,
+    const char *line_ending, bool trailing)
+{
+    str->len = 0;
+    str->str[0] = '\0';
+    for (size_t i = 0; i < lines->len; i++) {
+        bc_string_append_len(str, lines->spans[i].str, lines->spans[i].len);
+        if (trailing || i + 1 < lines->len)
+            bc_string_append(str, line_ending);
+    }
+}
+
+
+static void
+lines_append_list_item(bc_string_t *items, bc_string_t *tmp,
+    blogc_content_lines_t *lines, const char *line_ending)
+{
+    // list items can span many lines, that are parsed together.
+    lines_join(tmp, lines, line_ending, false);
+    lines->len = 0;
+    bc_string_append(items, "<li>");
+    blogc_content_parse_inline_internal(items, tmp->str, tmp->len, tmp->len);
+    bc_string_append(items, "</li>");
+    bc_string_append(items, line_ending);
+}
+
+
+static bc_strview_t
+line_span(const char *src, size_t src_len, size_t start, size_t end)
+{
+    // end may be stale here. in that case the span goes until the end of the
+    // source, as with bc_strndup.
+    size_t len = end - start;
+    if (end < start || len > src_len - start)
+        len = src_len - start;
+    return bc_strview_len(src + start, len);
+}
 
+
+static bool
+span_starts_with(bc_strview_t span, const char *prefix, size_t prefix_len)
+{
+    return span.len >= prefix_len && 0 == memcmp(span.str, prefix, prefix_len);
+}
+
+
+static bool
+span_starts_with_spaces(bc_strview_t span, size_t len)
+{
+    if (span.len < len)
+        return false;
+    for (size_t i = 0; i < len; i++)
+        if (span.str[i] != ' ')
+            return false;
+    return true;
+}
+
+
+static void
+blogc_content_parse_internal(bc_string_t *rv, const char *src, size_t src_len,
+    size_t *end_excerpt, char **first_header, char **description, char **endl,
+    bc_slist_t **headers)
+{
     size_t current = 0;
     size_t start = 0;
     size_t start2 = 0;
@@ -685,12 +811,12 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
     size_t real_end = 0;
 
     size_t header_level = 0;
-    char *prefix = NULL;
+    const char *prefix = NULL;
     size_t prefix_len = 0;
     char *tmp = NULL;
-    char *tmp2 = NULL;
     char *parsed = NULL;
     char *slug = NULL;
+    bc_strview_t span;
 
     char *line_ending = NULL;
     bool line_ending_found = false;
@@ -717,11 +843,12 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
 
     char d = '\0';
 
-    bc_slist_t *lines = NULL;
-    bc_slist_t *lines2 = NULL;
-
-    bc_string_t *rv = bc_string_new();
-    bc_string_t *tmp_str = NULL;
+    // lines holds the lines of code blocks and blockquotes, and lines2 the
+    // lines of the current list item. list items are rendered to items.
+    blogc_content_lines_t lines = {NULL, 0, 0};
+    blogc_content_lines_t lines2 = {NULL, 0, 0};
+    bc_string_t *items = bc_string_new();
+    bc_string_t *tmp_str = bc_string_new();
 
     blogc_content_parser_state_t state = CONTENT_START_LINE;
 
@@ -848,7 +975,8 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                 if (c == '\n' || c == '\r' || is_last) {
                     end = is_last && c != '\n' && c != '\r' ? src_len :
                         (real_end != 0 ? real_end : current);
-                    tmp = bc_strndup(src + start, end - start);
+                    span = line_span(src, src_len, start, end);
+                    tmp = bc_strndup(span.str, span.len);
                     if (first_header != NULL && *first_header == NULL)
                         *first_header = blogc_htmlentities(tmp);
                     parsed = blogc_content_parse_inline(tmp);
@@ -883,10 +1011,9 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
 
             case CONTENT_HTML_END:
                 if (c == '\n' || c == '\r' || is_last) {
-                    tmp = bc_strndup(src + start, end - start);
-                    bc_string_append_printf(rv, "%s%s", tmp, line_ending);
-                    free(tmp);
-                    tmp = NULL;
+                    span = line_span(src, src_len, start, end);
+                    bc_string_append_len(rv, span.str, span.len);
+                    bc_string_append(rv, line_ending);
                     state = CONTENT_START_LINE;
                     start = current;
                 }
@@ -897,7 +1024,8 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
             case CONTENT_BLOCKQUOTE:
                 if (c == ' ' || c == '\t')
                     break;
-                prefix = bc_strndup(src + start, current - start);
+                prefix = src + start;
+                prefix_len = current - start;
                 state = CONTENT_BLOCKQUOTE_START;
                 break;
 
@@ -905,49 +1033,34 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                 if (c == '\n' || c == '\r' || is_last) {
                     end = is_last && c != '\n' && c != '\r' ? src_len :
                         (real_end != 0 ? real_end : current);
-                    tmp = bc_strndup(src + start2, end - start2);
-                    if (bc_str_starts_with(tmp, prefix)) {
-                        lines = bc_slist_append(lines, bc_strdup(tmp + strlen(prefix)));
+                    span = line_span(src, src_len, start2, end);
+                    if (span_starts_with(span, prefix, prefix_len)) {
+                        lines_append(&lines, span.str + prefix_len,
+                            span.len - prefix_len);
                         state = CONTENT_BLOCKQUOTE_END;
                     }
                     else {
                         state = CONTENT_PARAGRAPH;
-                        free(prefix);
-                        prefix = NULL;
-                        bc_slist_free_full(lines, free);
-                        lines = NULL;
-                        if (is_last) {
-                            free(tmp);
-                            tmp = NULL;
+                        lines.len = 0;
+                        if (is_last)
                             continue;
-                        }
                     }
-                    free(tmp);
-                    tmp = NULL;
                 }
                 if (!is_last)
                     break;
 
             case CONTENT_BLOCKQUOTE_END:
                 if (c == '\n' || c == '\r' || is_last) {
-                    tmp_str = bc_string_new();
-                    for (bc_slist_t *l = lines; l != NULL; l = l->next)
-                        bc_string_append_printf(tmp_str, "%s%s", l->data,
-                            line_ending);
+                    lines_join(tmp_str, &lines, line_ending, true);
+                    lines.len = 0;
                     // do not propagate title and description to blockquote parsing,
                     // because we just want paragraphs from first level of
                     // content.
-                    tmp = blogc_content_parse(tmp_str->str, NULL, NULL, NULL, endl, NULL);
-                    bc_string_append_printf(rv, "<blockquote>%s</blockquote>%s",
-                        tmp, line_ending);
-                    free(tmp);
-                    tmp = NULL;
-                    bc_string_free(tmp_str, true);
-                    tmp_str = NULL;
-                    bc_slist_free_full(lines, free);
-                    lines = NULL;
-                    free(prefix);
-                    prefix = NULL;
+                    bc_string_append(rv, "<blockquote>");
+                    blogc_content_parse_internal(rv, tmp_str->str, tmp_str->len,
+                        NULL, NULL, NULL, endl, NULL);
+                    bc_string_append(rv, "</blockquote>");
+                    bc_string_append(rv, line_ending);
                     state = CONTENT_START_LINE;
                     start2 = current;
                 }
@@ -960,7 +1073,8 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
             case CONTENT_CODE:
                 if (c == ' ' || c == '\t')
                     break;
-                prefix = bc_strndup(src + start, current - start);
+                prefix = src + start;
+                prefix_len = current - start;
                 state = CONTENT_CODE_START;
                 break;
 
@@ -968,25 +1082,19 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                 if (c == '\n' || c == '\r' || is_last) {
                     end = is_last && c != '\n' && c != '\r' ? src_len :
                         (real_end != 0 ? real_end : current);
-                    tmp = bc_strndup(src + start2, end - start2);
-                    if (bc_str_starts_with(tmp, prefix)) {
-                        lines = bc_slist_append(lines, bc_strdup(tmp + strlen(prefix)));
+                    span = line_span(src, src_len, start2, end);
+                    if (span_starts_with(span, prefix, prefix_len)) {
+                        lines_append(&lines, span.str + prefix_len,
+                            span.len - prefix_len);
                         state = CONTENT_CODE_END;
                     }
                     else {
                         state = CONTENT_PARAGRAPH;
-                        free(prefix);
-                        prefix = NULL;
-                        bc_slist_free_full(lines, free);
-                        lines = NULL;
-                        free(tmp);
-                        tmp = NULL;
+                        lines.len = 0;
                         if (is_last)
                             continue;
                         break;
                     }
-                    free(tmp);
-                    tmp = NULL;
                 }
                 if (!is_last)
                     break;
@@ -994,20 +1102,15 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
             case CONTENT_CODE_END:
                 if (c == '\n' || c == '\r' || is_last) {
                     bc_string_append(rv, "<pre><code>");
-                    for (bc_slist_t *l = lines; l != NULL; l = l->next) {
-                        char *tmp_line = blogc_htmlentities(l->data);
-                        if (l->next == NULL)
-                            bc_string_append_printf(rv, "%s", tmp_line);
-                        else
-                            bc_string_append_printf(rv, "%s%s", tmp_line,
-                                line_ending);
-                        free(tmp_line);
+                    for (size_t i = 0; i < lines.len; i++) {
+                        for (size_t j = 0; j < lines.spans[i].len; j++)
+                            htmlentities_append(rv, lines.spans[i].str[j]);
+                        if (i + 1 < lines.len)
+                            bc_string_append(rv, line_ending);
                     }
-                    bc_string_append_printf(rv, "</code></pre>%s", line_ending);
-                    bc_slist_free_full(lines, free);
-                    lines = NULL;
-                    free(prefix);
-                    prefix = NULL;
+                    bc_string_append(rv, "</code></pre>");
+                    bc_string_append(rv, line_ending);
+                    lines.len = 0;
                     state = CONTENT_START_LINE;
                     start2 = current;
                 }
@@ -1030,7 +1133,8 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                 }
                 if (c == ' ' || c == '\t')
                     break;
-                prefix = bc_strndup(src + start, current - start);
+                prefix = src + start;
+                prefix_len = current - start;
                 state = CONTENT_UNORDERED_LIST_START;
                 break;
 
@@ -1051,7 +1155,8 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                     break;
                 }
                 if (c == '\n' || c == '\r' || is_last) {
-                    bc_string_append_printf(rv, "<hr />%s", line_ending);
+                    bc_string_append(rv, "<hr />");
+                    bc_string_append(rv, line_ending);
                     state = CONTENT_START_LINE;
                     start = current;
                     d = '\0';
@@ -1064,50 +1169,26 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                 if (c == '\n' || c == '\r' || is_last) {
                     end = is_last && c != '\n' && c != '\r' ? src_len :
                         (real_end != 0 ? real_end : current);
-                    tmp = bc_strndup(src + start2, end - start2);
-                    tmp2 = bc_strdup_printf("%-*s", strlen(prefix), "");
-                    if (bc_str_starts_with(tmp, prefix)) {
-                        if (lines2 != NULL) {
-                            tmp_str = bc_string_new();
-                            for (bc_slist_t *l = lines2; l != NULL; l = l->next) {
-                                if (l->next == NULL)
-                                    bc_string_append_printf(tmp_str, "%s", l->data);
-                                else
-                                    bc_string_append_printf(tmp_str, "%s%s", l->data,
-                                        line_ending);
-                            }
-                            bc_slist_free_full(lines2, free);
-                            lines2 = NULL;
-                            parsed = blogc_content_parse_inline(tmp_str->str);
-                            bc_string_free(tmp_str, true);
-                            lines = bc_slist_append(lines, bc_strdup(parsed));
-                            free(parsed);
-                            parsed = NULL;
-                        }
-                        lines2 = bc_slist_append(lines2, bc_strdup(tmp + strlen(prefix)));
+                    span = line_span(src, src_len, start2, end);
+                    if (span_starts_with(span, prefix, prefix_len)) {
+                        if (lines2.len > 0)
+                            lines_append_list_item(items, tmp_str, &lines2,
+                                line_ending);
+                        lines_append(&lines2, span.str + prefix_len,
+                            span.len - prefix_len);
                     }
-                    else if (bc_str_starts_with(tmp, tmp2)) {
-                        lines2 = bc_slist_append(lines2, bc_strdup(tmp + strlen(prefix)));
+                    else if (span_starts_with_spaces(span, prefix_len)) {
+                        lines_append(&lines2, span.str + prefix_len,
+                            span.len - prefix_len);
                     }
                     else {
                         state = CONTENT_PARAGRAPH_END;
-                        free(tmp);
-                        tmp = NULL;
-                        free(tmp2);
-                        tmp2 = NULL;
-                        free(prefix);
-                        prefix = NULL;
-                        bc_slist_free_full(lines, free);
-                        bc_slist_free_full(lines2, free);
-                        lines = NULL;
+                        items->len = 0;
+                        lines2.len = 0;
                         if (is_last)
                             continue;
                         break;
                     }
-                    free(tmp);
-                    tmp = NULL;
-                    free(tmp2);
-                    tmp2 = NULL;
                     state = CONTENT_UNORDERED_LIST_END;
                 }
                 if (!is_last)
@@ -1115,33 +1196,15 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
 
             case CONTENT_UNORDERED_LIST_END:
                 if (c == '\n' || c == '\r' || is_last) {
-                    if (lines2 != NULL) {
-                        // FIXME: avoid repeting the code below
-                        tmp_str = bc_string_new();
-                        for (bc_slist_t *l = lines2; l != NULL; l = l->next) {
-                            if (l->next == NULL)
-                                bc_string_append_printf(tmp_str, "%s", l->data);
-                            else
-                                bc_string_append_printf(tmp_str, "%s%s", l->data,
-                                    line_ending);
-                        }
-                        bc_slist_free_full(lines2, free);
-                        lines2 = NULL;
-                        parsed = blogc_content_parse_inline(tmp_str->str);
-                        bc_string_free(tmp_str, true);
-                        lines = bc_slist_append(lines, bc_strdup(parsed));
-                        free(parsed);
-                        parsed = NULL;
-                    }
-                    bc_string_append_printf(rv, "<ul>%s", line_ending);
-                    for (bc_slist_t *l = lines; l != NULL; l = l->next)
-                        bc_string_append_printf(rv, "<li>%s</li>%s", l->data,
+                    if (lines2.len > 0)
+                        lines_append_list_item(items, tmp_str, &lines2,
                             line_ending);
-                    bc_string_append_printf(rv, "</ul>%s", line_ending);
-                    bc_slist_free_full(lines, free);
-                    lines = NULL;
-                    free(prefix);
-                    prefix = NULL;
+                    bc_string_append(rv, "<ul>");
+                    bc_string_append(rv, line_ending);
+                    bc_string_append_len(rv, items->str, items->len);
+                    bc_string_append(rv, "</ul>");
+                    bc_string_append(rv, line_ending);
+                    items->len = 0;
                     state = CONTENT_START_LINE;
                     start2 = current;
                 }
@@ -1175,50 +1238,26 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
                 if (c == '\n' || c == '\r' || is_last) {
                     end = is_last && c != '\n' && c != '\r' ? src_len :
                         (real_end != 0 ? real_end : current);
-                    tmp = bc_strndup(src + start2, end - start2);
-                    tmp2 = bc_strdup_printf("%-*s", prefix_len, "");
-                    if (blogc_is_ordered_list_item(tmp, prefix_len)) {
-                        if (lines2 != NULL) {
-                            tmp_str = bc_string_new();
-                            for (bc_slist_t *l = lines2; l != NULL; l = l->next) {
-                                if (l->next == NULL)
-                                    bc_string_append_printf(tmp_str, "%s", l->data);
-                                else
-                                    bc_string_append_printf(tmp_str, "%s%s", l->data,
-                                        line_ending);
-                            }
-                            bc_slist_free_full(lines2, free);
-                            lines2 = NULL;
-                            parsed = blogc_content_parse_inline(tmp_str->str);
-                            bc_string_free(tmp_str, true);
-                            lines = bc_slist_append(lines, bc_strdup(parsed));
-                            free(parsed);
-                            parsed = NULL;
-                        }
-                        lines2 = bc_slist_append(lines2, bc_strdup(tmp + prefix_len));
+                    span = line_span(src, src_len, start2, end);
+                    if (is_ordered_list_item(span.str, span.len, prefix_len)) {
+                        if (lines2.len > 0)
+                            lines_append_list_item(items, tmp_str, &lines2,
+                                line_ending);
+                        lines_append(&lines2, span.str + prefix_len,
+                            span.len - prefix_len);
                     }
-                    else if (bc_str_starts_with(tmp, tmp2)) {
-                        lines2 = bc_slist_append(lines2, bc_strdup(tmp + prefix_len));
+                    else if (span_starts_with_spaces(span, prefix_len)) {
+                        lines_append(&lines2, span.str + prefix_len,
+                            span.len - prefix_len);
                     }
                     else {
                         state = CONTENT_PARAGRAPH_END;
-                        free(tmp);
-                        tmp = NULL;
-                        free(tmp2);
-                        tmp2 = NULL;
-                        free(parsed);
-                        parsed = NULL;
-                        bc_slist_free_full(lines, free);
-                        bc_slist_free_full(lines2, free);
-                        lines = NULL;
+                        items->len = 0;
+                        lines2.len = 0;
                         if (is_last)
                             continue;
                         break;
                     }
-                    free(tmp);
-                    tmp = NULL;
-                    free(tmp2);
-                    tmp2 = NULL;
                     state = CONTENT_ORDERED_LIST_END;
                 }
                 if (!is_last)
@@ -1226,33 +1265,15 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
 
             case CONTENT_ORDERED_LIST_END:
                 if (c == '\n' || c == '\r' || is_last) {
-                    if (lines2 != NULL) {
-                        // FIXME: avoid repeting the code below
-                        tmp_str = bc_string_new();
-                        for (bc_slist_t *l = lines2; l != NULL; l = l->next) {
-                            if (l->next == NULL)
-                                bc_string_append_printf(tmp_str, "%s", l->data);
-                            else
-                                bc_string_append_printf(tmp_str, "%s%s", l->data,
-                                    line_ending);
-                        }
-                        bc_slist_free_full(lines2, free);
-                        lines2 = NULL;
-                        parsed = blogc_content_parse_inline(tmp_str->str);
-                        bc_string_free(tmp_str, true);
-                        lines = bc_slist_append(lines, bc_strdup(parsed));
-                        free(parsed);
-                        parsed = NULL;
-                    }
-                    bc_string_append_printf(rv, "<ol>%s", line_ending);
-                    for (bc_slist_t *l = lines; l != NULL; l = l->next)
-                        bc_string_append_printf(rv, "<li>%s</li>%s", l->data,
+                    if (lines2.len > 0)
+                        lines_append_list_item(items, tmp_str, &lines2,
                             line_ending);
-                    bc_string_append_printf(rv, "</ol>%s", line_ending);
-                    bc_slist_free_full(lines, free);
-                    lines = NULL;
-                    free(prefix);
-                    prefix = NULL;
+                    bc_string_append(rv, "<ol>");
+                    bc_string_append(rv, line_ending);
+                    bc_string_append_len(rv, items->str, items->len);
+                    bc_string_append(rv, "</ol>");
+                    bc_string_append(rv, line_ending);
+                    items->len = 0;
                     state = CONTENT_START_LINE;
                     start2 = current;
                 }
@@ -1273,16 +1294,19 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
 
             case CONTENT_PARAGRAPH_END:
                 if (c == '\n' || c == '\r' || is_last) {
-                    tmp = bc_strndup(src + start, end - start);
-                    if (description != NULL && *description == NULL)
+                    span = line_span(src, src_len, start, end);
+                    if (description != NULL && *description == NULL) {
+                        tmp = bc_strndup(span.str, span.len);
                         *description = blogc_fix_description(tmp);
-                    parsed = blogc_content_parse_inline(tmp);
-                    bc_string_append_printf(rv, "<p>%s</p>%s", parsed,
-                        line_ending);
-                    free(parsed);
-                    parsed = NULL;
-                    free(tmp);
-                    tmp = NULL;
+                        free(tmp);
+                        tmp = NULL;
+                    }
+                    // paragraphs are parsed straight into the output buffer.
+                    bc_string_append(rv, "<p>");
+                    blogc_content_parse_inline_internal(rv, span.str, span.len,
+                        span.len);
+                    bc_string_append(rv, "</p>");
+                    bc_string_append(rv, line_ending);
                     state = CONTENT_START_LINE;
                     start = current;
                 }
@@ -1295,9 +1319,35 @@ blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
         current++;
     }
 
+    free(lines.spans);
+    free(lines2.spans);
+    bc_string_free(items, true);
+    bc_string_free(tmp_str, true);
+
     if (endl == NULL) {
         free(line_ending);
     }
+}
+
 
+char*
+blogc_content_parse_len(const char *src, size_t src_len, size_t *end_excerpt,
+    char **first_header, char **description, char **endl,
+    bc_slist_t **headers)
+{
+    // the generated html is usually a bit larger than the source, so start
+    // with the source length to avoid most of the reallocations.
+    bc_string_t *rv = bc_string_new_sized(src_len);
+    blogc_content_parse_internal(rv, src, src_len, end_excerpt, first_header,
+        description, endl, headers);
     return bc_string_free(rv, false);
 }
+
+
+char*
+blogc_content_parse(const char *src, size_t *end_excerpt, char **first_header,
+    char **description, char **endl, bc_slist_t **headers)
+{
+    return blogc_content_parse_len(src, strlen(src), end_excerpt, first_header,
+        description, endl, headers);
+}
@@ -15,3 +15,7 @@ bool blogc_is_ordered_list_item(const char *str, size_t prefix_len);
 char* blogc_content_parse(const char *src, size_t *end_excerpt,
     char **first_header, char **description, char **endl,
     bc_slist_t **headers);
+// same as blogc_content_parse, but src doesn't need to be nul-terminated.
+char* blogc_content_parse_len(const char *src, size_t src_len,
+    size_t *end_excerpt, char **first_header, char **description, char **endl,
+    bc_slist_t **headers);
@@ -9,6 +9,8 @@
 #include <time.h>
 #endif /* HAVE_TIME_H */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "datetime-parser.h"
@@ -40,25 +42,13 @@ typedef enum {
 } blogc_datetime_state_t;
 
 
-char*
-blogc_convert_datetime(const char *orig, const char *format,
-    bc_error_t **err)
-{
-    if (err == NULL || *err != NULL)
-        return NULL;
-
-#ifndef HAVE_TIME_H
-
-    *err = bc_error_new(BLOGC_WARNING_DATETIME_PARSER,
-        "Your operating system does not supports the datetime functionalities "
-        "used by blogc. Sorry.");
-    return NULL;
-
-#else
+#ifdef HAVE_TIME_H
 
-    struct tm t;
-    memset(&t, 0, sizeof(struct tm));
-    t.tm_isdst = -1;
+static bool
+parse_datetime(const char *orig, struct tm *t, bc_error_t **err)
+{
+    memset(t, 0, sizeof(struct tm));
+    t->tm_isdst = -1;
 
     blogc_datetime_state_t state = DATETIME_FIRST_YEAR;
     int tmp = 0;
@@ -111,7 +101,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                             tmp + 1900);
                         break;
                     }
-                    t.tm_year = tmp;
+                    t->tm_year = tmp;
                     state = DATETIME_FIRST_HYPHEN;
                     break;
                 }
@@ -151,7 +141,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                             tmp + 1);
                         break;
                     }
-                    t.tm_mon = tmp;
+                    t->tm_mon = tmp;
                     state = DATETIME_SECOND_HYPHEN;
                     break;
                 }
@@ -191,7 +181,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                             tmp);
                         break;
                     }
-                    t.tm_mday = tmp;
+                    t->tm_mday = tmp;
                     state = DATETIME_SPACE;
                     break;
                 }
@@ -231,7 +221,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                             tmp);
                         break;
                     }
-                    t.tm_hour = tmp;
+                    t->tm_hour = tmp;
                     state = DATETIME_FIRST_COLON;
                     break;
                 }
@@ -274,7 +264,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                             tmp);
                         break;
                     }
-                    t.tm_min = tmp;
+                    t->tm_min = tmp;
                     state = DATETIME_SECOND_COLON;
                     break;
                 }
@@ -314,7 +304,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                             tmp);
                         break;
                     }
-                    t.tm_sec = tmp;
+                    t->tm_sec = tmp;
                     state = DATETIME_DONE;
                     break;
                 }
@@ -329,7 +319,7 @@ blogc_convert_datetime(const char *orig, const char *format,
         }
 
         if (*err != NULL)
-            return NULL;
+            return false;
     }
 
     if (*err == NULL) {
@@ -355,7 +345,7 @@ blogc_convert_datetime(const char *orig, const char *format,
                     "Found '%s', formats allowed are: 'yyyy-mm-dd hh:mm:ss', "
                     "'yyyy-mm-dd hh:ss', 'yyyy-mm-dd hh' and 'yyyy-mm-dd'.",
                     orig);
-                return NULL;
+                return false;
 
             case DATETIME_SPACE:
             case DATETIME_FIRST_COLON:
@@ -365,6 +355,32 @@ blogc_convert_datetime(const char *orig, const char *format,
         }
     }
 
+    return true;
+}
+
+#endif /* HAVE_TIME_H */
+
+
+char*
+blogc_convert_datetime(const char *orig, const char *format,
+    bc_error_t **err)
+{
+    if (err == NULL || *err != NULL)
+        return NULL;
+
+#ifndef HAVE_TIME_H
+
+    *err = bc_error_new(BLOGC_WARNING_DATETIME_PARSER,
+        "Your operating system does not supports the datetime functionalities "
+        "used by blogc. Sorry.");
+    return NULL;
+
+#else
+
+    struct tm t;
+    if (!parse_datetime(orig, &t, err))
+        return NULL;
+
     mktime(&t);
 
     char buf[1024];
@@ -379,3 +395,30 @@ blogc_convert_datetime(const char *orig, const char *format,
 
 #endif
 }
+
+
+bool
+blogc_convert_datetime_timestamp(const char *orig, int64_t *timestamp,
+    bc_error_t **err)
+{
+    if (err == NULL || *err != NULL)
+        return false;
+
+#ifndef HAVE_TIME_H
+
+    *err = bc_error_new(BLOGC_WARNING_DATETIME_PARSER,
+        "Your operating system does not supports the datetime functionalities "
+        "used by blogc. Sorry.");
+    return false;
+
+#else
+
+    struct tm t;
+    if (!parse_datetime(orig, &t, err))
+        return false;
+
+    *timestamp = (int64_t) mktime(&t);
+    return true;
+
+#endif
+}
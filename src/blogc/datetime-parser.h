@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "../common/error.h"
 
 char* blogc_convert_datetime(const char *orig, const char *format,
     bc_error_t **err);
+bool blogc_convert_datetime_timestamp(const char *orig, int64_t *timestamp,
+    bc_error_t **err);
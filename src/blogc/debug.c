@@ -2,11 +2,23 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "rusage.h"
 #include "template-parser.h"
 #include "../common/utils.h"
 #include "debug.h"
 
+#define BLOGC_DEBUG_ALLOC_MAX_PHASES 8
+#define BLOGC_DEBUG_ALLOC_MAX_SITES 20
+
+static struct {
+    const char *name;
+    bc_alloc_stats_t stats;
+} alloc_phases[BLOGC_DEBUG_ALLOC_MAX_PHASES];
+static size_t alloc_phases_len = 0;
+
 
 static const char*
 get_operator(blogc_template_operator_t op)
@@ -29,10 +41,10 @@ get_operator(blogc_template_operator_t op)
 
 
 void
-blogc_debug_template(bc_slist_t *ast)
+blogc_debug_template(blogc_template_t *tmpl)
 {
-    for (bc_slist_t *tmp = ast; tmp != NULL; tmp = tmp->next) {
-        blogc_template_node_t *data = tmp->data;
+    for (size_t i = 0; i < tmpl->nodes_len; i++) {
+        blogc_template_node_t *data = tmpl->nodes + i;
         fprintf(stderr, "DEBUG: <TEMPLATE ");
         switch (data->type) {
             case BLOGC_TEMPLATE_NODE_IFDEF:
@@ -73,3 +85,77 @@ blogc_debug_template(bc_slist_t *ast)
         fprintf(stderr, ">\n");
     }
 }
+
+
+void
+blogc_debug_alloc_stats_phase(const char *name)
+{
+    if (!bc_alloc_stats_enabled() ||
+        alloc_phases_len >= BLOGC_DEBUG_ALLOC_MAX_PHASES)
+        return;
+    alloc_phases[alloc_phases_len].name = name;
+    bc_alloc_stats_get(&alloc_phases[alloc_phases_len].stats);
+    alloc_phases_len++;
+}
+
+
+static const char*
+short_path(const char *file)
+{
+    const char *rv = file;
+    for (const char *tmp = file; NULL != (tmp = strstr(tmp, "src/")); tmp++)
+        rv = tmp;
+    return rv;
+}
+
+
+void
+blogc_debug_alloc_stats(void)
+{
+    if (!bc_alloc_stats_enabled())
+        return;
+
+    // the report itself shouldn't be accounted
+    bc_alloc_stats_enable(false);
+
+    bc_alloc_stats_t total;
+    bc_alloc_stats_get(&total);
+    fprintf(stderr, "DEBUG: <ALLOC TOTAL: %zu calls, %zu bytes>\n",
+        total.calls, total.bytes);
+
+    size_t calls = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < alloc_phases_len; i++) {
+        fprintf(stderr, "DEBUG: <ALLOC PHASE %s: %zu calls, %zu bytes>\n",
+            alloc_phases[i].name, alloc_phases[i].stats.calls - calls,
+            alloc_phases[i].stats.bytes - bytes);
+        calls = alloc_phases[i].stats.calls;
+        bytes = alloc_phases[i].stats.bytes;
+    }
+
+    for (size_t i = 0; i < BC_ALLOC_STATS_HISTOGRAM_SIZE; i++) {
+        if (total.histogram[i] == 0)
+            continue;
+        fprintf(stderr, "DEBUG: <ALLOC SIZE %zu-%zu: %zu calls>\n",
+            i == 0 ? 0 : ((size_t) 1) << i, (((size_t) 1) << (i + 1)) - 1,
+            total.histogram[i]);
+    }
+
+    bc_alloc_site_t *sites = bc_malloc(BLOGC_DEBUG_ALLOC_MAX_SITES *
+        sizeof(bc_alloc_site_t));
+    size_t sites_len = bc_alloc_stats_get_sites(sites,
+        BLOGC_DEBUG_ALLOC_MAX_SITES);
+    for (size_t i = 0; i < sites_len; i++)
+        fprintf(stderr, "DEBUG: <ALLOC SITE %s:%d: %zu calls, %zu bytes>\n",
+            short_path(sites[i].file), sites[i].line, sites[i].calls,
+            sites[i].bytes);
+    free(sites);
+
+    blogc_rusage_t *usage = blogc_rusage_get();
+    if (usage != NULL) {
+        char *mem = blogc_rusage_format_memory(usage->memory);
+        fprintf(stderr, "DEBUG: <ALLOC PEAK RSS: %s>\n", mem);
+        free(mem);
+        free(usage);
+    }
+}
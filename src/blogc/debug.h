@@ -3,6 +3,8 @@
 
 #pragma once
 
-#include "../common/utils.h"
+#include "template-parser.h"
 
-void blogc_debug_template(bc_slist_t *ast);
+void blogc_debug_template(blogc_template_t *tmpl);
+void blogc_debug_alloc_stats_phase(const char *name);
+void blogc_debug_alloc_stats(void);
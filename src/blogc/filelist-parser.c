@@ -15,6 +15,7 @@ blogc_filelist_parse(const char *src, size_t src_len)
 {
     size_t current = 0;
     bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
     bc_string_t *line = bc_string_new();
     blogc_filelist_parser_state_t state = LINE_START;
 
@@ -42,7 +43,7 @@ blogc_filelist_parse(const char *src, size_t src_len)
                 if (c == '\r' || c == '\n' || is_last) {
                     if (is_last && c != '\r' && c != '\n')
                         bc_string_append_c(line, c);
-                    rv = bc_slist_append(rv, bc_str_strip(line->str));
+                    rv = bc_slist_append_tail(rv, &tail, bc_str_strip(line->str));
                     bc_string_free(line, false);
                     line = bc_string_new();
                     state = LINE_START;
@@ -35,6 +35,21 @@ static const struct func_map {
 };
 
 
+blogc_funcvars_func_t
+blogc_funcvars_lookup(const char *name)
+{
+    if (name == NULL)
+        return NULL;
+
+    for (size_t i = 0; funcs[i].variable != NULL; i++) {
+        if (0 == strcmp(name, funcs[i].variable))
+            return funcs[i].func;
+    }
+
+    return NULL;
+}
+
+
 void
 blogc_funcvars_eval(bc_trie_t *global, const char *name)
 {
@@ -46,12 +61,7 @@ blogc_funcvars_eval(bc_trie_t *global, const char *name)
     if (NULL != bc_trie_lookup(global, name))
         return;
 
-    for (size_t i = 0; funcs[i].variable != NULL; i++) {
-        if (0 == strcmp(name, funcs[i].variable)) {
-            funcs[i].func(global);
-            return;
-        }
-    }
-
-    return;
+    blogc_funcvars_func_t func = blogc_funcvars_lookup(name);
+    if (func != NULL)
+        func(global);
 }
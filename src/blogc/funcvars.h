@@ -8,4 +8,5 @@
 
 typedef void (*blogc_funcvars_func_t) (bc_trie_t*);
 
+blogc_funcvars_func_t blogc_funcvars_lookup(const char *name);
 void blogc_funcvars_eval(bc_trie_t *global, const char *name);
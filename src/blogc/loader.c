@@ -1,14 +1,27 @@
 // SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
 // SPDX-License-Identifier: BSD-3-Clause
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
+
 #include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "cache.h"
 #include "datetime-parser.h"
+#include "source-cache.h"
 #include "source-parser.h"
+#include "tag-index.h"
+#include "template-cache.h"
 #include "template-parser.h"
 #include "loader.h"
 #include "../common/error.h"
@@ -54,36 +67,67 @@ blogc_get_filename(const char *f)
 }
 
 
-bc_slist_t*
+blogc_template_t*
 blogc_template_parse_from_file(const char *f, bc_error_t **err)
 {
     if (err == NULL || *err != NULL)
         return NULL;
 
-    size_t len;
-    char *s = bc_file_get_contents(f, true, &len, err);
-    if (s == NULL)
+    bc_file_map_t *m = bc_file_map(f, true, err);
+    if (m == NULL)
         return NULL;
-    bc_slist_t *rv = blogc_template_parse(s, len, err);
-    free(s);
+    const char *cache_dir = blogc_cache_dir();
+    blogc_template_t *rv = blogc_template_cache_get(cache_dir, m->str, m->len);
+    if (rv == NULL) {
+        rv = blogc_template_parse(m->str, m->len, err);
+        blogc_template_cache_put(cache_dir, m->str, m->len, rv);
+    }
+    bc_file_unmap(m);
+    return rv;
+}
+
+
+blogc_source_field_t
+blogc_get_source_fields(blogc_template_t *tmpl)
+{
+    if (tmpl == NULL)
+        return BLOGC_SOURCE_FIELD_ALL;
+
+    static const struct {
+        const char *variable;
+        blogc_source_field_t field;
+    } vars[] = {
+        {"RAW_CONTENT", BLOGC_SOURCE_FIELD_RAW_CONTENT},
+        {"CONTENT", BLOGC_SOURCE_FIELD_CONTENT},
+        {"FIRST_HEADER", BLOGC_SOURCE_FIELD_CONTENT},
+        {"DESCRIPTION", BLOGC_SOURCE_FIELD_CONTENT},
+        {"EXCERPT", BLOGC_SOURCE_FIELD_EXCERPT},
+        {"TOCTREE", BLOGC_SOURCE_FIELD_TOCTREE},
+    };
+
+    blogc_source_field_t rv = 0;
+    for (size_t i = 0; i < sizeof(vars) / sizeof(vars[0]); i++) {
+        if (blogc_template_uses_variable(tmpl, vars[i].variable))
+            rv |= vars[i].field;
+    }
     return rv;
 }
 
 
 bc_trie_t*
-blogc_source_parse_from_file(bc_trie_t *conf, const char *f, bc_error_t **err)
+blogc_source_parse_from_file(bc_trie_t *conf, const char *f,
+    blogc_source_field_t fields, bc_error_t **err)
 {
     if (err == NULL || *err != NULL)
         return NULL;
 
-    size_t len;
-    char *s = bc_file_get_contents(f, true, &len, err);
-    if (s == NULL)
+    bc_file_map_t *m = bc_file_map(f, true, err);
+    if (m == NULL)
         return NULL;
 
     int toctree_maxdepth = -1;
     const char *maxdepth = bc_trie_lookup(conf, "TOCTREE_MAXDEPTH");
-    if (maxdepth != NULL) {
+    if (maxdepth != NULL && (fields & BLOGC_SOURCE_FIELD_TOCTREE)) {
         char *endptr;
         toctree_maxdepth = strtol(maxdepth, &endptr, 10);
         if (*maxdepth != '\0' && *endptr != '\0') {
@@ -92,7 +136,16 @@ blogc_source_parse_from_file(bc_trie_t *conf, const char *f, bc_error_t **err)
         }
     }
 
-    bc_trie_t *rv = blogc_source_parse(s, len, toctree_maxdepth, err);
+    // the header-only parser is cheaper than a cache lookup.
+    const char *cache_dir = fields != 0 ? blogc_cache_dir() : NULL;
+    bc_trie_t *rv = blogc_source_cache_get(cache_dir, m->str, m->len,
+        toctree_maxdepth, fields);
+    if (rv == NULL) {
+        rv = blogc_source_parse_fields(m->str, m->len, toctree_maxdepth,
+            fields, err);
+        blogc_source_cache_put(cache_dir, m->str, m->len, toctree_maxdepth,
+            fields, rv);
+    }
 
     // set FILENAME variable
     if (rv != NULL) {
@@ -101,25 +154,32 @@ blogc_source_parse_from_file(bc_trie_t *conf, const char *f, bc_error_t **err)
             bc_trie_insert(rv, "FILENAME", filename);
     }
 
-    free(s);
+    bc_file_unmap(m);
     return rv;
 }
 
 
+typedef struct {
+    int64_t timestamp;
+    const char *path;
+    bc_trie_t *source;
+    bc_error_t *err;
+    bool shared;
+} blogc_source_entry_t;
+
+
 static int
 sort_source(const void *a, const void *b)
 {
-    const char *ca = bc_trie_lookup((bc_trie_t*) a, "c");
-    const char *cb = bc_trie_lookup((bc_trie_t*) b, "c");
-
-    if (ca == NULL || cb == NULL) {
-        return 0;  // wat
-    }
-
-    unsigned long la = strtoul(ca, NULL, 10);
-    unsigned long lb = strtoul(cb, NULL, 10);
-
-    return (int) (lb - la);
+    int64_t ta = ((const blogc_source_entry_t*) a)->timestamp;
+    int64_t tb = ((const blogc_source_entry_t*) b)->timestamp;
+
+    // newest first
+    if (ta < tb)
+        return 1;
+    if (ta > tb)
+        return -1;
+    return 0;
 }
 
 
@@ -130,150 +190,245 @@ sort_source_reverse(const void *a, const void *b)
 }
 
 
-bc_slist_t*
-blogc_source_parse_from_files(bc_trie_t *conf, bc_slist_t *l, bc_error_t **err)
+static blogc_source_entry_t*
+new_entries(size_t len)
 {
-    if (err == NULL || *err != NULL)
+    if (len == 0)
         return NULL;
+    blogc_source_entry_t *rv = bc_malloc(len * sizeof(blogc_source_entry_t));
+    memset(rv, 0, len * sizeof(blogc_source_entry_t));
+    return rv;
+}
 
-    bool sort = bc_str_to_bool(bc_trie_lookup(conf, "FILTER_SORT"));
 
-    bc_slist_t* sources = NULL;
-    bc_error_t *tmp_err = NULL;
-    size_t with_date = 0;
-    for (bc_slist_t *tmp = l; tmp != NULL; tmp = tmp->next) {
-        char *f = tmp->data;
-        bc_trie_t *s = blogc_source_parse_from_file(conf, f, &tmp_err);
-        if (s == NULL) {
-            *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
-                "An error occurred while parsing source file: %s\n\n%s",
-                f, tmp_err->msg);
-            bc_error_free(tmp_err);
-            bc_slist_free_full(sources, (bc_free_func_t) bc_trie_free);
-            return NULL;
-        }
+static void
+free_entries(blogc_source_entry_t *entries, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (!entries[i].shared)
+            bc_trie_free(entries[i].source);
+        bc_error_free(entries[i].err);
+    }
+    free(entries);
+}
 
-        const char *date = bc_trie_lookup(s, "DATE");
-        if (date != NULL) {
-            with_date++;
-        }
 
-        if (sort) {
-            if (date == NULL) {
-                *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
-                    "'FILTER_SORT' requires that 'DATE' variable is set for "
-                    "every source file: %s", f);
-                bc_trie_free(s);
-                bc_slist_free_full(sources, (bc_free_func_t) bc_trie_free);
-                return NULL;
-            }
+static bool
+parse_entry(bc_trie_t *conf, blogc_source_entry_t *e, blogc_source_field_t fields)
+{
+    if (e->source != NULL)
+        return true;
+    e->source = blogc_source_parse_from_file(conf, e->path, fields, &e->err);
+    return e->source != NULL;
+}
 
-            char *timestamp = blogc_convert_datetime(date, "%s", &tmp_err);
-            if (timestamp == NULL) {
-                *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
-                    "An error occurred while parsing 'DATE' variable: %s"
-                    "\n\n%s", f, tmp_err->msg);
-                bc_error_free(tmp_err);
-                bc_trie_free(s);
-                bc_slist_free_full(sources, (bc_free_func_t) bc_trie_free);
-                return NULL;
-            }
 
-            bc_trie_insert(s, "c", timestamp);
+#ifdef HAVE_PTHREAD_H
+
+typedef struct {
+    bc_trie_t *conf;
+    blogc_source_entry_t *entries;
+    size_t entries_len;
+    blogc_source_field_t fields;
+    size_t next;
+    bool failed;
+    pthread_mutex_t mutex;
+} blogc_source_queue_t;
+
+
+static void*
+parse_worker(void *arg)
+{
+    blogc_source_queue_t *q = arg;
+
+    while (true) {
+        pthread_mutex_lock(&q->mutex);
+        bool done = q->failed || q->next >= q->entries_len;
+        size_t i = q->next;
+        if (!done)
+            q->next++;
+        pthread_mutex_unlock(&q->mutex);
+        if (done)
+            break;
+
+        if (!parse_entry(q->conf, q->entries + i, q->fields)) {
+            pthread_mutex_lock(&q->mutex);
+            q->failed = true;
+            pthread_mutex_unlock(&q->mutex);
         }
+    }
+
+    return NULL;
+}
+
+#endif /* HAVE_PTHREAD_H */
+
 
-        sources = bc_slist_append(sources, s);
+static void
+parse_entries(bc_trie_t *conf, blogc_source_entry_t *entries, size_t len,
+    blogc_source_field_t fields, size_t jobs)
+{
+#ifdef HAVE_PTHREAD_H
+    // the source parser only touches its own data, and the global
+    // configuration is only read, so the sources can be parsed concurrently.
+    // entries are picked in order, and workers stop picking new entries after
+    // the first error. it means that every entry before the failing one is
+    // parsed, and the first error is the same reported by a serial run.
+    // entries left behind are parsed lazily by load_entry.
+    if (jobs > len)
+        jobs = len;
+    if (jobs <= 1)
+        return;
+
+    blogc_source_queue_t q;
+    q.conf = conf;
+    q.entries = entries;
+    q.entries_len = len;
+    q.fields = fields;
+    q.next = 0;
+    q.failed = false;
+    pthread_mutex_init(&q.mutex, NULL);
+
+    pthread_t *threads = bc_malloc((jobs - 1) * sizeof(pthread_t));
+    size_t threads_len = 0;
+    for (size_t i = 0; i < jobs - 1; i++) {
+        if (0 != pthread_create(&threads[threads_len], NULL, parse_worker, &q))
+            break;
+        threads_len++;
     }
+    parse_worker(&q);
+    for (size_t i = 0; i < threads_len; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&q.mutex);
+#endif /* HAVE_PTHREAD_H */
+}
 
-    if (with_date > 0 && with_date < bc_slist_length(l)) {
+
+static bool
+load_entry(bc_trie_t *conf, blogc_source_entry_t *e, blogc_source_field_t fields,
+    bc_error_t **err)
+{
+    if (e->err == NULL)
+        parse_entry(conf, e, fields);
+    if (e->err != NULL) {
         *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
-            "'DATE' variable provided for at least one source file, but not "
-            "for all source files. It must be provided for all files.");
-        bc_slist_free_full(sources, (bc_free_func_t) bc_trie_free);
-        return NULL;
+            "An error occurred while parsing source file: %s\n\n%s",
+            e->path, e->err->msg);
+        return false;
     }
+    return true;
+}
 
-    bool reverse = bc_str_to_bool(bc_trie_lookup(conf, "FILTER_REVERSE"));
 
-    if (sort) {
-        sources = bc_slist_sort(sources,
-            (bc_sort_func_t) (reverse ? sort_source_reverse : sort_source));
+static char*
+shared_key(bc_trie_t *conf, const char *path)
+{
+    // the toctree depth is the only configuration variable that changes the
+    // parser output.
+    const char *maxdepth = bc_trie_lookup(conf, "TOCTREE_MAXDEPTH");
+    return bc_strdup_printf("%s:%s", maxdepth != NULL ? maxdepth : "", path);
+}
+
+
+static void
+share_entry(bc_trie_t *conf, bc_trie_t *shared, blogc_source_entry_t *e)
+{
+    if (shared == NULL || e->shared)
+        return;
+
+    char *key = shared_key(conf, e->path);
+    bc_trie_t *s = bc_trie_lookup(shared, key);
+    if (s == NULL) {
+        bc_trie_insert(shared, key, e->source);
     }
-    else if (reverse) {
-        bc_slist_t *tmp_sources = NULL;
-        for (bc_slist_t *tmp = sources; tmp != NULL; tmp = tmp->next) {
-            tmp_sources = bc_slist_prepend(tmp_sources, tmp->data);
-        }
-        bc_slist_t *tmp = sources;
-        sources = tmp_sources;
-        bc_slist_free(tmp);
+    else {
+        // the same file was listed twice.
+        bc_trie_free(e->source);
+        e->source = s;
     }
+    e->shared = true;
+    free(key);
+}
 
-    const char *filter_tag = bc_trie_lookup(conf, "FILTER_TAG");
-    const char *filter_page = bc_trie_lookup(conf, "FILTER_PAGE");
-    const char *filter_per_page = bc_trie_lookup(conf, "FILTER_PER_PAGE");
 
+static void
+get_pagination(bc_trie_t *conf, long *page, long *per_page)
+{
     const char *ptr;
     char *endptr;
 
-    ptr = filter_page != NULL ? filter_page : "";
-    long page = strtol(ptr, &endptr, 10);
+    ptr = bc_trie_lookup(conf, "FILTER_PAGE");
+    if (ptr == NULL)
+        ptr = "";
+    *page = strtol(ptr, &endptr, 10);
     if (*ptr != '\0' && *endptr != '\0')
         fprintf(stderr, "warning: invalid value for 'FILTER_PAGE' variable: "
-            "%s. using %ld instead\n", ptr, page);
-    if (page <= 0)
-        page = 1;
-
-    ptr = filter_per_page != NULL ? filter_per_page : "10";
-    long per_page = strtol(ptr, &endptr, 10);
+            "%s. using %ld instead\n", ptr, *page);
+    if (*page <= 0)
+        *page = 1;
+
+    ptr = bc_trie_lookup(conf, "FILTER_PER_PAGE");
+    if (ptr == NULL)
+        ptr = "10";
+    *per_page = strtol(ptr, &endptr, 10);
     if (*ptr != '\0' && *endptr != '\0')
         fprintf(stderr, "warning: invalid value for 'FILTER_PER_PAGE' variable: "
-            "%s. using %ld instead\n", ptr, per_page);
-    if (per_page < 0)
-        per_page = 0;
+            "%s. using %ld instead\n", ptr, *per_page);
+    if (*per_page < 0)
+        *per_page = 0;
+}
+
 
+static void
+get_page_range(bool paginated, long page, long per_page, size_t len,
+    size_t *start, size_t *end)
+{
     // poor man's pagination
-    size_t start = (page - 1) * per_page;
-    size_t end = start + per_page;
-    size_t counter = 0;
+    *start = 0;
+    *end = len;
+    if (!paginated)
+        return;
+    *start = (page - 1) * per_page;
+    *end = *start + per_page;
+    if (*start > len)
+        *start = len;
+    if (*end > len)
+        *end = len;
+}
 
-    bc_slist_t *rv = NULL;
-    for (bc_slist_t *tmp = sources; tmp != NULL; tmp = tmp->next) {
-        bc_trie_t *s = tmp->data;
-        if (filter_tag != NULL) {
-            const char *tags_str = bc_trie_lookup(s, "TAGS");
-            // if user wants to filter by tag and no tag is provided, skip it
-            if (tags_str == NULL) {
-                bc_trie_free(s);
-                continue;
-            }
-            char **tags = bc_str_split(tags_str, ' ', 0);
-            bool found = false;
-            for (size_t i = 0; tags[i] != NULL; i++) {
-                if (tags[i][0] == '\0')
-                    continue;
-                if (0 == strcmp(tags[i], filter_tag))
-                    found = true;
-            }
-            bc_strv_free(tags);
-            if (!found) {
-                bc_trie_free(s);
-                continue;
-            }
-        }
-        if (filter_page != NULL) {
-            if (counter < start || counter >= end) {
-                counter++;
-                bc_trie_free(s);
-                continue;
-            }
-            counter++;
-        }
-        rv = bc_slist_append(rv, s);
+
+static void
+set_tag_variables(bc_trie_t *conf, blogc_tag_index_t *index, bool paginated,
+    long per_page)
+{
+    if (index->tags_len == 0)
+        return;
+
+    // tags can't be part of variable names, so the counts are listed in a
+    // single variable, as "tag:count" pairs.
+    bc_string_t *counts = bc_string_new();
+    bc_string_t *pages = bc_string_new();
+    for (size_t i = 0; i < index->tags_len; i++) {
+        blogc_tag_posting_t *p = index->tags[i];
+        const char *sep = i > 0 ? " " : "";
+        bc_string_append_printf(counts, "%s%s:%zu", sep, p->tag, p->sources_len);
+        size_t last_page = per_page > 0 ?
+            (p->sources_len + per_page - 1) / per_page : 0;
+        bc_string_append_printf(pages, "%s%s:%zu", sep, p->tag, last_page);
     }
+    bc_trie_insert(conf, "TAG_COUNTS", bc_string_free(counts, false));
+    if (paginated)
+        bc_trie_insert(conf, "TAG_LAST_PAGES", bc_string_free(pages, false));
+    else
+        bc_string_free(pages, true);
+}
 
-    bc_slist_free(sources);
 
+static void
+set_listing_variables(bc_trie_t *conf, bc_slist_t *rv, bool paginated,
+    size_t counter, long page, long per_page)
+{
     bool first = true;
     for (bc_slist_t *tmp = rv; tmp != NULL; tmp = tmp->next) {
         bc_trie_t *s = tmp->data;
@@ -296,18 +451,224 @@ blogc_source_parse_from_files(bc_trie_t *conf, bc_slist_t *l, bc_error_t **err)
         }
     }
 
-    if (filter_page != NULL) {
+    if (paginated) {
         size_t last_page = ceilf(((float) counter) / per_page);
         bc_trie_insert(conf, "CURRENT_PAGE", bc_strdup_printf("%ld", page));
         if (page > 1)
             bc_trie_insert(conf, "PREVIOUS_PAGE", bc_strdup_printf("%ld", page - 1));
         if (page < last_page)
             bc_trie_insert(conf, "NEXT_PAGE", bc_strdup_printf("%ld", page + 1));
-        if (bc_slist_length(rv) > 0)
+        if (rv != NULL)
             bc_trie_insert(conf, "FIRST_PAGE", bc_strdup("1"));
         if (last_page > 0)
             bc_trie_insert(conf, "LAST_PAGE", bc_strdup_printf("%d", last_page));
     }
+}
+
+
+bc_slist_t*
+blogc_source_parse_from_files(bc_trie_t *conf, bc_slist_t *l,
+    blogc_source_field_t fields, size_t jobs, bc_trie_t *shared,
+    bc_error_t **err)
+{
+    if (err == NULL || *err != NULL)
+        return NULL;
+
+    bool sort = bc_str_to_bool(bc_trie_lookup(conf, "FILTER_SORT"));
+    const char *filter_tag = bc_trie_lookup(conf, "FILTER_TAG");
+    const char *filter_page = bc_trie_lookup(conf, "FILTER_PAGE");
+
+    // when filtering, most of the sources are going to be discarded. the
+    // headers are enough to sort and filter, so the content is only parsed
+    // later, for the sources that survived.
+    // shared sources are going to be reused by other calls, that may need
+    // other sources, so they are always fully parsed.
+    bool prepass = shared == NULL && fields != 0 &&
+        (filter_tag != NULL || filter_page != NULL);
+
+    bc_error_t *tmp_err = NULL;
+    size_t with_date = 0;
+
+    size_t entries_len = bc_slist_length(l);
+    blogc_source_entry_t *entries = new_entries(entries_len);
+    size_t counter = 0;
+    for (bc_slist_t *tmp = l; tmp != NULL; tmp = tmp->next)
+        entries[counter++].path = tmp->data;
+
+    if (shared != NULL) {
+        for (size_t i = 0; i < entries_len; i++) {
+            char *key = shared_key(conf, entries[i].path);
+            entries[i].source = bc_trie_lookup(shared, key);
+            entries[i].shared = entries[i].source != NULL;
+            free(key);
+        }
+    }
+
+    parse_entries(conf, entries, entries_len, prepass ? 0 : fields, jobs);
+
+    for (size_t i = 0; i < entries_len; i++) {
+        const char *f = entries[i].path;
+
+        if (!load_entry(conf, entries + i, prepass ? 0 : fields, err)) {
+            free_entries(entries, entries_len);
+            return NULL;
+        }
+        share_entry(conf, shared, entries + i);
+
+        const char *date = bc_trie_lookup(entries[i].source, "DATE");
+        if (date != NULL) {
+            with_date++;
+        }
+
+        if (sort) {
+            if (date == NULL) {
+                *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
+                    "'FILTER_SORT' requires that 'DATE' variable is set for "
+                    "every source file: %s", f);
+                free_entries(entries, entries_len);
+                return NULL;
+            }
+
+            // sort keys are parsed once per source, instead of once per
+            // comparison.
+            if (!blogc_convert_datetime_timestamp(date, &entries[i].timestamp,
+                    &tmp_err))
+            {
+                *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
+                    "An error occurred while parsing 'DATE' variable: %s"
+                    "\n\n%s", f, tmp_err->msg);
+                bc_error_free(tmp_err);
+                free_entries(entries, entries_len);
+                return NULL;
+            }
+        }
+    }
+
+    if (with_date > 0 && with_date < entries_len) {
+        *err = bc_error_new_printf(BLOGC_ERROR_LOADER,
+            "'DATE' variable provided for at least one source file, but not "
+            "for all source files. It must be provided for all files.");
+        free_entries(entries, entries_len);
+        return NULL;
+    }
+
+    bc_slist_t *sources = NULL;
+    bc_slist_t *sources_tail = NULL;
+    for (size_t i = 0; i < entries_len; i++)
+        sources = bc_slist_append_tail(sources, &sources_tail, entries + i);
+
+    bool reverse = bc_str_to_bool(bc_trie_lookup(conf, "FILTER_REVERSE"));
+
+    if (sort) {
+        sources = bc_slist_sort(sources,
+            (bc_sort_func_t) (reverse ? sort_source_reverse : sort_source));
+    }
+    else if (reverse) {
+        bc_slist_t *tmp_sources = NULL;
+        for (bc_slist_t *tmp = sources; tmp != NULL; tmp = tmp->next) {
+            tmp_sources = bc_slist_prepend(tmp_sources, tmp->data);
+        }
+        bc_slist_t *tmp = sources;
+        sources = tmp_sources;
+        bc_slist_free(tmp);
+    }
+
+    // sources are indexed by tag in a single pass, so filtering and
+    // pagination are just lookups.
+    blogc_source_entry_t **sorted = NULL;
+    bc_trie_t **sorted_sources = NULL;
+    if (entries_len > 0) {
+        sorted = bc_malloc(entries_len * sizeof(blogc_source_entry_t*));
+        sorted_sources = bc_malloc(entries_len * sizeof(bc_trie_t*));
+    }
+    counter = 0;
+    for (bc_slist_t *tmp = sources; tmp != NULL; tmp = tmp->next, counter++) {
+        sorted[counter] = tmp->data;
+        sorted_sources[counter] = sorted[counter]->source;
+    }
+    bc_slist_free(sources);
+    blogc_tag_index_t *index = blogc_tag_index_new(sorted_sources, entries_len);
+    free(sorted_sources);
+
+    long page;
+    long per_page;
+    get_pagination(conf, &page, &per_page);
+    set_tag_variables(conf, index, filter_page != NULL, per_page);
+
+    const size_t *positions = NULL;
+    if (filter_tag != NULL) {
+        // if user wants to filter by tag and no tag is provided, skip it
+        blogc_tag_posting_t *p = blogc_tag_index_lookup(index, filter_tag);
+        positions = p != NULL ? p->sources : NULL;
+        counter = p != NULL ? p->sources_len : 0;
+    }
+
+    size_t start;
+    size_t end;
+    get_page_range(filter_page != NULL, page, per_page, counter, &start, &end);
+
+    // move the selected sources out of the entries, in their final order.
+    size_t selected_len = end - start;
+    blogc_source_entry_t *selected_entries = new_entries(selected_len);
+    for (size_t i = 0; i < selected_len; i++) {
+        blogc_source_entry_t *e = sorted[positions != NULL ?
+            positions[start + i] : start + i];
+        selected_entries[i].path = e->path;
+        selected_entries[i].shared = e->shared;
+        if (!prepass)
+            selected_entries[i].source = e->source;
+        else
+            bc_trie_free(e->source);
+        e->source = NULL;
+    }
+    blogc_tag_index_free(index);
+    free(sorted);
+    free_entries(entries, entries_len);
+
+    if (prepass) {
+        parse_entries(conf, selected_entries, selected_len, fields, jobs);
+        for (size_t i = 0; i < selected_len; i++) {
+            if (!load_entry(conf, selected_entries + i, fields, err)) {
+                free_entries(selected_entries, selected_len);
+                return NULL;
+            }
+        }
+    }
+
+    bc_slist_t *rv = NULL;
+    bc_slist_t *rv_tail = NULL;
+    for (size_t i = 0; i < selected_len; i++)
+        rv = bc_slist_append_tail(rv, &rv_tail, selected_entries[i].source);
+    free(selected_entries);
+
+    set_listing_variables(conf, rv, filter_page != NULL, counter, page,
+        per_page);
+
+    return rv;
+}
+
+
+bc_slist_t*
+blogc_source_filter_page(bc_trie_t *conf, bc_trie_t **sources,
+    const size_t *positions, size_t len)
+{
+    const char *filter_page = bc_trie_lookup(conf, "FILTER_PAGE");
+
+    long page;
+    long per_page;
+    get_pagination(conf, &page, &per_page);
+
+    size_t start;
+    size_t end;
+    get_page_range(filter_page != NULL, page, per_page, len, &start, &end);
+
+    bc_slist_t *rv = NULL;
+    bc_slist_t *rv_tail = NULL;
+    for (size_t i = start; i < end; i++)
+        rv = bc_slist_append_tail(rv, &rv_tail,
+            sources[positions != NULL ? positions[i] : i]);
+
+    set_listing_variables(conf, rv, filter_page != NULL, len, page, per_page);
 
     return rv;
 }
@@ -3,12 +3,28 @@
 
 #pragma once
 
+#include <stddef.h>
 #include "../common/error.h"
 #include "../common/utils.h"
+#include "source-parser.h"
+#include "template-parser.h"
 
 char* blogc_get_filename(const char *f);
-bc_slist_t* blogc_template_parse_from_file(const char *f, bc_error_t **err);
-bc_trie_t* blogc_source_parse_from_file(bc_trie_t *conf, const char *f,
+blogc_template_t* blogc_template_parse_from_file(const char *f,
     bc_error_t **err);
+blogc_source_field_t blogc_get_source_fields(blogc_template_t *tmpl);
+bc_trie_t* blogc_source_parse_from_file(bc_trie_t *conf, const char *f,
+    blogc_source_field_t fields, bc_error_t **err);
+
+// if shared is not NULL, parsed sources are stored there, keyed by their path,
+// and reused by later calls with the same trie, that must request the same
+// fields. the returned sources are then owned by the shared trie.
 bc_slist_t* blogc_source_parse_from_files(bc_trie_t *conf, bc_slist_t *l,
+    blogc_source_field_t fields, size_t jobs, bc_trie_t *shared,
     bc_error_t **err);
+
+// selects the sources of FILTER_PAGE, and sets the listing variables, as
+// blogc_source_parse_from_files does. if positions is not NULL, only the
+// sources at these positions are considered. the sources are borrowed.
+bc_slist_t* blogc_source_filter_page(bc_trie_t *conf, bc_trie_t **sources,
+    const size_t *positions, size_t len);
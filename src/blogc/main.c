@@ -16,19 +16,24 @@
 #endif /* HAVE_SYSEXITS_H */
 
 #include <errno.h>
+#include <fcntl.h>
 #include <locale.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "debug.h"
 #include "filelist-parser.h"
+#include "manifest-parser.h"
+#include "tag-index.h"
 #include "template-parser.h"
 #include "loader.h"
 #include "renderer.h"
 #include "../common/error.h"
+#include "../common/file.h"
 #include "../common/utf8.h"
 #include "../common/utils.h"
 #include "../common/stdin.h"
@@ -51,8 +56,9 @@ blogc_print_help(void)
 #ifdef MAKE_EMBEDDED
         "[-m] "
 #endif
-        "[-h] [-v] [-d] [-i] [-l [-e SOURCE]] [-D KEY=VALUE ...] [-p KEY]\n"
-        "          [-t TEMPLATE] [-o OUTPUT] [SOURCE ...] - A blog compiler.\n"
+        "[-h] [-v] [-d] [-i] [-l [-e SOURCE] [-g]] [-D KEY=VALUE ...] [-p KEY]\n"
+        "          [-j JOBS] [-t TEMPLATE] [-o OUTPUT] [SOURCE ...] - A blog compiler.\n"
+        "    blogc [-D KEY=VALUE ...] [-j JOBS] -M MANIFEST\n"
         "\n"
         "positional arguments:\n"
         "    SOURCE        source file(s)\n"
@@ -64,10 +70,14 @@ blogc_print_help(void)
         "    -i            read list of source files from standard input\n"
         "    -l            build listing page, from multiple source files\n"
         "    -e SOURCE     source file with content for listing page. requires '-l'\n"
+        "    -g            build one listing page per tag, to OUTPUT with '%%t' replaced\n"
+        "                  by the tag, and '%%p' by the page. requires '-l'\n"
         "    -D KEY=VALUE  set global variable\n"
         "    -p KEY        show the value of a variable after source parsing and exit\n"
+        "    -j JOBS       number of threads used to parse source files (0 for one per CPU)\n"
         "    -t TEMPLATE   template file\n"
         "    -o OUTPUT     output file\n"
+        "    -M MANIFEST   render every job listed in the manifest file\n"
 #ifdef MAKE_EMBEDDED
         "    -m            call and pass arguments to embedded blogc-make\n"
 #endif
@@ -83,8 +93,9 @@ blogc_print_usage(void)
 #ifdef MAKE_EMBEDDED
         "[-m] "
 #endif
-        "[-h] [-v] [-d] [-i] [-l [-e SOURCE]] [-D KEY=VALUE ...] [-p KEY]\n"
-        "             [-t TEMPLATE] [-o OUTPUT] [SOURCE ...]\n");
+        "[-h] [-v] [-d] [-i] [-l [-e SOURCE] [-g]] [-D KEY=VALUE ...] [-p KEY]\n"
+        "             [-j JOBS] [-t TEMPLATE] [-o OUTPUT] [SOURCE ...]\n"
+        "       blogc [-D KEY=VALUE ...] [-j JOBS] -M MANIFEST\n");
 }
 
 
@@ -123,11 +134,450 @@ blogc_mkdir_recursive(const char *filename)
 }
 
 
+static size_t
+blogc_cpu_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num >= 1)
+        return (size_t) num;
+#endif
+    return 1;
+}
+
+
+static bool
+blogc_parse_define(bc_trie_t *config, const char *arg)
+{
+    if (!bc_utf8_validate((uint8_t*) arg, strlen(arg))) {
+        fprintf(stderr, "blogc: error: invalid value for "
+            "-D (must be valid UTF-8 string): %s\n", arg);
+        return false;
+    }
+    bc_strview_t value = bc_strview(arg);
+    bc_strview_t key;
+    bc_strview_split_next(&value, '=', &key);
+    if (value.str == NULL) {
+        fprintf(stderr, "blogc: error: invalid value for "
+            "-D (must have an '='): %s\n", arg);
+        return false;
+    }
+    for (size_t j = 0; j < key.len; j++) {
+        char c = key.str[j];
+        if (j == 0) {
+            if (!(c >= 'A' && c <= 'Z')) {
+                fprintf(stderr, "blogc: error: invalid value "
+                    "for -D (first character in configuration "
+                    "key must be uppercase): %.*s\n",
+                    (int) key.len, key.str);
+                return false;
+            }
+            continue;
+        }
+        if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) {
+            fprintf(stderr, "blogc: error: invalid value "
+                "for -D (configuration key must be uppercase "
+                "with '_' and digits after first character): %.*s\n",
+                (int) key.len, key.str);
+            return false;
+        }
+    }
+    char *k = bc_strview_dup(key);
+    bc_trie_insert(config, k, bc_strview_dup(value));
+    free(k);
+    return true;
+}
+
+
+static void
+blogc_render_write(const char *str, size_t len, void *user_data)
+{
+    bc_file_writer_write(user_data, str, len);
+}
+
+
+static int
+blogc_render_output(blogc_template_t *tmpl, bc_slist_t *sources,
+    bc_slist_t *listing_entries, bc_trie_t *config, bool listing,
+    const char *output)
+{
+    bool write_to_stdout = (output == NULL || (0 == strcmp(output, "-")));
+
+    int fd = STDOUT_FILENO;
+    if (!write_to_stdout) {
+        blogc_mkdir_recursive(output);
+        fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0) {
+            fprintf(stderr, "blogc: error: failed to open output file (%s): %s\n",
+                output, strerror(errno));
+            return 1;
+        }
+    }
+
+    // the output is streamed to the file, there's no need to keep the whole
+    // page in memory.
+    int rv = 0;
+    bc_error_t *err = NULL;
+    bc_file_writer_t *writer = bc_file_writer_new(fd);
+    blogc_render_to(tmpl, sources, listing_entries, config, listing,
+        blogc_render_write, writer);
+
+    blogc_debug_alloc_stats_phase("render");
+
+    if (!bc_file_writer_flush(writer, write_to_stdout ? "<stdout>" : output, &err)) {
+        bc_error_print(err, "blogc");
+        bc_error_free(err);
+        rv = 1;
+    }
+    bc_file_writer_free(writer);
+
+    if (!write_to_stdout)
+        close(fd);
+
+    return rv;
+}
+
+
+static void
+blogc_copy_variable(const char *key, void *value, void *user_data)
+{
+    bc_trie_insert(user_data, key, bc_strdup(value));
+}
+
+
+static void
+blogc_copy_unfiltered_variable(const char *key, void *value, void *user_data)
+{
+    // listings grouped by tag are filtered by tag and page after the sources
+    // are loaded.
+    if (0 != strcmp(key, "FILTER_TAG") && 0 != strcmp(key, "FILTER_PAGE"))
+        blogc_copy_variable(key, value, user_data);
+}
+
+
+static bool
+blogc_output_has_placeholder(const char *output, char c)
+{
+    for (const char *tmp = output; tmp != NULL && *tmp != '\0'; tmp++) {
+        if (*tmp != '%' || *(tmp + 1) == '\0')
+            continue;
+        tmp++;
+        if (*tmp == c)
+            return true;
+    }
+    return false;
+}
+
+
+static char*
+blogc_format_output(const char *output, const char *tag, long page)
+{
+    bc_string_t *rv = bc_string_new();
+    for (const char *tmp = output; *tmp != '\0'; tmp++) {
+        if (*tmp != '%' || *(tmp + 1) == '\0') {
+            bc_string_append_c(rv, *tmp);
+            continue;
+        }
+        switch (*(++tmp)) {
+            case 't':
+                bc_string_append(rv, tag);
+                break;
+            case 'p':
+                bc_string_append_printf(rv, "%ld", page);
+                break;
+            case '%':
+                bc_string_append_c(rv, '%');
+                break;
+            default:
+                bc_string_append_c(rv, '%');
+                bc_string_append_c(rv, *tmp);
+        }
+    }
+    return bc_string_free(rv, false);
+}
+
+
+static bool
+blogc_tag_is_safe(const char *tag)
+{
+    // tags become part of output paths, they can't leave the output directory.
+    return strchr(tag, '/') == NULL && strchr(tag, '\\') == NULL &&
+        0 != strcmp(tag, "..");
+}
+
+
+static int
+blogc_render_tags(blogc_template_t *tmpl, bc_slist_t *sources,
+    bc_slist_t *listing_entries, bc_trie_t *config, const char *output)
+{
+    // the sources are indexed by tag in a single pass, instead of being
+    // filtered again for each tag.
+    size_t sources_len = bc_slist_length(sources);
+    bc_trie_t **s_array = bc_malloc((sources_len + 1) * sizeof(bc_trie_t*));
+    size_t i = 0;
+    for (bc_slist_t *tmp = sources; tmp != NULL; tmp = tmp->next)
+        s_array[i++] = tmp->data;
+    blogc_tag_index_t *index = blogc_tag_index_new(s_array, sources_len);
+    bool all_pages = blogc_output_has_placeholder(output, 'p');
+
+    int rv = 0;
+    for (i = 0; i < index->tags_len; i++) {
+        blogc_tag_posting_t *t = index->tags[i];
+        if (!blogc_tag_is_safe(t->tag)) {
+            const char *filename = bc_trie_lookup(s_array[t->sources[0]],
+                "FILENAME");
+            fprintf(stderr, "blogc: error: invalid tag in source (%s): %s\n",
+                filename != NULL ? filename : "<unknown>", t->tag);
+            rv = 1;
+        }
+    }
+
+    for (i = 0; i < index->tags_len && rv == 0; i++) {
+        blogc_tag_posting_t *t = index->tags[i];
+        for (long page = 1; rv == 0; page++) {
+            bc_trie_t *conf = bc_trie_new(free);
+            bc_trie_foreach(config, blogc_copy_variable, conf);
+            bc_trie_insert(conf, "FILTER_TAG", bc_strdup(t->tag));
+            if (all_pages)
+                bc_trie_insert(conf, "FILTER_PAGE", bc_strdup_printf("%ld", page));
+
+            bc_slist_t *s = blogc_source_filter_page(conf, s_array, t->sources,
+                t->sources_len);
+            char *o = blogc_format_output(output, t->tag, page);
+            rv = blogc_render_output(tmpl, s, listing_entries, conf, true, o);
+            bool last = !all_pages || s == NULL ||
+                bc_trie_lookup(conf, "NEXT_PAGE") == NULL;
+            free(o);
+            bc_slist_free(s);
+            bc_trie_free(conf);
+            if (last)
+                break;
+        }
+    }
+
+    blogc_tag_index_free(index);
+    free(s_array);
+    return rv;
+}
+
+
+typedef struct {
+    bool listing;
+    bool group;
+    char *template;
+    char *output;
+    bc_slist_t *sources;
+    bc_slist_t *listing_entries;
+    bc_trie_t *config;
+} blogc_manifest_job_t;
+
+
+static bool
+blogc_manifest_job_parse(blogc_manifest_job_t *job, size_t n, char **argv)
+{
+    bc_slist_t *sources_tail = NULL;
+    bc_slist_t *listing_entries_tail = NULL;
+    size_t argc = bc_strv_length(argv);
+
+    for (size_t i = 0; i < argc; i++) {
+        if (argv[i][0] != '-') {
+            job->sources = bc_slist_append_tail(job->sources, &sources_tail,
+                bc_strdup(argv[i]));
+            continue;
+        }
+        const char *opt = argv[i];
+        const char *arg = NULL;
+        if (opt[1] != '\0' && opt[1] != 'l' && opt[1] != 'g') {
+            if (opt[2] != '\0')
+                arg = opt + 2;
+            else if (i + 1 < argc)
+                arg = argv[++i];
+        }
+        switch (opt[1]) {
+            case 'l':
+                job->listing = true;
+                break;
+            case 'g':
+                job->group = true;
+                break;
+            case 'e':
+                if (arg != NULL)
+                    job->listing_entries = bc_slist_append_tail(
+                        job->listing_entries, &listing_entries_tail,
+                        bc_strdup(arg));
+                break;
+            case 't':
+                free(job->template);
+                job->template = bc_strdup(arg);
+                break;
+            case 'o':
+                free(job->output);
+                job->output = bc_strdup(arg);
+                break;
+            case 'D':
+                if (arg != NULL && !blogc_parse_define(job->config, arg))
+                    return false;
+                break;
+            default:
+                fprintf(stderr, "blogc: error: invalid argument in manifest "
+                    "job %zu: %s\n", n, opt);
+                return false;
+        }
+    }
+
+    if (job->template == NULL) {
+        fprintf(stderr, "blogc: error: argument -t is required in manifest "
+            "job %zu\n", n);
+        return false;
+    }
+
+    if (!job->listing && bc_slist_length(job->sources) != 1) {
+        fprintf(stderr, "blogc: error: exactly one source file should be "
+            "provided to manifest job %zu, if running without '-l'\n", n);
+        return false;
+    }
+
+    if (job->group && (!job->listing ||
+        !blogc_output_has_placeholder(job->output, 't')))
+    {
+        fprintf(stderr, "blogc: error: '-g' requires '-l' and an output file "
+            "with '%%t' in manifest job %zu\n", n);
+        return false;
+    }
+
+    return true;
+}
+
+
+static int
+blogc_run_manifest(const char *manifest, bc_trie_t *config, size_t jobs)
+{
+    int rv = 0;
+    bc_error_t *err = NULL;
+
+    size_t len;
+    char *src = bc_file_get_contents(manifest, true, &len, &err);
+    bc_slist_t *lines = blogc_manifest_parse(src, len, &err);
+    free(src);
+    if (err != NULL) {
+        bc_error_print(err, "blogc");
+        bc_error_free(err);
+        return 1;
+    }
+    if (lines == NULL)
+        return 0;
+
+    size_t jobs_len = bc_slist_length(lines);
+    blogc_manifest_job_t *mjobs = bc_malloc(jobs_len * sizeof(blogc_manifest_job_t));
+    memset(mjobs, 0, jobs_len * sizeof(blogc_manifest_job_t));
+
+    // every template and source is parsed only once, and shared by all the
+    // jobs that use it. sources are parsed with the fields required by all
+    // the templates.
+    bc_trie_t *templates = bc_trie_new((bc_free_func_t) blogc_template_free);
+    bc_trie_t *shared = bc_trie_new((bc_free_func_t) bc_trie_free);
+    blogc_source_field_t fields = 0;
+
+    size_t i = 0;
+    for (bc_slist_t *tmp = lines; tmp != NULL; tmp = tmp->next, i++) {
+        blogc_manifest_job_t *job = mjobs + i;
+        job->config = bc_trie_new(free);
+        bc_trie_foreach(config, blogc_copy_variable, job->config);
+        if (!blogc_manifest_job_parse(job, i + 1, tmp->data)) {
+            rv = 1;
+            goto cleanup;
+        }
+        if (bc_trie_lookup(templates, job->template) == NULL) {
+            blogc_template_t *l = blogc_template_parse_from_file(job->template,
+                &err);
+            if (err != NULL) {
+                bc_error_print(err, "blogc");
+                rv = 1;
+                goto cleanup;
+            }
+            bc_trie_insert(templates, job->template, l);
+            fields |= blogc_get_source_fields(l);
+        }
+    }
+
+    blogc_debug_alloc_stats_phase("manifest");
+
+    for (i = 0; i < jobs_len; i++) {
+        blogc_manifest_job_t *job = mjobs + i;
+
+        bc_trie_t *load_config = job->config;
+        if (job->group) {
+            load_config = bc_trie_new(free);
+            bc_trie_foreach(job->config, blogc_copy_unfiltered_variable,
+                load_config);
+        }
+        bc_slist_t *s = blogc_source_parse_from_files(load_config, job->sources,
+            fields, jobs, shared, &err);
+        if (load_config != job->config)
+            bc_trie_free(load_config);
+        if (err != NULL) {
+            bc_error_print(err, "blogc");
+            rv = 1;
+            goto cleanup;
+        }
+
+        bc_slist_t *entries = NULL;
+        bc_slist_t *entries_tail = NULL;
+        if (job->listing) {
+            for (bc_slist_t *tmp = job->listing_entries; tmp != NULL; tmp = tmp->next) {
+                bc_trie_t *e = NULL;
+                if (0 != strlen(tmp->data)) {
+                    e = blogc_source_parse_from_file(job->config, tmp->data,
+                        fields, &err);
+                    if (err != NULL)
+                        break;
+                }
+                entries = bc_slist_append_tail(entries, &entries_tail, e);
+            }
+        }
+
+        blogc_template_t *l = bc_trie_lookup(templates, job->template);
+        if (err == NULL && job->group)
+            rv = blogc_render_tags(l, s, entries, job->config, job->output);
+        else if (err == NULL)
+            rv = blogc_render_output(l, s, entries, job->config, job->listing,
+                job->output);
+        else
+            bc_error_print(err, "blogc");
+
+        bc_slist_free(s);
+        bc_slist_free_full(entries, (bc_free_func_t) bc_trie_free);
+        if (err != NULL || rv != 0) {
+            rv = 1;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    for (i = 0; i < jobs_len; i++) {
+        bc_trie_free(mjobs[i].config);
+        free(mjobs[i].template);
+        free(mjobs[i].output);
+        bc_slist_free_full(mjobs[i].sources, free);
+        bc_slist_free_full(mjobs[i].listing_entries, free);
+    }
+    free(mjobs);
+    bc_trie_free(templates);
+    bc_trie_free(shared);
+    bc_slist_free_full(lines, (bc_free_func_t) bc_strv_free);
+    bc_error_free(err);
+    return rv;
+}
+
+
 int
 main(int argc, char **argv)
 {
     setlocale(LC_ALL, "");
 
+    if (bc_str_to_bool(getenv("BLOGC_ALLOC_STATS")))
+        bc_alloc_stats_enable(true);
+
     int rv = 0;
 
 #ifdef MAKE_EMBEDDED
@@ -136,15 +586,20 @@ main(int argc, char **argv)
     bool debug = false;
     bool input_stdin = false;
     bool listing = false;
+    bool group = false;
     char *template = NULL;
     char *output = NULL;
     char *print = NULL;
+    char *manifest = NULL;
     char *tmp = NULL;
-    char **pieces = NULL;
+    size_t jobs = 1;
 
     bc_slist_t *sources = NULL;
+    bc_slist_t *sources_tail = NULL;
     bc_slist_t *listing_entries = NULL;
+    bc_slist_t *listing_entries_tail = NULL;
     bc_slist_t *listing_entries_source = NULL;
+    bc_slist_t *listing_entries_source_tail = NULL;
     bc_trie_t *config = bc_trie_new(free);
     bc_trie_insert(config, "BLOGC_VERSION", bc_strdup(PACKAGE_VERSION));
 
@@ -167,11 +622,16 @@ main(int argc, char **argv)
                 case 'l':
                     listing = true;
                     break;
+                case 'g':
+                    group = true;
+                    break;
                 case 'e':
                     if (argv[i][2] != '\0')
-                        listing_entries = bc_slist_append(listing_entries, bc_strdup(argv[i] + 2));
+                        listing_entries = bc_slist_append_tail(listing_entries,
+                            &listing_entries_tail, bc_strdup(argv[i] + 2));
                     else if (i + 1 < argc)
-                        listing_entries = bc_slist_append(listing_entries, bc_strdup(argv[++i]));
+                        listing_entries = bc_slist_append_tail(listing_entries,
+                            &listing_entries_tail, bc_strdup(argv[++i]));
                     break;
                 case 't':
                     if (argv[i][2] != '\0')
@@ -191,53 +651,39 @@ main(int argc, char **argv)
                     else if (i + 1 < argc)
                         print = bc_strdup(argv[++i]);
                     break;
-                case 'D':
+                case 'j':
                     if (argv[i][2] != '\0')
                         tmp = argv[i] + 2;
                     else if (i + 1 < argc)
                         tmp = argv[++i];
                     if (tmp != NULL) {
-                        if (!bc_utf8_validate((uint8_t*) tmp, strlen(tmp))) {
+                        char *endptr;
+                        long j = strtol(tmp, &endptr, 10);
+                        if (*tmp == '\0' || *endptr != '\0' || j < 0) {
                             fprintf(stderr, "blogc: error: invalid value for "
-                                "-D (must be valid UTF-8 string): %s\n", tmp);
-                            goto cleanup;
-                        }
-                        pieces = bc_str_split(tmp, '=', 2);
-                        if (bc_strv_length(pieces) != 2) {
-                            fprintf(stderr, "blogc: error: invalid value for "
-                                "-D (must have an '='): %s\n", tmp);
-                            bc_strv_free(pieces);
+                                "-j (must be a non-negative integer): %s\n", tmp);
                             rv = 1;
                             goto cleanup;
                         }
-                        for (size_t j = 0; pieces[0][j] != '\0'; j++) {
-                            char c = pieces[0][j];
-                            if (j == 0) {
-                                if (!(c >= 'A' && c <= 'Z')) {
-                                    fprintf(stderr, "blogc: error: invalid value "
-                                        "for -D (first character in configuration "
-                                        "key must be uppercase): %s\n", pieces[0]);
-                                    bc_strv_free(pieces);
-                                    rv = 1;
-                                    goto cleanup;
-                                }
-                                continue;
-                            }
-                            if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) {
-                                fprintf(stderr, "blogc: error: invalid value "
-                                    "for -D (configuration key must be uppercase "
-                                    "with '_' and digits after first character): %s\n",
-                                    pieces[0]);
-                                bc_strv_free(pieces);
-                                rv = 1;
-                                goto cleanup;
-                            }
-                        }
-                        bc_trie_insert(config, pieces[0], bc_strdup(pieces[1]));
-                        bc_strv_free(pieces);
-                        pieces = NULL;
+                        jobs = j;
                     }
                     break;
+                case 'D':
+                    if (argv[i][2] != '\0')
+                        tmp = argv[i] + 2;
+                    else if (i + 1 < argc)
+                        tmp = argv[++i];
+                    if (tmp != NULL && !blogc_parse_define(config, tmp)) {
+                        rv = 1;
+                        goto cleanup;
+                    }
+                    break;
+                case 'M':
+                    if (argv[i][2] != '\0')
+                        manifest = bc_strdup(argv[i] + 2);
+                    else if (i + 1 < argc)
+                        manifest = bc_strdup(argv[++i]);
+                    break;
 #ifdef MAKE_EMBEDDED
                 case 'm':
                     embedded = true;
@@ -252,7 +698,7 @@ main(int argc, char **argv)
             }
         }
         else {
-            sources = bc_slist_append(sources, bc_strdup(argv[i]));
+            sources = bc_slist_append_tail(sources, &sources_tail, bc_strdup(argv[i]));
         }
 
 #ifdef MAKE_EMBEDDED
@@ -264,6 +710,27 @@ main(int argc, char **argv)
 
     }
 
+    if (jobs == 0)
+        jobs = blogc_cpu_count();
+
+    // allocation stats are not thread-safe.
+    if (bc_alloc_stats_enabled())
+        jobs = 1;
+
+    if (manifest != NULL) {
+        if (input_stdin || listing || group || template != NULL || output != NULL ||
+            print != NULL || sources != NULL || listing_entries != NULL)
+        {
+            blogc_print_usage();
+            fprintf(stderr, "blogc: error: -M can't be used with source files "
+                "or with -i, -l, -e, -g, -p, -t and -o\n");
+            rv = 1;
+            goto cleanup;
+        }
+        rv = blogc_run_manifest(manifest, config, jobs);
+        goto cleanup;
+    }
+
     if (input_stdin) {
         size_t input_len;
         char *input = bc_stdin_read(&input_len);
@@ -287,29 +754,70 @@ main(int argc, char **argv)
         goto cleanup;
     }
 
+    if (group && !listing) {
+        blogc_print_usage();
+        fprintf(stderr, "blogc: error: '-g' requires '-l'\n");
+        rv = 1;
+        goto cleanup;
+    }
+
     bc_error_t *err = NULL;
+    bc_slist_t *s = NULL;
+    blogc_template_t *l = NULL;
+
+    blogc_debug_alloc_stats_phase("arguments");
+
+    // the template is parsed before the sources, so we can skip computing
+    // source variables that are not used by it.
+    blogc_source_field_t fields = BLOGC_SOURCE_FIELD_ALL;
+    if (print == NULL && template != NULL) {
+        l = blogc_template_parse_from_file(template, &err);
+        if (err != NULL) {
+            bc_error_print(err, "blogc");
+            rv = 1;
+            goto cleanup2;
+        }
+        fields = blogc_get_source_fields(l);
+        blogc_debug_alloc_stats_phase("template");
+    }
 
-    bc_slist_t *s = blogc_source_parse_from_files(config, sources, &err);
+    if (group) {
+        bc_trie_t *load_config = bc_trie_new(free);
+        bc_trie_foreach(config, blogc_copy_unfiltered_variable, load_config);
+        s = blogc_source_parse_from_files(load_config, sources, fields, jobs,
+            NULL, &err);
+        bc_trie_free(load_config);
+    }
+    else {
+        s = blogc_source_parse_from_files(config, sources, fields, jobs, NULL,
+            &err);
+    }
     if (err != NULL) {
         bc_error_print(err, "blogc");
         rv = 1;
         goto cleanup2;
     }
 
+    blogc_debug_alloc_stats_phase("sources");
+
     if (listing) {
         for (bc_slist_t *tmp = listing_entries; tmp != NULL; tmp = tmp->next) {
             if (0 == strlen(tmp->data)) {
-                listing_entries_source = bc_slist_append(listing_entries_source, NULL);
+                listing_entries_source = bc_slist_append_tail(listing_entries_source,
+                    &listing_entries_source_tail, NULL);
                 continue;
             }
-            bc_trie_t *e = blogc_source_parse_from_file(config, tmp->data, &err);
+            bc_trie_t *e = blogc_source_parse_from_file(config, tmp->data,
+                fields, &err);
             if (err != NULL) {
                 bc_error_print(err, "blogc");
                 rv = 1;
                 goto cleanup2;
             }
-            listing_entries_source = bc_slist_append(listing_entries_source, e);
+            listing_entries_source = bc_slist_append_tail(listing_entries_source,
+                &listing_entries_source_tail, e);
         }
+        blogc_debug_alloc_stats_phase("listing entries");
     }
 
     if (print != NULL) {
@@ -337,43 +845,25 @@ main(int argc, char **argv)
         goto cleanup2;
     }
 
-    bc_slist_t* l = blogc_template_parse_from_file(template, &err);
-    if (err != NULL) {
-        bc_error_print(err, "blogc");
+    if (group && !blogc_output_has_placeholder(output, 't')) {
+        blogc_print_usage();
+        fprintf(stderr, "blogc: error: argument -o with '%%t' is required when "
+            "using '-g'\n");
         rv = 1;
-        goto cleanup3;
+        goto cleanup2;
     }
 
     if (debug)
         blogc_debug_template(l);
 
-    char *out = blogc_render(l, s, listing_entries_source, config, listing);
-
-    bool write_to_stdout = (output == NULL || (0 == strcmp(output, "-")));
-
-    FILE *fp = stdout;
-    if (!write_to_stdout) {
-        blogc_mkdir_recursive(output);
-        fp = fopen(output, "w");
-        if (fp == NULL) {
-            fprintf(stderr, "blogc: error: failed to open output file (%s): %s\n",
-                output, strerror(errno));
-            rv = 1;
-            goto cleanup4;
-        }
-    }
-
-    if (out != NULL)
-        fprintf(fp, "%s", out);
-
-    if (!write_to_stdout)
-        fclose(fp);
+    if (group)
+        rv = blogc_render_tags(l, s, listing_entries_source, config, output);
+    else
+        rv = blogc_render_output(l, s, listing_entries_source, config, listing,
+            output);
 
-cleanup4:
-    free(out);
-cleanup3:
-    blogc_template_free_ast(l);
 cleanup2:
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     bc_error_free(err);
 cleanup:
@@ -381,8 +871,11 @@ cleanup:
     free(template);
     free(output);
     free(print);
+    free(manifest);
     bc_slist_free_full(listing_entries, free);
     bc_slist_free_full(listing_entries_source, (bc_free_func_t) bc_trie_free);
     bc_slist_free_full(sources, free);
+    blogc_format_date_cache_free();
+    blogc_debug_alloc_stats();
     return rv;
 }
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "manifest-parser.h"
+#include "../common/error.h"
+#include "../common/utils.h"
+
+
+typedef enum {
+    LINE_START = 1,
+    ARGS,
+    ARG,
+    SINGLE_QUOTE,
+    DOUBLE_QUOTE,
+} blogc_manifest_parser_state_t;
+
+
+static bc_slist_t*
+append_job(bc_slist_t *jobs, bc_slist_t **jobs_tail, bc_slist_t *args)
+{
+    char **argv = bc_malloc((bc_slist_length(args) + 1) * sizeof(char*));
+    size_t i = 0;
+    for (bc_slist_t *tmp = args; tmp != NULL; tmp = tmp->next)
+        argv[i++] = tmp->data;
+    argv[i] = NULL;
+    bc_slist_free(args);
+    return bc_slist_append_tail(jobs, jobs_tail, argv);
+}
+
+
+bc_slist_t*
+blogc_manifest_parse(const char *src, size_t src_len, bc_error_t **err)
+{
+    if (err == NULL || *err != NULL)
+        return NULL;
+
+    size_t current = 0;
+    size_t quote_start = 0;
+    bc_slist_t *rv = NULL;
+    bc_slist_t *tail = NULL;
+    bc_slist_t *args = NULL;
+    bc_slist_t *args_tail = NULL;
+    bc_string_t *arg = NULL;
+    blogc_manifest_parser_state_t state = LINE_START;
+
+    while (current < src_len) {
+        char c = src[current];
+
+        // escaped line breaks join lines, like in the shell.
+        if ((state == ARGS || state == ARG) && c == '\\' &&
+            current + 1 < src_len && src[current + 1] == '\n')
+        {
+            current += 2;
+            continue;
+        }
+
+        switch (state) {
+
+            case LINE_START:
+                if (c == '#') {
+                    while (current + 1 < src_len && src[current + 1] != '\n')
+                        current++;
+                    break;
+                }
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                    break;
+                state = ARGS;
+                continue;
+
+            case ARGS:
+                if (c == '\r' || c == '\n') {
+                    rv = append_job(rv, &tail, args);
+                    args = NULL;
+                    args_tail = NULL;
+                    state = LINE_START;
+                    break;
+                }
+                if (c == ' ' || c == '\t')
+                    break;
+                arg = bc_string_new();
+                state = ARG;
+                continue;
+
+            case ARG:
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                    args = bc_slist_append_tail(args, &args_tail,
+                        bc_string_free(arg, false));
+                    arg = NULL;
+                    state = ARGS;
+                    continue;
+                }
+                if (c == '\'' || c == '"') {
+                    quote_start = current;
+                    state = c == '\'' ? SINGLE_QUOTE : DOUBLE_QUOTE;
+                    break;
+                }
+                if (c == '\\' && current + 1 < src_len)
+                    c = src[++current];
+                bc_string_append_c(arg, c);
+                break;
+
+            case SINGLE_QUOTE:
+                if (c == '\'') {
+                    state = ARG;
+                    break;
+                }
+                bc_string_append_c(arg, c);
+                break;
+
+            case DOUBLE_QUOTE:
+                if (c == '"') {
+                    state = ARG;
+                    break;
+                }
+                if (c == '\\' && current + 1 < src_len &&
+                    (src[current + 1] == '"' || src[current + 1] == '\\'))
+                {
+                    c = src[++current];
+                }
+                bc_string_append_c(arg, c);
+                break;
+
+        }
+
+        current++;
+    }
+
+    if (state == SINGLE_QUOTE || state == DOUBLE_QUOTE) {
+        *err = bc_error_parser(BLOGC_ERROR_MANIFEST_PARSER, src, src_len,
+            quote_start, "Found unterminated quote.");
+        bc_string_free(arg, true);
+        bc_slist_free_full(args, free);
+        bc_slist_free_full(rv, (bc_free_func_t) bc_strv_free);
+        return NULL;
+    }
+
+    if (arg != NULL)
+        args = bc_slist_append_tail(args, &args_tail, bc_string_free(arg, false));
+    if (args != NULL)
+        rv = append_job(rv, &tail, args);
+
+    return rv;
+}
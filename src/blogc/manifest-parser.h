@@ -0,0 +1,13 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <stddef.h>
+#include "../common/error.h"
+#include "../common/utils.h"
+
+// a manifest lists one blogc job per line, as command line arguments, with
+// shell-like quoting. returns a list of NULL-terminated string vectors.
+bc_slist_t* blogc_manifest_parse(const char *src, size_t src_len,
+    bc_error_t **err);
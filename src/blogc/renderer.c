@@ -29,23 +29,58 @@ blogc_get_variable(const char *name, bc_trie_t *global, bc_trie_t *local)
 }
 
 
-char*
-blogc_format_date(const char *date, bc_trie_t *global, bc_trie_t *local)
+// formatted dates are memoized per DATE_FORMAT and DATE value, because
+// listings and feeds format the same dates over and over again. rendering
+// is single-threaded, so the cache is process-wide.
+static bc_trie_t *date_cache = NULL;
+
+
+static const char*
+format_date(const char *date, bc_trie_t *global, bc_trie_t *local)
 {
     const char *date_format = blogc_get_variable("DATE_FORMAT", global, local);
-    if (date == NULL)
-        return NULL;
-    if (date_format == NULL)
-        return bc_strdup(date);
+    if (date == NULL || date_format == NULL)
+        return date;
+
+    if (date_cache == NULL)
+        date_cache = bc_trie_new((bc_free_func_t) bc_trie_free);
 
+    bc_trie_t *formatted = bc_trie_lookup(date_cache, date_format);
+    if (formatted == NULL) {
+        formatted = bc_trie_new(free);
+        bc_trie_insert(date_cache, date_format, formatted);
+    }
+
+    const char *rv = bc_trie_lookup(formatted, date);
+    if (rv != NULL)
+        return rv;
+
+    // failures are not cached, to warn every time an invalid date is used.
     bc_error_t *err = NULL;
-    char *rv = blogc_convert_datetime(date, date_format, &err);
+    char *tmp = blogc_convert_datetime(date, date_format, &err);
     if (err != NULL) {
         bc_error_print(err, "blogc");
         bc_error_free(err);
-        return bc_strdup(date);
+        return date;
     }
-    return rv;
+    bc_trie_insert(formatted, date, tmp);
+    return tmp;
+}
+
+
+char*
+blogc_format_date(const char *date, bc_trie_t *global, bc_trie_t *local)
+{
+    const char *rv = format_date(date, global, local);
+    return rv == NULL ? NULL : bc_strdup(rv);
+}
+
+
+void
+blogc_format_date_cache_free(void)
+{
+    bc_trie_free(date_cache);
+    date_cache = NULL;
 }
 
 
@@ -73,158 +108,171 @@ foreach_value_variable(const char *name, const char *item)
 }
 
 
-char*
-blogc_format_variable(const char *name, bc_trie_t *global, bc_trie_t *local,
-    const char *foreach_name, bc_slist_t *foreach_var)
+static const char*
+foreach_value(const char *foreach_name, bc_slist_t *foreach_var,
+    bc_trie_t *global, bc_trie_t *local)
 {
-    // if used asked for a variable that exists, just return it right away
-    const char *value = blogc_get_variable(name, global, local);
-    if (value != NULL)
-        return bc_strdup(value);
-
-    // do the same for special foreach variables
-    if (0 == strcmp(name, "FOREACH_ITEM")) {
-        if (foreach_var != NULL && foreach_var->data != NULL) {
-            return bc_strdup(foreach_var->data);
-        }
-        return NULL;
-    }
-    if (0 == strcmp(name, "FOREACH_VALUE")) {
-        if (foreach_name != NULL && foreach_var != NULL && foreach_var->data != NULL) {
-            char *value_var = foreach_value_variable(foreach_name, foreach_var->data);
-            if (value_var != NULL) {
-                value = blogc_get_variable(value_var, global, local);
-                free(value_var);
-                return bc_strdup(value);
-            }
-        }
-        return NULL;
+    const char *rv = NULL;
+    char *value_var = foreach_value_variable(foreach_name, foreach_var->data);
+    if (value_var != NULL) {
+        rv = blogc_get_variable(value_var, global, local);
+        free(value_var);
     }
+    return rv;
+}
 
-    char *var = bc_strdup(name);
 
-    size_t i;
-    size_t last = strlen(var);
+bc_strview_t
+blogc_get_operand(const blogc_template_operand_t *op, bc_trie_t *global,
+    bc_trie_t *local, const char *foreach_name, bc_slist_t *foreach_var)
+{
+    bc_strview_t rv = bc_strview(NULL);
 
-    long int len = -1;
+    if (op == NULL || op->name == NULL)
+        return rv;
 
-    // just walk till the last '_'
-    for (i = last - 1; i > 0 && var[i] >= '0' && var[i] <= '9'; i--);
+    if (op->literal)
+        return bc_strview(op->name);
 
-    if (var[i] == '_' && (i + 1) < last) {  // var ends with '_[0-9]+'
-        char *endptr;
-        len = strtol(var + i + 1, &endptr, 10);
-        if (*endptr != '\0') {
-            fprintf(stderr, "warning: invalid variable size for '%s', "
-                "ignoring.\n", var);
-            len = -1;
-        }
-        else {
-            var[i] = '\0';
-        }
-    }
+    // if used asked for a variable that exists, just return it right away
+    const char *value = blogc_get_variable(op->name, global, local);
+    if (value != NULL)
+        return bc_strview(value);
 
-    bool must_format = false;
+    bool has_item = foreach_var != NULL && foreach_var->data != NULL;
+    bool has_value = foreach_name != NULL && has_item;
 
-    if (bc_str_ends_with(var, "_FORMATTED")) {
-        var[strlen(var) - 10] = '\0';
-        must_format = true;
+    // do the same for special foreach variables
+    if (op->base == op->name && op->special != BLOGC_TEMPLATE_SPECIAL_NONE) {
+        if (op->special == BLOGC_TEMPLATE_SPECIAL_FOREACH_ITEM)
+            return has_item ? bc_strview(foreach_var->data) : rv;
+        if (!has_value)
+            return rv;
+        return bc_strview(foreach_value(foreach_name, foreach_var, global, local));
     }
 
-    if ((0 == strcmp(var, "FOREACH_ITEM")) &&
-        (foreach_var != NULL && foreach_var->data != NULL)) {
+    if (op->special == BLOGC_TEMPLATE_SPECIAL_FOREACH_ITEM && has_item) {
         value = foreach_var->data;
     }
-    else if ((0 == strcmp(var, "FOREACH_VALUE")) &&
-        (foreach_name != NULL && foreach_var != NULL && foreach_var->data != NULL)) {
-        char *value_var = foreach_value_variable(foreach_name, foreach_var->data);
-        if (value_var != NULL) {
-            value = blogc_get_variable(value_var, global, local);
-            free(value_var);
-        }
+    else if (op->special == BLOGC_TEMPLATE_SPECIAL_FOREACH_VALUE && has_value) {
+        value = foreach_value(foreach_name, foreach_var, global, local);
     }
     else {
-        blogc_funcvars_eval(global, var);
-        value = blogc_get_variable(var, global, local);
-    }
-
-    if (value == NULL) {
-        free(var);
-        return NULL;
+        // protect against evaluating the same function twice in the same
+        // global context
+        if (op->funcvar != NULL && global != NULL &&
+            NULL == bc_trie_lookup(global, op->base))
+        {
+            op->funcvar(global);
+        }
+        value = blogc_get_variable(op->base, global, local);
     }
 
-    char *rv = NULL;
+    if (value == NULL)
+        return rv;
 
-    if (must_format) {
-        if (bc_str_starts_with(name, "DATE_")) {
-            rv = blogc_format_date(value, global, local);
-        }
-        else {
+    switch (op->formatter) {
+        case BLOGC_TEMPLATE_FORMATTER_DATE:
+            value = format_date(value, global, local);
+            break;
+        case BLOGC_TEMPLATE_FORMATTER_UNKNOWN:
             fprintf(stderr, "warning: no formatter found for '%s', "
-                "ignoring.\n", var);
-            rv = bc_strdup(value);
-        }
-    }
-    else {
-        rv = bc_strdup(value);
+                "ignoring.\n", op->base);
+            break;
+        case BLOGC_TEMPLATE_FORMATTER_NONE:
+            break;
     }
 
-    free(var);
+    rv = bc_strview(value);
+    if (op->len > 0 && (size_t) op->len < rv.len)
+        rv.len = op->len;
+
+    return rv;
+}
+
+
+char*
+blogc_format_operand(const blogc_template_operand_t *op, bc_trie_t *global,
+    bc_trie_t *local, const char *foreach_name, bc_slist_t *foreach_var)
+{
+    return bc_strview_dup(blogc_get_operand(op, global, local, foreach_name,
+        foreach_var));
+}
 
-    if (len > 0) {
-        char *tmp = bc_strndup(rv, len);
-        free(rv);
-        rv = tmp;
-    }
 
+char*
+blogc_format_variable(const char *name, bc_trie_t *global, bc_trie_t *local,
+    const char *foreach_name, bc_slist_t *foreach_var)
+{
+    // templates decode their operands when parsed. this is for everyone else.
+    bc_arena_t *arena = bc_arena_new(0);
+    blogc_template_operand_t op;
+    blogc_template_parse_operand(arena, name, &op);
+    char *rv = blogc_format_operand(&op, global, local, foreach_name,
+        foreach_var);
+    bc_arena_free(arena);
     return rv;
 }
 
 
 bc_slist_t*
-blogc_split_list_variable(const char *name, bc_trie_t *global, bc_trie_t *local)
+blogc_split_list_variable(const char *name, bc_trie_t *global, bc_trie_t *local,
+    bc_arena_t *arena)
 {
+    if (arena == NULL)
+        return NULL;
+
     const char *value = blogc_get_variable(name, global, local);
     if (value == NULL)
         return NULL;
 
     bc_slist_t *rv = NULL;
+    bc_slist_t *last = NULL;
 
-    char **tmp = bc_str_split(value, ' ', 0);
-    for (size_t i = 0; tmp[i] != NULL; i++) {
-        if (tmp[i][0] != '\0')  // ignore empty strings
-            rv = bc_slist_append(rv, tmp[i]);
+    bc_strview_t iter = bc_strview(value);
+    bc_strview_t item;
+    while (bc_strview_split_next(&iter, ' ', &item)) {
+        if (item.len == 0)  // ignore empty strings
+            continue;
+        bc_slist_t *l = bc_arena_alloc(arena, sizeof(bc_slist_t));
+        l->next = NULL;
+        l->data = bc_arena_strndup(arena, item.str, item.len);
+        if (last == NULL)
+            rv = l;
         else
-            free(tmp[i]);
+            last->next = l;
+        last = l;
     }
-    free(tmp);
 
     return rv;
 }
 
 
-char*
-blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
-    bc_trie_t *config, bool listing)
+void
+blogc_render_to(blogc_template_t *template, bc_slist_t *sources,
+    bc_slist_t *listing_entries, bc_trie_t *config, bool listing,
+    blogc_render_func_t func, void *user_data)
 {
-    if (tmpl == NULL)
-        return NULL;
+    if (template == NULL || func == NULL)
+        return;
+
+    blogc_template_node_t *nodes = template->nodes;
+    blogc_template_node_t *nodes_end = nodes + template->nodes_len;
 
     bc_slist_t *current_source = NULL;
-    bc_slist_t *listing_start = NULL;
+    blogc_template_node_t *listing_start = NULL;
 
-    bc_string_t *str = bc_string_new();
+    // scratch memory for the lists iterated by 'foreach' statements. released
+    // at once when rendering is done.
+    bc_arena_t *arena = bc_arena_new(0);
 
     bc_trie_t *tmp_source = NULL;
-    char *config_value = NULL;
-    char *defined = NULL;
-
-    size_t if_count = 0;
+    bc_strview_t value;
 
-    char *foreach_name = NULL;
+    const char *foreach_name = NULL;
     bc_slist_t *foreach_var = NULL;
     bc_slist_t *foreach_var_start = NULL;
-    bc_slist_t *foreach_start = NULL;
+    blogc_template_node_t *foreach_start = NULL;
 
     bool if_not = false;
     bool inside_block = false;
@@ -233,30 +281,26 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
 
     int cmp = 0;
 
-    bc_slist_t *tmp = tmpl;
+    blogc_template_node_t *tmp = nodes;
     bc_slist_t *current_listing_entry = listing_entries;
-    while (tmp != NULL) {
-        blogc_template_node_t *node = tmp->data;
+    while (tmp < nodes_end) {
+        blogc_template_node_t *node = tmp;
 
         switch (node->type) {
 
             case BLOGC_TEMPLATE_NODE_CONTENT:
                 if (node->data[0] != NULL)
-                    bc_string_append(str, node->data[0]);
+                    func(node->data[0], strlen(node->data[0]), user_data);
                 break;
 
             case BLOGC_TEMPLATE_NODE_BLOCK:
                 inside_block = true;
-                if_count = 0;
                 if (0 == strcmp("entry", node->data[0])) {
                     if (listing) {
 
-                        // we can just skip anything and walk until the next
+                        // we can just skip anything and jump to the
                         // 'endblock'
-                        while (node->type != BLOGC_TEMPLATE_NODE_ENDBLOCK) {
-                            tmp = tmp->next;
-                            node = tmp->data;
-                        }
+                        tmp = nodes + node->jump;
                         break;
                     }
                     current_source = sources;
@@ -269,12 +313,9 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
                         current_listing_entry = current_listing_entry->next;
                     }
                     if (listing_entry == NULL || !listing) {
-                        // we can just skip anything and walk until the next
+                        // we can just skip anything and jump to the
                         // 'endblock'
-                        while (node->type != BLOGC_TEMPLATE_NODE_ENDBLOCK) {
-                            tmp = tmp->next;
-                            node = tmp->data;
-                        }
+                        tmp = nodes + node->jump;
                         break;
                     }
                     current_source = NULL;
@@ -285,36 +326,27 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
                          (0 == strcmp("listing_once", node->data[0]))) {
                     if (!listing) {
 
-                        // we can just skip anything and walk until the next
+                        // we can just skip anything and jump to the
                         // 'endblock'
-                        while (node->type != BLOGC_TEMPLATE_NODE_ENDBLOCK) {
-                            tmp = tmp->next;
-                            node = tmp->data;
-                        }
+                        tmp = nodes + node->jump;
                         break;
                     }
                 }
                 if (0 == strcmp("listing_empty", node->data[0])) {
                     if (sources != NULL) {
 
-                        // we can just skip anything and walk until the next
+                        // we can just skip anything and jump to the
                         // 'endblock'
-                        while (node->type != BLOGC_TEMPLATE_NODE_ENDBLOCK) {
-                            tmp = tmp->next;
-                            node = tmp->data;
-                        }
+                        tmp = nodes + node->jump;
                         break;
                     }
                 }
                 if (0 == strcmp("listing", node->data[0])) {
                     if (sources == NULL) {
 
-                        // we can just skip anything and walk until the next
+                        // we can just skip anything and jump to the
                         // 'endblock'
-                        while (node->type != BLOGC_TEMPLATE_NODE_ENDBLOCK) {
-                            tmp = tmp->next;
-                            node = tmp->data;
-                        }
+                        tmp = nodes + node->jump;
                         break;
                     }
                     if (current_source == NULL) {
@@ -326,16 +358,10 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
                 break;
 
             case BLOGC_TEMPLATE_NODE_VARIABLE:
-                if (node->data[0] != NULL) {
-                    config_value = blogc_format_variable(node->data[0],
-                        config, inside_block ? tmp_source : NULL, foreach_name, foreach_var);
-                    if (config_value != NULL) {
-                        bc_string_append(str, config_value);
-                        free(config_value);
-                        config_value = NULL;
-                        break;
-                    }
-                }
+                value = blogc_get_operand(&node->operands[0], config,
+                    inside_block ? tmp_source : NULL, foreach_name, foreach_var);
+                if (value.str != NULL && value.len > 0)
+                    func(value.str, value.len, user_data);
                 break;
 
             case BLOGC_TEMPLATE_NODE_ENDBLOCK:
@@ -356,34 +382,18 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
 
             case BLOGC_TEMPLATE_NODE_IF:
             case BLOGC_TEMPLATE_NODE_IFDEF:
-                if_count = 0;
-                defined = NULL;
-                if (node->data[0] != NULL)
-                    defined = blogc_format_variable(node->data[0], config,
-                        inside_block ? tmp_source : NULL, foreach_name, foreach_var);
+                value = blogc_get_operand(&node->operands[0], config,
+                    inside_block ? tmp_source : NULL, foreach_name, foreach_var);
                 evaluate = false;
                 if (node->op != 0) {
-                    // Strings that start with a '"' are actually strings, the
-                    // others are meant to be looked up as a second variable
-                    // check.
-                    char *defined2 = NULL;
-                    if (node->data[1] != NULL) {
-                        if ((strlen(node->data[1]) >= 2) &&
-                            (node->data[1][0] == '"') &&
-                            (node->data[1][strlen(node->data[1]) - 1] == '"'))
-                        {
-                            defined2 = bc_strndup(node->data[1] + 1,
-                                strlen(node->data[1]) - 2);
-                        }
-                        else {
-                            defined2 = blogc_format_variable(node->data[1],
-                                config, inside_block ? tmp_source : NULL,
-                                foreach_name, foreach_var);
-                        }
-                    }
-
-                    if (defined != NULL && defined2 != NULL) {
-                        cmp = strcmp(defined, defined2);
+                    // literal strings are compared as they are, the others
+                    // are meant to be looked up as a second variable check.
+                    bc_strview_t value2 = blogc_get_operand(&node->operands[1],
+                        config, inside_block ? tmp_source : NULL, foreach_name,
+                        foreach_var);
+
+                    if (value.str != NULL && value2.str != NULL) {
+                        cmp = bc_strview_compare(value, value2);
                         if (cmp != 0 && node->op & BLOGC_TEMPLATE_OP_NEQ)
                             evaluate = true;
                         else if (cmp == 0 && node->op & BLOGC_TEMPLATE_OP_EQ)
@@ -393,85 +403,39 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
                         else if (cmp > 0 && node->op & BLOGC_TEMPLATE_OP_GT)
                             evaluate = true;
                     }
-
-                    free(defined2);
                 }
                 else {
-                    if (if_not && defined == NULL)
+                    if (if_not && value.str == NULL)
                         evaluate = true;
-                    if (!if_not && defined != NULL)
+                    if (!if_not && value.str != NULL)
                         evaluate = true;
                 }
                 if (!evaluate) {
 
-                    // at this point we can just skip anything, counting the
-                    // number of 'if's, to know how many 'endif's we need to
-                    // skip as well.
-                    while (1) {
-                        tmp = tmp->next;
-                        node = tmp->data;
-                        if ((node->type == BLOGC_TEMPLATE_NODE_IF) ||
-                            (node->type == BLOGC_TEMPLATE_NODE_IFDEF) ||
-                            (node->type == BLOGC_TEMPLATE_NODE_IFNDEF))
-                        {
-                            if_count++;
-                            continue;
-                        }
-                        if ((node->type == BLOGC_TEMPLATE_NODE_ELSE) &&
-                            (if_count == 0))
-                        {
-                            // this is somewhat complex. only an else statement
-                            // right after a non evaluated block should be considered
-                            // valid, because all the inner conditionals were just
-                            // skipped, and all the outter conditionals evaluated
-                            // to true.
-                            valid_else = true;
-                            break;
-                        }
-                        if (node->type == BLOGC_TEMPLATE_NODE_ENDIF) {
-                            if (if_count > 0) {
-                                if_count--;
-                                continue;
-                            }
-                            break;
-                        }
+                    // at this point we can just skip anything, and jump to the
+                    // 'else' or 'endif' resolved by the parser.
+                    tmp = nodes + node->jump;
+                    if (tmp->type == BLOGC_TEMPLATE_NODE_ELSE) {
+                        // this is somewhat complex. only an else statement
+                        // right after a non evaluated block should be considered
+                        // valid, because all the inner conditionals were just
+                        // skipped, and all the outter conditionals evaluated
+                        // to true.
+                        valid_else = true;
                     }
                 }
                 else {
                     valid_else = false;
                 }
-                free(defined);
-                defined = NULL;
                 if_not = false;
                 break;
 
             case BLOGC_TEMPLATE_NODE_ELSE:
-                if_count = 0;
                 if (!valid_else) {
 
-                    // at this point we can just skip anything, counting the
-                    // number of 'if's, to know how many 'endif's we need to
-                    // skip as well.
-                    while (1) {
-                        tmp = tmp->next;
-                        node = tmp->data;
-                        if ((node->type == BLOGC_TEMPLATE_NODE_IF) ||
-                            (node->type == BLOGC_TEMPLATE_NODE_IFDEF) ||
-                            (node->type == BLOGC_TEMPLATE_NODE_IFNDEF))
-                        {
-                            if_count++;
-                            continue;
-                        }
-                        // no need to handle else statements here, because every
-                        // if should have an endif.
-                        if (node->type == BLOGC_TEMPLATE_NODE_ENDIF) {
-                            if (if_count > 0) {
-                                if_count--;
-                                continue;
-                            }
-                            break;
-                        }
-                    }
+                    // at this point we can just skip anything, and jump to the
+                    // 'endif'.
+                    tmp = nodes + node->jump;
                 }
                 valid_else = false;
                 break;
@@ -480,36 +444,31 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
                 // any endif statement should invalidate valid_else, to avoid
                 // propagation to outter conditionals.
                 valid_else = false;
-                if (if_count > 0)
-                    if_count--;
                 break;
 
             case BLOGC_TEMPLATE_NODE_FOREACH:
                 if (foreach_var_start == NULL) {
                     if (node->data[0] != NULL)
                         foreach_var_start = blogc_split_list_variable(node->data[0],
-                            config, inside_block ? tmp_source : NULL);
+                            config, inside_block ? tmp_source : NULL, arena);
 
                     if (foreach_var_start != NULL) {
-                        foreach_name = bc_strdup(node->data[0]);
+                        foreach_name = node->data[0];
                         foreach_var = foreach_var_start;
                         foreach_start = tmp;
                     }
                     else {
 
-                        // we can just skip anything and walk until the next
+                        // we can just skip anything and jump to the
                         // 'endforeach'
-                        while (node->type != BLOGC_TEMPLATE_NODE_ENDFOREACH) {
-                            tmp = tmp->next;
-                            node = tmp->data;
-                        }
+                        tmp = nodes + node->jump;
                         break;
                     }
                 }
 
                 if (foreach_var == NULL) {
                     foreach_start = tmp;
-                    foreach_name = bc_strdup(node->data[0]);
+                    foreach_name = node->data[0];
                     foreach_var = foreach_var_start;
                 }
                 break;
@@ -523,17 +482,45 @@ blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
                     }
                 }
                 foreach_start = NULL;
-                bc_slist_free_full(foreach_var_start, free);
                 foreach_var_start = NULL;
-                free(foreach_name);
                 foreach_name = NULL;
                 break;
         }
-        tmp = tmp->next;
+        tmp++;
     }
 
     // no need to free temporary variables here. the template parser makes sure
     // that templates are sane and statements are closed.
 
+    bc_arena_free(arena);
+}
+
+
+static void
+render_string_append(const char *str, size_t len, void *user_data)
+{
+    bc_string_append_len(user_data, str, len);
+}
+
+
+char*
+blogc_render(blogc_template_t *template, bc_slist_t *sources,
+    bc_slist_t *listing_entries, bc_trie_t *config, bool listing)
+{
+    if (template == NULL)
+        return NULL;
+
+    // the static parts of the template are a good lower bound for the size of
+    // the output.
+    size_t content_len = 0;
+    for (size_t i = 0; i < template->nodes_len; i++) {
+        blogc_template_node_t *node = template->nodes + i;
+        if (node->type == BLOGC_TEMPLATE_NODE_CONTENT && node->data[0] != NULL)
+            content_len += strlen(node->data[0]);
+    }
+
+    bc_string_t *str = bc_string_new_sized(content_len);
+    blogc_render_to(template, sources, listing_entries, config, listing,
+        render_string_append, str);
     return bc_string_free(str, false);
 }
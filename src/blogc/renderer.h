@@ -4,13 +4,30 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include "../common/arena.h"
 #include "../common/utils.h"
+#include "template-parser.h"
 
 const char* blogc_get_variable(const char *name, bc_trie_t *global, bc_trie_t *local);
 char* blogc_format_date(const char *date, bc_trie_t *global, bc_trie_t *local);
+void blogc_format_date_cache_free(void);
+// the returned view borrows the variable value (or a memoized formatted
+// value), nothing must be freed by the caller.
+bc_strview_t blogc_get_operand(const blogc_template_operand_t *op,
+    bc_trie_t *global, bc_trie_t *local, const char *foreach_name,
+    bc_slist_t *foreach_var);
+char* blogc_format_operand(const blogc_template_operand_t *op, bc_trie_t *global,
+    bc_trie_t *local, const char *foreach_name, bc_slist_t *foreach_var);
 char* blogc_format_variable(const char *name, bc_trie_t *global, bc_trie_t *local,
     const char *foreach_name, bc_slist_t *foreach_var);
 bc_slist_t* blogc_split_list_variable(const char *name, bc_trie_t *global,
-    bc_trie_t *local);
-char* blogc_render(bc_slist_t *tmpl, bc_slist_t *sources, bc_slist_t *listing_entries,
-    bc_trie_t *config, bool listing);
+    bc_trie_t *local, bc_arena_t *arena);
+typedef void (*blogc_render_func_t) (const char *str, size_t len,
+    void *user_data);
+
+void blogc_render_to(blogc_template_t *template, bc_slist_t *sources,
+    bc_slist_t *listing_entries, bc_trie_t *config, bool listing,
+    blogc_render_func_t func, void *user_data);
+char* blogc_render(blogc_template_t *template, bc_slist_t *sources,
+    bc_slist_t *listing_entries, bc_trie_t *config, bool listing);
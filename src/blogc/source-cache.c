@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "source-cache.h"
+#include "source-parser.h"
+#include "../common/file.h"
+#include "../common/utils.h"
+
+
+uint64_t
+blogc_source_cache_hash(const char *src, size_t src_len, int toctree_maxdepth,
+    blogc_source_field_t fields)
+{
+    uint64_t hash = blogc_cache_hash_init("source");
+    hash = blogc_cache_hash(hash, &toctree_maxdepth, sizeof(toctree_maxdepth));
+    hash = blogc_cache_hash(hash, &fields, sizeof(fields));
+    return blogc_cache_hash(hash, src, src_len);
+}
+
+
+static bc_trie_t*
+load_entries(const char *str, size_t len, uint64_t hash, size_t src_len)
+{
+    blogc_source_cache_header_t header;
+    if (len < sizeof(header))
+        return NULL;
+    memcpy(&header, str, sizeof(header));
+    if (0 != memcmp(header.magic, BLOGC_SOURCE_CACHE_MAGIC, sizeof(header.magic)) ||
+        header.hash != hash || header.src_len != src_len)
+        return NULL;
+
+    bc_trie_t *rv = bc_trie_new(free);
+    size_t pos = sizeof(header);
+    for (size_t i = 0; i < header.count; i++) {
+        uint32_t lens[2];
+        if (len - pos < sizeof(lens))
+            goto invalid;
+        memcpy(lens, str + pos, sizeof(lens));
+        pos += sizeof(lens);
+
+        // both strings are NUL-terminated in the file.
+        if (len - pos < (size_t) lens[0] + lens[1] + 2)
+            goto invalid;
+        const char *key = str + pos;
+        const char *value = key + lens[0] + 1;
+        if (key[lens[0]] != '\0' || value[lens[1]] != '\0')
+            goto invalid;
+        pos += (size_t) lens[0] + lens[1] + 2;
+
+        bc_trie_insert(rv, key, bc_strndup(value, lens[1]));
+    }
+    if (pos != len)
+        goto invalid;
+
+    return rv;
+
+invalid:
+    bc_trie_free(rv);
+    return NULL;
+}
+
+
+bc_trie_t*
+blogc_source_cache_get(const char *dir, const char *src, size_t src_len,
+    int toctree_maxdepth, blogc_source_field_t fields)
+{
+    if (dir == NULL || src == NULL)
+        return NULL;
+
+    uint64_t hash = blogc_source_cache_hash(src, src_len, toctree_maxdepth, fields);
+
+    // a missing or broken entry is just a cache miss.
+    bc_file_map_t *m = blogc_cache_map(dir, hash);
+    if (m == NULL)
+        return NULL;
+
+    bc_trie_t *rv = load_entries(m->str, m->len, hash, src_len);
+    bc_file_unmap(m);
+    return rv;
+}
+
+
+static void
+write_entry(const char *key, void *value, void *user_data)
+{
+    uint32_t lens[2] = {strlen(key), strlen(value)};
+    bc_file_writer_write(user_data, (const char*) lens, sizeof(lens));
+    bc_file_writer_write(user_data, key, lens[0] + 1);
+    bc_file_writer_write(user_data, value, lens[1] + 1);
+}
+
+
+bool
+blogc_source_cache_put(const char *dir, const char *src, size_t src_len,
+    int toctree_maxdepth, blogc_source_field_t fields, bc_trie_t *source)
+{
+    if (dir == NULL || src == NULL || source == NULL)
+        return false;
+
+    char *tmp_path = NULL;
+    bc_file_writer_t *w = blogc_cache_writer_new(dir, &tmp_path);
+    if (w == NULL)
+        return false;
+
+    blogc_source_cache_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BLOGC_SOURCE_CACHE_MAGIC, sizeof(header.magic));
+    header.hash = blogc_source_cache_hash(src, src_len, toctree_maxdepth, fields);
+    header.src_len = src_len;
+    header.count = bc_trie_size(source);
+
+    bc_file_writer_write(w, (const char*) &header, sizeof(header));
+    bc_trie_foreach(source, write_entry, w);
+
+    return blogc_cache_writer_commit(dir, header.hash, w, tmp_path);
+}
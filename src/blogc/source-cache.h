@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../common/utils.h"
+#include "source-parser.h"
+
+// on-disk cache of parsed sources, keyed by the hash of the source content
+// and of everything else that changes the parser output. the file has a fixed
+// header, followed by key/value pairs, each prefixed by their lengths and
+// NUL-terminated, so it can be loaded from a memory map without any parsing.
+#define BLOGC_SOURCE_CACHE_MAGIC "BLOGCSC\1"
+
+typedef struct {
+    char magic[8];
+    uint64_t hash;
+    uint64_t src_len;
+    uint32_t count;
+    uint32_t reserved;
+} blogc_source_cache_header_t;
+
+uint64_t blogc_source_cache_hash(const char *src, size_t src_len,
+    int toctree_maxdepth, blogc_source_field_t fields);
+bc_trie_t* blogc_source_cache_get(const char *dir, const char *src,
+    size_t src_len, int toctree_maxdepth, blogc_source_field_t fields);
+bool blogc_source_cache_put(const char *dir, const char *src, size_t src_len,
+    int toctree_maxdepth, blogc_source_field_t fields, bc_trie_t *source);
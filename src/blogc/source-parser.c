@@ -23,8 +23,8 @@ typedef enum {
 
 
 bc_trie_t*
-blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
-    bc_error_t **err)
+blogc_source_parse_fields(const char *src, size_t src_len, int toctree_maxdepth,
+    blogc_source_field_t fields, bc_error_t **err)
 {
     if (err == NULL || *err != NULL)
         return NULL;
@@ -146,15 +146,27 @@ blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
 
             case SOURCE_CONTENT:
                 if (current == (src_len - 1)) {
-                    tmp = bc_strndup(src + start, src_len - start);
-                    bc_trie_insert(rv, "RAW_CONTENT", tmp);
+                    // the content parser is the expensive part of the source
+                    // parser, and is only needed for some variables.
+                    bool raw_content = fields & BLOGC_SOURCE_FIELD_RAW_CONTENT;
+                    bool parse_content = fields & (BLOGC_SOURCE_FIELD_CONTENT |
+                        BLOGC_SOURCE_FIELD_EXCERPT | BLOGC_SOURCE_FIELD_TOCTREE);
+                    if (!raw_content && !parse_content)
+                        break;
+                    if (raw_content)
+                        bc_trie_insert(rv, "RAW_CONTENT",
+                            bc_strndup(src + start, src_len - start));
+                    if (!parse_content)
+                        break;
                     char *first_header = NULL;
                     char *description = NULL;
                     char *endl = NULL;
                     bc_slist_t *headers = NULL;
-                    bool read_headers = (NULL == bc_trie_lookup(rv, "TOCTREE"));
-                    content = blogc_content_parse(tmp, &end_excerpt,
-                        &first_header, &description, &endl, read_headers ? &headers : NULL);
+                    bool read_headers = (fields & BLOGC_SOURCE_FIELD_TOCTREE) &&
+                        (NULL == bc_trie_lookup(rv, "TOCTREE"));
+                    content = blogc_content_parse_len(src + start,
+                        src_len - start, &end_excerpt, &first_header,
+                        &description, &endl, read_headers ? &headers : NULL);
                     if (first_header != NULL) {
                         // do not override source-provided first_header.
                         if (NULL == bc_trie_lookup(rv, "FIRST_HEADER")) {
@@ -203,8 +215,9 @@ blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
                     }
                     free(endl);
                     bc_trie_insert(rv, "CONTENT", content);
-                    bc_trie_insert(rv, "EXCERPT", end_excerpt == 0 ?
-                        bc_strdup(content) : bc_strndup(content, end_excerpt));
+                    if (fields & BLOGC_SOURCE_FIELD_EXCERPT)
+                        bc_trie_insert(rv, "EXCERPT", end_excerpt == 0 ?
+                            bc_strdup(content) : bc_strndup(content, end_excerpt));
                 }
                 break;
         }
@@ -212,6 +225,10 @@ blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
         if (*err != NULL)
             break;
 
+        // headers only, no need to look at the content.
+        if (state == SOURCE_CONTENT_START && fields == 0)
+            break;
+
         current++;
     }
 
@@ -255,3 +272,12 @@ blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
 
     return rv;
 }
+
+
+bc_trie_t*
+blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
+    bc_error_t **err)
+{
+    return blogc_source_parse_fields(src, src_len, toctree_maxdepth,
+        BLOGC_SOURCE_FIELD_ALL, err);
+}
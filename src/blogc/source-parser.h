@@ -7,5 +7,18 @@
 #include "../common/error.h"
 #include "../common/utils.h"
 
+// variables that are expensive to compute from the source content, and can be
+// skipped if no template is going to use them. CONTENT also covers
+// FIRST_HEADER and DESCRIPTION, that are extracted by the content parser.
+typedef enum {
+    BLOGC_SOURCE_FIELD_RAW_CONTENT = 1 << 0,
+    BLOGC_SOURCE_FIELD_CONTENT     = 1 << 1,
+    BLOGC_SOURCE_FIELD_EXCERPT     = 1 << 2,
+    BLOGC_SOURCE_FIELD_TOCTREE     = 1 << 3,
+    BLOGC_SOURCE_FIELD_ALL         = (1 << 4) - 1,
+} blogc_source_field_t;
+
+bc_trie_t* blogc_source_parse_fields(const char *src, size_t src_len,
+    int toctree_maxdepth, blogc_source_field_t fields, bc_error_t **err);
 bc_trie_t* blogc_source_parse(const char *src, size_t src_len, int toctree_maxdepth,
     bc_error_t **err);
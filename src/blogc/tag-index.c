@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "../common/utils.h"
+#include "tag-index.h"
+
+
+static void
+free_posting(blogc_tag_posting_t *p)
+{
+    if (p == NULL)
+        return;
+    free(p->tag);
+    free(p->sources);
+    free(p);
+}
+
+
+static blogc_tag_posting_t*
+new_posting(blogc_tag_index_t *index, const char *tag)
+{
+    blogc_tag_posting_t *p = bc_malloc(sizeof(blogc_tag_posting_t));
+    p->tag = bc_strdup(tag);
+    p->sources = NULL;
+    p->sources_len = 0;
+    p->sources_allocated = 0;
+    bc_trie_insert(index->postings, tag, p);
+
+    if (index->tags_len == index->tags_allocated) {
+        index->tags_allocated = index->tags_allocated == 0 ? 16 :
+            index->tags_allocated * 2;
+        index->tags = bc_realloc(index->tags,
+            index->tags_allocated * sizeof(blogc_tag_posting_t*));
+    }
+    index->tags[index->tags_len++] = p;
+    return p;
+}
+
+
+blogc_tag_index_t*
+blogc_tag_index_new(bc_trie_t **sources, size_t sources_len)
+{
+    blogc_tag_index_t *rv = bc_malloc(sizeof(blogc_tag_index_t));
+    rv->postings = bc_trie_new((bc_free_func_t) free_posting);
+    rv->tags = NULL;
+    rv->tags_len = 0;
+    rv->tags_allocated = 0;
+
+    // the key buffer is reused, tags are only copied once, when they are
+    // first seen.
+    bc_string_t *key = bc_string_new();
+
+    for (size_t i = 0; i < sources_len; i++) {
+        const char *tags_str = bc_trie_lookup(sources[i], "TAGS");
+        if (tags_str == NULL)
+            continue;
+        bc_strview_t iter = bc_strview(tags_str);
+        bc_strview_t tag;
+        while (bc_strview_split_next(&iter, ' ', &tag)) {
+            if (tag.len == 0)
+                continue;
+            key->len = 0;
+            bc_string_append_len(key, tag.str, tag.len);
+
+            blogc_tag_posting_t *p = bc_trie_lookup(rv->postings, key->str);
+            if (p == NULL)
+                p = new_posting(rv, key->str);
+
+            // sources are visited in order, so postings are sorted, and a tag
+            // repeated in the same source is only listed once.
+            if (p->sources_len > 0 && p->sources[p->sources_len - 1] == i)
+                continue;
+            if (p->sources_len == p->sources_allocated) {
+                p->sources_allocated = p->sources_allocated == 0 ? 8 :
+                    p->sources_allocated * 2;
+                p->sources = bc_realloc(p->sources,
+                    p->sources_allocated * sizeof(size_t));
+            }
+            p->sources[p->sources_len++] = i;
+        }
+    }
+
+    bc_string_free(key, true);
+    return rv;
+}
+
+
+blogc_tag_posting_t*
+blogc_tag_index_lookup(blogc_tag_index_t *index, const char *tag)
+{
+    if (index == NULL || tag == NULL)
+        return NULL;
+    return bc_trie_lookup(index->postings, tag);
+}
+
+
+void
+blogc_tag_index_free(blogc_tag_index_t *index)
+{
+    if (index == NULL)
+        return;
+    bc_trie_free(index->postings);
+    free(index->tags);
+    free(index);
+}
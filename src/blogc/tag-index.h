@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <stddef.h>
+#include "../common/utils.h"
+
+// positions of the sources listing a tag, in ascending order.
+typedef struct {
+    char *tag;
+    size_t *sources;
+    size_t sources_len;
+    size_t sources_allocated;
+} blogc_tag_posting_t;
+
+// inverted index of the TAGS of a list of sources, built in a single pass.
+// tags are kept in order of first appearance.
+typedef struct {
+    bc_trie_t *postings;
+    blogc_tag_posting_t **tags;
+    size_t tags_len;
+    size_t tags_allocated;
+} blogc_tag_index_t;
+
+blogc_tag_index_t* blogc_tag_index_new(bc_trie_t **sources, size_t sources_len);
+blogc_tag_posting_t* blogc_tag_index_lookup(blogc_tag_index_t *index,
+    const char *tag);
+void blogc_tag_index_free(blogc_tag_index_t *index);
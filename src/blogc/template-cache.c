@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "template-cache.h"
+#include "template-parser.h"
+#include "../common/arena.h"
+#include "../common/file.h"
+#include "../common/utils.h"
+
+
+uint64_t
+blogc_template_cache_hash(const char *src, size_t src_len)
+{
+    uint64_t hash = blogc_cache_hash_init("template");
+    return blogc_cache_hash(hash, src, src_len);
+}
+
+
+static bool
+valid_jumps(const blogc_template_node_t *nodes, size_t nodes_len)
+{
+    // the renderer trusts the jumps, so they must be exactly what the parser
+    // would resolve for balanced statements, otherwise it could loop forever.
+    size_t *stack = bc_malloc((nodes_len + 1) * sizeof(size_t));
+    size_t stack_len = 0;
+    size_t block = 0;
+    size_t foreach = 0;
+    size_t target;
+    bool inside_block = false;
+    bool inside_foreach = false;
+    bool rv = false;
+
+    for (size_t i = 0; i < nodes_len; i++) {
+        const blogc_template_node_t *node = nodes + i;
+        switch (node->type) {
+            case BLOGC_TEMPLATE_NODE_IFDEF:
+            case BLOGC_TEMPLATE_NODE_IFNDEF:
+            case BLOGC_TEMPLATE_NODE_IF:
+                stack[stack_len++] = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ELSE:
+                if (stack_len == 0)
+                    goto end;
+                stack[stack_len++] = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ENDIF:
+                // a false conditional jumps to its first 'else', the 'else'
+                // statements jump to the 'endif'.
+                target = i;
+                while (stack_len > 0 &&
+                    nodes[stack[stack_len - 1]].type == BLOGC_TEMPLATE_NODE_ELSE)
+                {
+                    if (nodes[stack[stack_len - 1]].jump != i)
+                        goto end;
+                    target = stack[--stack_len];
+                }
+                if (stack_len == 0)
+                    goto end;
+                stack_len--;
+                if (nodes[stack[stack_len]].jump != target ||
+                    node->jump != stack[stack_len])
+                    goto end;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_BLOCK:
+                if (inside_block)
+                    goto end;
+                inside_block = true;
+                block = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ENDBLOCK:
+                if (!inside_block || nodes[block].jump != i || node->jump != block)
+                    goto end;
+                inside_block = false;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_FOREACH:
+                if (inside_foreach)
+                    goto end;
+                inside_foreach = true;
+                foreach = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ENDFOREACH:
+                if (!inside_foreach || nodes[foreach].jump != i ||
+                    node->jump != foreach)
+                    goto end;
+                inside_foreach = false;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_VARIABLE:
+            case BLOGC_TEMPLATE_NODE_CONTENT:
+                break;
+        }
+    }
+    rv = stack_len == 0 && !inside_block && !inside_foreach;
+
+end:
+    free(stack);
+    return rv;
+}
+
+
+static blogc_template_t*
+load_nodes(const char *str, size_t len, uint64_t hash, size_t src_len)
+{
+    blogc_template_cache_header_t header;
+    if (len < sizeof(header))
+        return NULL;
+    memcpy(&header, str, sizeof(header));
+    size_t max_nodes = (len - sizeof(header)) / sizeof(blogc_template_cache_node_t);
+    if (0 != memcmp(header.magic, BLOGC_TEMPLATE_CACHE_MAGIC, sizeof(header.magic)) ||
+        header.hash != hash || header.src_len != src_len ||
+        header.nodes_len > max_nodes ||
+        header.blob_len != len - sizeof(header) -
+            header.nodes_len * sizeof(blogc_template_cache_node_t))
+        return NULL;
+
+    const char *blob_src = str + len - header.blob_len;
+    if (header.blob_len > 0 && blob_src[header.blob_len - 1] != '\0')
+        return NULL;
+
+    bc_arena_t *arena = bc_arena_new(0);
+    blogc_template_node_t *nodes = bc_arena_alloc(arena,
+        (header.nodes_len + 1) * sizeof(blogc_template_node_t));
+    char *blob = bc_arena_alloc(arena, header.blob_len + 1);
+    memcpy(blob, blob_src, header.blob_len);
+
+    const char *pos = str + sizeof(header);
+    for (size_t i = 0; i < header.nodes_len; i++) {
+        blogc_template_cache_node_t n;
+        memcpy(&n, pos, sizeof(n));
+        pos += sizeof(n);
+
+        if (n.type < BLOGC_TEMPLATE_NODE_IFDEF ||
+            n.type > BLOGC_TEMPLATE_NODE_CONTENT ||
+            n.jump >= header.nodes_len)
+            goto invalid;
+
+        blogc_template_node_t *node = nodes + i;
+        node->type = n.type;
+        node->op = n.op;
+        node->jump = n.jump;
+        for (size_t j = 0; j < 2; j++) {
+            node->data[j] = NULL;
+            if (n.data[j] == BLOGC_TEMPLATE_CACHE_NULL)
+                continue;
+            if (n.data[j] >= header.blob_len)
+                goto invalid;
+            node->data[j] = blob + n.data[j];
+        }
+
+        // the renderer looks these names up without checking.
+        if (node->data[0] == NULL &&
+            (n.type == BLOGC_TEMPLATE_NODE_BLOCK ||
+             n.type == BLOGC_TEMPLATE_NODE_FOREACH ||
+             n.type == BLOGC_TEMPLATE_NODE_VARIABLE ||
+             n.type == BLOGC_TEMPLATE_NODE_IF ||
+             n.type == BLOGC_TEMPLATE_NODE_IFDEF ||
+             n.type == BLOGC_TEMPLATE_NODE_IFNDEF))
+            goto invalid;
+        memset(node->operands, 0, sizeof(node->operands));
+        blogc_template_decode_operands(arena, node);
+    }
+
+    if (!valid_jumps(nodes, header.nodes_len))
+        goto invalid;
+
+    blogc_template_t *rv = bc_malloc(sizeof(blogc_template_t));
+    rv->nodes = nodes;
+    rv->nodes_len = header.nodes_len;
+    rv->arena = arena;
+    return rv;
+
+invalid:
+    bc_arena_free(arena);
+    return NULL;
+}
+
+
+blogc_template_t*
+blogc_template_cache_get(const char *dir, const char *src, size_t src_len)
+{
+    if (dir == NULL || src == NULL)
+        return NULL;
+
+    uint64_t hash = blogc_template_cache_hash(src, src_len);
+
+    // a missing or broken entry is just a cache miss.
+    bc_file_map_t *m = blogc_cache_map(dir, hash);
+    if (m == NULL)
+        return NULL;
+
+    blogc_template_t *rv = load_nodes(m->str, m->len, hash, src_len);
+    bc_file_unmap(m);
+    return rv;
+}
+
+
+bool
+blogc_template_cache_put(const char *dir, const char *src, size_t src_len,
+    blogc_template_t *tmpl)
+{
+    if (dir == NULL || src == NULL || tmpl == NULL)
+        return false;
+
+    // offsets are stored as 32 bits integers, big templates are not cached.
+    uint64_t blob_len = 0;
+    for (size_t i = 0; i < tmpl->nodes_len; i++)
+        for (size_t j = 0; j < 2; j++)
+            if (tmpl->nodes[i].data[j] != NULL)
+                blob_len += strlen(tmpl->nodes[i].data[j]) + 1;
+    if (blob_len >= BLOGC_TEMPLATE_CACHE_NULL)
+        return false;
+
+    char *tmp_path = NULL;
+    bc_file_writer_t *w = blogc_cache_writer_new(dir, &tmp_path);
+    if (w == NULL)
+        return false;
+
+    blogc_template_cache_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BLOGC_TEMPLATE_CACHE_MAGIC, sizeof(header.magic));
+    header.hash = blogc_template_cache_hash(src, src_len);
+    header.src_len = src_len;
+    header.nodes_len = tmpl->nodes_len;
+    header.blob_len = blob_len;
+    bc_file_writer_write(w, (const char*) &header, sizeof(header));
+
+    uint32_t offset = 0;
+    for (size_t i = 0; i < tmpl->nodes_len; i++) {
+        blogc_template_node_t *node = tmpl->nodes + i;
+        blogc_template_cache_node_t n;
+        memset(&n, 0, sizeof(n));
+        n.type = node->type;
+        n.op = node->op;
+        n.jump = node->jump;
+        for (size_t j = 0; j < 2; j++) {
+            n.data[j] = BLOGC_TEMPLATE_CACHE_NULL;
+            if (node->data[j] != NULL) {
+                n.data[j] = offset;
+                offset += strlen(node->data[j]) + 1;
+            }
+        }
+        bc_file_writer_write(w, (const char*) &n, sizeof(n));
+    }
+    for (size_t i = 0; i < tmpl->nodes_len; i++)
+        for (size_t j = 0; j < 2; j++)
+            if (tmpl->nodes[i].data[j] != NULL)
+                bc_file_writer_write(w, tmpl->nodes[i].data[j],
+                    strlen(tmpl->nodes[i].data[j]) + 1);
+
+    return blogc_cache_writer_commit(dir, header.hash, w, tmp_path);
+}
@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "template-parser.h"
+
+// on-disk cache of compiled templates, keyed by the hash of the template
+// content. the file has a fixed header, followed by the nodes, with offsets
+// of their data slots, followed by a blob with all the NUL-terminated data
+// slots. loading is a single copy of the blob, plus fixing the pointers.
+// operands are decoded again when loading, as they point to functions.
+#define BLOGC_TEMPLATE_CACHE_MAGIC "BLOGCTC\1"
+#define BLOGC_TEMPLATE_CACHE_NULL UINT32_MAX
+
+typedef struct {
+    char magic[8];
+    uint64_t hash;
+    uint64_t src_len;
+    uint64_t nodes_len;
+    uint64_t blob_len;
+} blogc_template_cache_header_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t op;
+    uint64_t jump;
+    uint32_t data[2];
+} blogc_template_cache_node_t;
+
+uint64_t blogc_template_cache_hash(const char *src, size_t src_len);
+blogc_template_t* blogc_template_cache_get(const char *dir, const char *src,
+    size_t src_len);
+bool blogc_template_cache_put(const char *dir, const char *src, size_t src_len,
+    blogc_template_t *tmpl);
@@ -6,6 +6,7 @@
 #include <string.h>
 
 #include "template-parser.h"
+#include "../common/arena.h"
 #include "../common/error.h"
 #include "../common/utils.h"
 
@@ -36,7 +37,173 @@ typedef enum {
 } blogc_template_parser_state_t;
 
 
-bc_slist_t*
+static size_t
+blogc_template_count_nodes(const char *src, size_t src_len)
+{
+    // each statement or variable starts with a '{', and may be preceded by
+    // a content node. the last content node is not followed by any '{'.
+    size_t rv = 1;
+    const char *end = src + src_len;
+    for (const char *p = src; (p = memchr(p, '{', end - p)) != NULL; p++)
+        rv += 2;
+    return rv;
+}
+
+
+static blogc_template_node_t*
+blogc_template_node_append(blogc_template_node_t *nodes, size_t *nodes_len)
+{
+    blogc_template_node_t *rv = nodes + (*nodes_len)++;
+    memset(rv, 0, sizeof(blogc_template_node_t));
+    return rv;
+}
+
+
+void
+blogc_template_parse_operand(bc_arena_t *arena, const char *name,
+    blogc_template_operand_t *op)
+{
+    op->name = name;
+    op->base = name;
+    op->len = -1;
+    op->formatter = BLOGC_TEMPLATE_FORMATTER_NONE;
+    op->special = BLOGC_TEMPLATE_SPECIAL_NONE;
+    op->funcvar = NULL;
+    op->literal = false;
+
+    if (name == NULL || name[0] == '\0')
+        return;
+
+    size_t last = strlen(name);
+    size_t base_len = last;
+    size_t i;
+
+    // just walk till the last '_'
+    for (i = last - 1; i > 0 && name[i] >= '0' && name[i] <= '9'; i--);
+
+    if (name[i] == '_' && (i + 1) < last) {  // name ends with '_[0-9]+'
+        op->len = strtol(name + i + 1, NULL, 10);
+        base_len = i;
+    }
+
+    if (base_len >= 10 && 0 == strncmp(name + base_len - 10, "_FORMATTED", 10)) {
+        base_len -= 10;
+        if (bc_str_starts_with(name, "DATE_"))
+            op->formatter = BLOGC_TEMPLATE_FORMATTER_DATE;
+        else
+            op->formatter = BLOGC_TEMPLATE_FORMATTER_UNKNOWN;
+    }
+
+    if (base_len != last)
+        op->base = bc_arena_strndup(arena, name, base_len);
+
+    if (0 == strcmp(op->base, "FOREACH_ITEM"))
+        op->special = BLOGC_TEMPLATE_SPECIAL_FOREACH_ITEM;
+    else if (0 == strcmp(op->base, "FOREACH_VALUE"))
+        op->special = BLOGC_TEMPLATE_SPECIAL_FOREACH_VALUE;
+    else
+        op->funcvar = blogc_funcvars_lookup(op->base);
+}
+
+
+void
+blogc_template_decode_operands(bc_arena_t *arena, blogc_template_node_t *node)
+{
+    blogc_template_node_type_t type = node->type;
+    if (type == BLOGC_TEMPLATE_NODE_VARIABLE ||
+        type == BLOGC_TEMPLATE_NODE_IF ||
+        type == BLOGC_TEMPLATE_NODE_IFDEF ||
+        type == BLOGC_TEMPLATE_NODE_IFNDEF)
+    {
+        blogc_template_parse_operand(arena, node->data[0], &node->operands[0]);
+    }
+    if (node->data[1] != NULL) {
+        blogc_template_operand_t *op2 = &node->operands[1];
+        size_t data_len = strlen(node->data[1]);
+
+        // strings that start with a '"' are actually strings, the others are
+        // meant to be looked up as a second variable.
+        if (data_len >= 2 && node->data[1][0] == '"' &&
+            node->data[1][data_len - 1] == '"')
+        {
+            blogc_template_parse_operand(arena, NULL, op2);
+            op2->name = bc_arena_strndup(arena, node->data[1] + 1, data_len - 2);
+            op2->base = op2->name;
+            op2->literal = true;
+        }
+        else {
+            blogc_template_parse_operand(arena, node->data[1], op2);
+        }
+    }
+}
+
+
+static void
+blogc_template_resolve_jumps(blogc_template_node_t *nodes, size_t nodes_len)
+{
+    // the template was validated already, so statements are balanced. 'block'
+    // and 'foreach' can't be nested, we just need a stack for conditionals.
+    size_t *stack = bc_malloc(nodes_len * sizeof(size_t));
+    size_t stack_len = 0;
+    size_t block = 0;
+    size_t foreach = 0;
+
+    for (size_t i = 0; i < nodes_len; i++) {
+        blogc_template_node_t *node = nodes + i;
+        switch (node->type) {
+            case BLOGC_TEMPLATE_NODE_IFDEF:
+            case BLOGC_TEMPLATE_NODE_IFNDEF:
+            case BLOGC_TEMPLATE_NODE_IF:
+                node->jump = i;
+                stack[stack_len++] = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ELSE:
+                // a false conditional jumps to its first 'else'.
+                if (nodes[stack[stack_len - 1]].type != BLOGC_TEMPLATE_NODE_ELSE)
+                    nodes[stack[stack_len - 1]].jump = i;
+                node->jump = i;
+                stack[stack_len++] = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ENDIF:
+                while (nodes[stack[stack_len - 1]].type == BLOGC_TEMPLATE_NODE_ELSE)
+                    nodes[stack[--stack_len]].jump = i;
+                stack_len--;
+                if (nodes[stack[stack_len]].jump == stack[stack_len])
+                    nodes[stack[stack_len]].jump = i;
+                node->jump = stack[stack_len];
+                break;
+
+            case BLOGC_TEMPLATE_NODE_BLOCK:
+                block = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ENDBLOCK:
+                nodes[block].jump = i;
+                node->jump = block;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_FOREACH:
+                foreach = i;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_ENDFOREACH:
+                nodes[foreach].jump = i;
+                node->jump = foreach;
+                break;
+
+            case BLOGC_TEMPLATE_NODE_VARIABLE:
+            case BLOGC_TEMPLATE_NODE_CONTENT:
+                break;
+        }
+    }
+
+    free(stack);
+}
+
+
+blogc_template_t*
 blogc_template_parse(const char *src, size_t src_len, bc_error_t **err)
 {
     if (err == NULL || *err != NULL)
@@ -58,22 +225,22 @@ blogc_template_parse(const char *src, size_t src_len, bc_error_t **err)
     bool foreach_open = false;
     bool block_foreach_open = false;
 
-    bc_slist_t *ast = NULL;
+    // everything allocated by the parser lives in this arena, that is released
+    // by blogc_template_free().
+    bc_arena_t *arena = bc_arena_new(0);
+
+    // the node array is sized for the worst case upfront, so it never moves
+    // and pointers to its elements are stable.
+    blogc_template_node_t *nodes = bc_arena_alloc(arena,
+        blogc_template_count_nodes(src, src_len) * sizeof(blogc_template_node_t));
+    size_t nodes_len = 0;
     blogc_template_node_t *node = NULL;
 
-    /*
-     * this is a reference to the content of previous node in the singly-linked
-     * list. The "correct" solution here would be implement a doubly-linked
-     * list, but here are a few reasons to avoid it:
-     *
-     * - i'm too tired to implement it :P
-     * - template parser never walk backwards, then the list itself does not
-     *   need to know its previous node.
-     */
+    // this is a reference to the previous node, that may need to be stripped
+    // by a whitespace cleaner.
     blogc_template_node_t *previous = NULL;
 
     bool lstrip_next = false;
-    char *tmp = NULL;
     char *block_type = NULL;
 
     blogc_template_parser_state_t state = TEMPLATE_START;
@@ -89,21 +256,14 @@ blogc_template_parse(const char *src, size_t src_len, bc_error_t **err)
 
             case TEMPLATE_START:
                 if (last) {
-                    node = bc_malloc(sizeof(blogc_template_node_t));
+                    node = blogc_template_node_append(nodes, &nodes_len);
                     node->type = type;
+                    node->data[0] = bc_arena_strndup(arena, src + start,
+                        src_len - start);
                     if (lstrip_next) {
-                        tmp = bc_strndup(src + start, src_len - start);
-                        node->data[0] = bc_strdup(bc_str_lstrip(tmp));
-                        free(tmp);
-                        tmp = NULL;
+                        node->data[0] = bc_str_lstrip(node->data[0]);  // does not need copy
                         lstrip_next = false;
                     }
-                    else {
-                        node->data[0] = bc_strndup(src + start, src_len - start);
-                    }
-                    node->op = 0;
-                    node->data[1] = NULL;
-                    ast = bc_slist_append(ast, node);
                     previous = node;
                     node = NULL;
                 }
@@ -120,21 +280,14 @@ blogc_template_parse(const char *src, size_t src_len, bc_error_t **err)
                     else
                         state = TEMPLATE_VARIABLE_START;
                     if (end > start) {
-                        node = bc_malloc(sizeof(blogc_template_node_t));
+                        node = blogc_template_node_append(nodes, &nodes_len);
                         node->type = type;
+                        node->data[0] = bc_arena_strndup(arena, src + start,
+                            end - start);
                         if (lstrip_next) {
-                            tmp = bc_strndup(src + start, end - start);
-                            node->data[0] = bc_strdup(bc_str_lstrip(tmp));
-                            free(tmp);
-                            tmp = NULL;
+                            node->data[0] = bc_str_lstrip(node->data[0]);  // does not need copy
                             lstrip_next = false;
                         }
-                        else {
-                            node->data[0] = bc_strndup(src + start, end - start);
-                        }
-                        node->op = 0;
-                        node->data[1] = NULL;
-                        ast = bc_slist_append(ast, node);
                         previous = node;
                         node = NULL;
                     }
@@ -610,21 +763,21 @@ blogc_template_parse(const char *src, size_t src_len, bc_error_t **err)
                         op_start = 0;
                         op_end = 0;
                     }
-                    node = bc_malloc(sizeof(blogc_template_node_t));
+                    node = blogc_template_node_append(nodes, &nodes_len);
                     node->type = type;
                     node->op = tmp_op;
-                    node->data[0] = NULL;
-                    node->data[1] = NULL;
                     if (end > start)
-                        node->data[0] = bc_strndup(src + start, end - start);
+                        node->data[0] = bc_arena_strndup(arena, src + start,
+                            end - start);
                     if (end2 > start2) {
-                        node->data[1] = bc_strndup(src + start2, end2 - start2);
+                        node->data[1] = bc_arena_strndup(arena, src + start2,
+                            end2 - start2);
                         start2 = 0;
                         end2 = 0;
                     }
+                    blogc_template_decode_operands(arena, node);
                     if (type == BLOGC_TEMPLATE_NODE_BLOCK)
                         block_type = node->data[0];
-                    ast = bc_slist_append(ast, node);
                     previous = node;
                     node = NULL;
                     state = TEMPLATE_START;
@@ -662,28 +815,65 @@ blogc_template_parse(const char *src, size_t src_len, bc_error_t **err)
     }
 
     if (*err != NULL) {
-        if (node != NULL) {
-            free(node->data[0]);
-            free(node);
-        }
-        blogc_template_free_ast(ast);
+        bc_arena_free(arena);
         return NULL;
     }
 
-    return ast;
+    blogc_template_resolve_jumps(nodes, nodes_len);
+
+    blogc_template_t *rv = bc_malloc(sizeof(blogc_template_t));
+    rv->arena = arena;
+    rv->nodes = nodes;
+    rv->nodes_len = nodes_len;
+    return rv;
 }
 
 
-void
-blogc_template_free_ast(bc_slist_t *ast)
+static bool
+operand_is(const blogc_template_operand_t *op, const char *name)
 {
-    for (bc_slist_t *tmp = ast; tmp != NULL; tmp = tmp->next) {
-        blogc_template_node_t *data = tmp->data;
-        if (data == NULL)
-            continue;
-        free(data->data[0]);
-        free(data->data[1]);
-        free(data);
+    if (op->name == NULL || op->literal)
+        return false;
+    return 0 == strcmp(op->name, name) ||
+        (op->base != op->name && 0 == strcmp(op->base, name));
+}
+
+
+bool
+blogc_template_uses_variable(blogc_template_t *tmpl, const char *name)
+{
+    if (tmpl == NULL || name == NULL)
+        return false;
+
+    for (size_t i = 0; i < tmpl->nodes_len; i++) {
+        blogc_template_node_t *node = tmpl->nodes + i;
+        switch (node->type) {
+            case BLOGC_TEMPLATE_NODE_IFDEF:
+            case BLOGC_TEMPLATE_NODE_IFNDEF:
+            case BLOGC_TEMPLATE_NODE_IF:
+            case BLOGC_TEMPLATE_NODE_VARIABLE:
+                if (operand_is(&node->operands[0], name) ||
+                    operand_is(&node->operands[1], name))
+                    return true;
+                break;
+            case BLOGC_TEMPLATE_NODE_FOREACH:
+                if (node->data[0] != NULL && 0 == strcmp(node->data[0], name))
+                    return true;
+                break;
+            default:
+                break;
+        }
     }
-    bc_slist_free(ast);
+
+    return false;
+}
+
+
+void
+blogc_template_free(blogc_template_t *tmpl)
+{
+    if (tmpl == NULL)
+        return;
+    bc_arena_free(tmpl->arena);
+    free(tmpl);
 }
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
+#include "funcvars.h"
+#include "../common/arena.h"
 #include "../common/error.h"
 #include "../common/utils.h"
 
@@ -12,7 +15,9 @@
  * template parsing. renderer does not need to care about it, for the sake of
  * simplicity.
  *
- * another note: technically this is not an AST, because it is not a tree. duh!
+ * another note: technically this is not an AST, because it is not a tree. it
+ * is a flat array of nodes, and statements store the index of the node the
+ * renderer should jump to, to skip them. duh!
  */
 typedef enum {
     BLOGC_TEMPLATE_NODE_IFDEF = 1,
@@ -35,6 +40,38 @@ typedef enum {
     BLOGC_TEMPLATE_OP_GT  = 1 << 3,
 } blogc_template_operator_t;
 
+typedef enum {
+    BLOGC_TEMPLATE_FORMATTER_NONE = 0,
+    BLOGC_TEMPLATE_FORMATTER_DATE,
+    BLOGC_TEMPLATE_FORMATTER_UNKNOWN,
+} blogc_template_formatter_t;
+
+typedef enum {
+    BLOGC_TEMPLATE_SPECIAL_NONE = 0,
+    BLOGC_TEMPLATE_SPECIAL_FOREACH_ITEM,
+    BLOGC_TEMPLATE_SPECIAL_FOREACH_VALUE,
+} blogc_template_special_t;
+
+/*
+ * variables and 'if' operands are decoded by the parser, so the renderer does
+ * not need to inspect their names again for each evaluation.
+ *
+ * - name: variable name as written in the template, or the contents of a
+ *   double-quoted string, without the quotes.
+ * - base: variable name without the '_[0-9]+' and '_FORMATTED' suffixes.
+ *   points to name if there are no suffixes.
+ * - len: length of the '_[0-9]+' suffix, or -1.
+ */
+typedef struct {
+    const char *name;
+    const char *base;
+    long int len;
+    blogc_template_formatter_t formatter;
+    blogc_template_special_t special;
+    blogc_funcvars_func_t funcvar;
+    bool literal;
+} blogc_template_operand_t;
+
 typedef struct {
     blogc_template_node_type_t type;
     blogc_template_operator_t op;
@@ -42,9 +79,30 @@ typedef struct {
     // 2 slots to store node data.
     char *data[2];
 
-    bc_slist_t *childs;
+    // decoded data slots, for variables and conditionals.
+    blogc_template_operand_t operands[2];
+
+    // index of another node, resolved by the parser:
+    //
+    // - if/ifdef/ifndef: the first 'else' of the statement, or its 'endif'.
+    // - else: the 'endif' of the statement.
+    // - block/foreach: the matching 'endblock'/'endforeach'.
+    // - endif/endblock/endforeach: the statement being closed.
+    size_t jump;
 } blogc_template_node_t;
 
-bc_slist_t* blogc_template_parse(const char *src, size_t src_len,
+typedef struct {
+    blogc_template_node_t *nodes;
+    size_t nodes_len;
+
+    // the whole ast (nodes and their data) is allocated from this arena.
+    bc_arena_t *arena;
+} blogc_template_t;
+
+blogc_template_t* blogc_template_parse(const char *src, size_t src_len,
     bc_error_t **err);
-void blogc_template_free_ast(bc_slist_t *ast);
+bool blogc_template_uses_variable(blogc_template_t *tmpl, const char *name);
+void blogc_template_free(blogc_template_t *tmpl);
+void blogc_template_parse_operand(bc_arena_t *arena, const char *name,
+    blogc_template_operand_t *op);
+void blogc_template_decode_operands(bc_arena_t *arena, blogc_template_node_t *node);
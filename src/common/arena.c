@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "utils.h"
+
+#define BC_ARENA_ALIGN(n) \
+    (((n) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1))
+
+#define BC_ARENA_HEADER_SIZE BC_ARENA_ALIGN(sizeof(bc_arena_chunk_t))
+
+
+bc_arena_t*
+bc_arena_new(size_t chunk_size)
+{
+    bc_arena_t *rv = bc_malloc(sizeof(bc_arena_t));
+    rv->chunks = NULL;
+    rv->chunk_size = chunk_size == 0 ? BC_ARENA_CHUNK_SIZE : chunk_size;
+    return rv;
+}
+
+
+static bc_arena_chunk_t*
+bc_arena_chunk_new(size_t len)
+{
+    bc_arena_chunk_t *rv = bc_malloc(BC_ARENA_HEADER_SIZE + len);
+    rv->next = NULL;
+    rv->len = len;
+    rv->used = 0;
+    return rv;
+}
+
+
+void*
+bc_arena_alloc(bc_arena_t *arena, size_t size)
+{
+    if (arena == NULL)
+        return NULL;
+
+    size = BC_ARENA_ALIGN(size == 0 ? 1 : size);
+
+    bc_arena_chunk_t *chunk = arena->chunks;
+    if (chunk == NULL || chunk->len - chunk->used < size) {
+
+        // big allocations get a chunk of their own, placed behind the current
+        // chunk, so we don't waste the free space of the current chunk.
+        if (size > arena->chunk_size / 4) {
+            bc_arena_chunk_t *big = bc_arena_chunk_new(size);
+            big->used = size;
+            if (chunk == NULL) {
+                arena->chunks = big;
+            }
+            else {
+                big->next = chunk->next;
+                chunk->next = big;
+            }
+            return (char*) big + BC_ARENA_HEADER_SIZE;
+        }
+
+        chunk = bc_arena_chunk_new(arena->chunk_size);
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    void *rv = (char*) chunk + BC_ARENA_HEADER_SIZE + chunk->used;
+    chunk->used += size;
+    return rv;
+}
+
+
+char*
+bc_arena_strndup(bc_arena_t *arena, const char *s, size_t n)
+{
+    if (arena == NULL || s == NULL)
+        return NULL;
+    size_t l = strnlen(s, n);
+    char *rv = bc_arena_alloc(arena, l + 1);
+    memcpy(rv, s, l);
+    rv[l] = '\0';
+    return rv;
+}
+
+
+char*
+bc_arena_strdup(bc_arena_t *arena, const char *s)
+{
+    if (arena == NULL || s == NULL)
+        return NULL;
+    size_t l = strlen(s);
+    char *rv = bc_arena_alloc(arena, l + 1);
+    memcpy(rv, s, l + 1);
+    return rv;
+}
+
+
+void
+bc_arena_free(bc_arena_t *arena)
+{
+    if (arena == NULL)
+        return;
+    bc_arena_chunk_t *chunk = arena->chunks;
+    while (chunk != NULL) {
+        bc_arena_chunk_t *tmp = chunk->next;
+        free(chunk);
+        chunk = tmp;
+    }
+    free(arena);
+}
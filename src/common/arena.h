@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <stddef.h>
+
+#define BC_ARENA_CHUNK_SIZE 4096
+
+// bump allocator. everything allocated from an arena is released at once by
+// bc_arena_free(), there's no way to free individual allocations.
+
+typedef struct _bc_arena_chunk_t {
+    struct _bc_arena_chunk_t *next;
+    size_t len;
+    size_t used;
+} bc_arena_chunk_t;
+
+typedef struct {
+    bc_arena_chunk_t *chunks;
+    size_t chunk_size;
+} bc_arena_t;
+
+bc_arena_t* bc_arena_new(size_t chunk_size);
+void* bc_arena_alloc(bc_arena_t *arena, size_t size);
+char* bc_arena_strdup(bc_arena_t *arena, const char *s);
+char* bc_arena_strndup(bc_arena_t *arena, const char *s, size_t n);
+void bc_arena_free(bc_arena_t *arena);
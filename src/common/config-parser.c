@@ -64,6 +64,7 @@ bc_config_parse(const char *src, size_t src_len, const char *list_sections[],
     size_t start = 0;
 
     bc_configparser_section_t *section = NULL;
+    bc_slist_t *section_tail = NULL;
 
     char *section_name = NULL;
     char *key = NULL;
@@ -154,6 +155,7 @@ bc_config_parse(const char *src, size_t src_len, const char *list_sections[],
                             break;
                     }
                     bc_trie_insert(rv->root, section_name, section);
+                    section_tail = NULL;
                     free(section_name);
                     section_name = NULL;
                     state = CONFIG_START;
@@ -261,8 +263,8 @@ bc_config_parse(const char *src, size_t src_len, const char *list_sections[],
 
             case CONFIG_SECTION_LIST_QUOTE:
                 if (c == '"') {
-                    section->data = bc_slist_append(section->data,
-                        bc_string_free(value, false));
+                    section->data = bc_slist_append_tail(section->data,
+                        &section_tail, bc_string_free(value, false));
                     value = NULL;
                     state = CONFIG_SECTION_LIST_POST_QUOTED;
                     break;
@@ -287,8 +289,8 @@ bc_config_parse(const char *src, size_t src_len, const char *list_sections[],
                 if (c == '\r' || c == '\n' || is_last) {
                     if (is_last && c != '\r' && c != '\n')
                         bc_string_append_c(value, c);
-                    section->data = bc_slist_append(section->data,
-                        bc_strdup(bc_str_strip(value->str)));
+                    section->data = bc_slist_append_tail(section->data,
+                        &section_tail, bc_strdup(bc_str_strip(value->str)));
                     bc_string_free(value, true);
                     value = NULL;
                     state = CONFIG_START;
@@ -318,9 +320,9 @@ bc_config_parse(const char *src, size_t src_len, const char *list_sections[],
 
 
 static void
-list_keys(const char *key, const char *value, bc_slist_t **l)
+list_keys(const char *key, const char *value, char ***keys)
 {
-    *l = bc_slist_append(*l, bc_strdup(key));
+    *(*keys)++ = bc_strdup(key);
 }
 
 
@@ -330,17 +332,10 @@ bc_config_list_sections(bc_config_t *config)
     if (config == NULL)
         return NULL;
 
-    bc_slist_t *l = NULL;
-    bc_trie_foreach(config->root, (bc_trie_foreach_func_t) list_keys, &l);
-
-    char **rv = bc_malloc(sizeof(char*) * (bc_slist_length(l) + 1));
-
-    size_t i = 0;
-    for (bc_slist_t *tmp = l; tmp != NULL; tmp = tmp->next, i++)
-        rv[i] = tmp->data;
-    rv[i] = NULL;
-
-    bc_slist_free(l);
+    char **rv = bc_malloc(sizeof(char*) * (bc_trie_size(config->root) + 1));
+    char **tmp = rv;
+    bc_trie_foreach(config->root, (bc_trie_foreach_func_t) list_keys, &tmp);
+    *tmp = NULL;
 
     return rv;
 }
@@ -359,17 +354,10 @@ bc_config_list_keys(bc_config_t *config, const char *section)
     if (s->type != CONFIG_SECTION_TYPE_MAP)
         return NULL;
 
-    bc_slist_t *l = NULL;
-    bc_trie_foreach(s->data, (bc_trie_foreach_func_t) list_keys, &l);
-
-    char **rv = bc_malloc(sizeof(char*) * (bc_slist_length(l) + 1));
-
-    size_t i = 0;
-    for (bc_slist_t *tmp = l; tmp != NULL; tmp = tmp->next, i++)
-        rv[i] = tmp->data;
-    rv[i] = NULL;
-
-    bc_slist_free(l);
+    char **rv = bc_malloc(sizeof(char*) * (bc_trie_size(s->data) + 1));
+    char **tmp = rv;
+    bc_trie_foreach(s->data, (bc_trie_foreach_func_t) list_keys, &tmp);
+    *tmp = NULL;
 
     return rv;
 }
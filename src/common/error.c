@@ -129,6 +129,9 @@ bc_error_print(bc_error_t *err, const char *prefix)
         case BLOGC_WARNING_DATETIME_PARSER:
             fprintf(stderr, "warning: datetime: %s\n", err->msg);
             break;
+        case BLOGC_ERROR_MANIFEST_PARSER:
+            fprintf(stderr, "error: manifest: %s\n", err->msg);
+            break;
         case BLOGC_MAKE_ERROR_SETTINGS:
             fprintf(stderr, "error: settings: %s\n", err->msg);
             break;
@@ -17,6 +17,7 @@ typedef enum {
     BLOGC_ERROR_TEMPLATE_PARSER,
     BLOGC_ERROR_LOADER,
     BLOGC_WARNING_DATETIME_PARSER,
+    BLOGC_ERROR_MANIFEST_PARSER,
 
     // errors for src/blogc-make
     BLOGC_MAKE_ERROR_SETTINGS = 300,
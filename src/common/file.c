@@ -1,17 +1,119 @@
 // SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
 // SPDX-License-Identifier: BSD-3-Clause
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
 #include <errno.h>
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif /* HAVE_SYS_UIO_H */
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
 #include "file.h"
 #include "error.h"
 #include "utf8.h"
 #include "utils.h"
 
 
+static int
+open_file(const char *path, struct stat *st, bc_error_t **err)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        int tmp_errno = errno;
+        *err = bc_error_new_printf(BC_ERROR_FILE,
+            "Failed to open file (%s): %s", path, strerror(tmp_errno));
+        return -1;
+    }
+
+    if (0 != fstat(fd, st))
+        st->st_mode = 0;
+
+    return fd;
+}
+
+
+static bool
+validate_contents(const char *path, const char **str, size_t *len,
+    bc_error_t **err)
+{
+    // skipping BOM before validation, for performance. should be safe enough
+    size_t skip = bc_utf8_skip_bom((const uint8_t*) *str, *len);
+    *str += skip;
+    *len -= skip;
+
+    if (!bc_utf8_validate((const uint8_t*) *str, *len)) {
+        *err = bc_error_new_printf(BC_ERROR_FILE,
+            "File content is not valid UTF-8: %s", path);
+        return false;
+    }
+    return true;
+}
+
+
+static char*
+read_contents(int fd, const char *path, const struct stat *st, bool utf8,
+    size_t *len, bc_error_t **err)
+{
+    // regular files are read with a single read(2) call in the common case.
+    // the extra byte, besides the NUL terminator, allows us to detect the
+    // end of file without growing the buffer.
+    size_t allocated = BC_FILE_CHUNK_SIZE;
+    if (S_ISREG(st->st_mode) && st->st_size > 0)
+        allocated = st->st_size + 2;
+
+    char *buf = bc_malloc(allocated);
+    size_t buf_len = 0;
+
+    while (true) {
+        if (buf_len + 1 >= allocated) {
+            allocated *= 2;
+            buf = bc_realloc(buf, allocated);
+        }
+        ssize_t read_len = read(fd, buf + buf_len, allocated - buf_len - 1);
+        if (read_len < 0) {
+            if (errno == EINTR)
+                continue;
+            int tmp_errno = errno;
+            *err = bc_error_new_printf(BC_ERROR_FILE,
+                "Failed to read file (%s): %s", path, strerror(tmp_errno));
+            free(buf);
+            return NULL;
+        }
+        if (read_len == 0)
+            break;
+        buf_len += read_len;
+    }
+    buf[buf_len] = '\0';
+
+    if (utf8) {
+        const char *str = buf;
+        if (!validate_contents(path, &str, &buf_len, err)) {
+            free(buf);
+            return NULL;
+        }
+        if (str != buf)
+            memmove(buf, str, buf_len + 1);
+    }
+
+    *len = buf_len;
+    return buf;
+}
+
+
 char*
 bc_file_get_contents(const char *path, bool utf8, size_t *len, bc_error_t **err)
 {
@@ -19,43 +121,199 @@ bc_file_get_contents(const char *path, bool utf8, size_t *len, bc_error_t **err)
         return NULL;
 
     *len = 0;
-    FILE *fp = fopen(path, "r");
 
-    if (fp == NULL) {
-        int tmp_errno = errno;
-        *err = bc_error_new_printf(BC_ERROR_FILE,
-            "Failed to open file (%s): %s", path, strerror(tmp_errno));
+    struct stat st;
+    int fd = open_file(path, &st, err);
+    if (fd < 0)
         return NULL;
+
+    char *rv = read_contents(fd, path, &st, utf8, len, err);
+    close(fd);
+    return rv;
+}
+
+
+bc_file_map_t*
+bc_file_map(const char *path, bool utf8, bc_error_t **err)
+{
+    if (path == NULL || err == NULL || *err != NULL)
+        return NULL;
+
+    struct stat st;
+    int fd = open_file(path, &st, err);
+    if (fd < 0)
+        return NULL;
+
+    bc_file_map_t *rv = bc_malloc(sizeof(bc_file_map_t));
+    rv->map = NULL;
+    rv->map_len = 0;
+
+#ifdef HAVE_SYS_MMAN_H
+    // small files are cheaper to read than to map.
+    if (S_ISREG(st.st_mode) && st.st_size >= BC_FILE_MAP_THRESHOLD) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            close(fd);
+            rv->map = map;
+            rv->map_len = st.st_size;
+            rv->str = map;
+            rv->len = st.st_size;
+            if (utf8 && !validate_contents(path, &rv->str, &rv->len, err)) {
+                bc_file_unmap(rv);
+                return NULL;
+            }
+            return rv;
+        }
+    }
+#endif /* HAVE_SYS_MMAN_H */
+
+    rv->str = read_contents(fd, path, &st, utf8, &rv->len, err);
+    close(fd);
+    if (rv->str == NULL) {
+        free(rv);
+        return NULL;
+    }
+    return rv;
+}
+
+
+void
+bc_file_unmap(bc_file_map_t *map)
+{
+    if (map == NULL)
+        return;
+#ifdef HAVE_SYS_MMAN_H
+    if (map->map != NULL)
+        munmap(map->map, map->map_len);
+    else
+#endif /* HAVE_SYS_MMAN_H */
+        free((char*) map->str);
+    free(map);
+}
+
+
+bc_file_writer_t*
+bc_file_writer_new(int fd)
+{
+    bc_file_writer_t *rv = bc_malloc(sizeof(bc_file_writer_t));
+    rv->fd = fd;
+    rv->buf = bc_malloc(BC_FILE_WRITER_BUFFER_SIZE);
+    rv->len = 0;
+    rv->error = 0;
+    return rv;
+}
+
+
+static void
+writer_write(bc_file_writer_t *w, const char *buf, size_t len)
+{
+    while (len > 0 && w->error == 0) {
+        ssize_t written = write(w->fd, buf, len);
+        if (written < 0) {
+            if (errno != EINTR)
+                w->error = errno;
+            continue;
+        }
+
+        // nothing written with data pending, retrying would never end.
+        if (written == 0) {
+            w->error = EIO;
+            break;
+        }
+        buf += written;
+        len -= written;
     }
+}
 
-    bc_string_t *str = bc_string_new();
-    char buffer[BC_FILE_CHUNK_SIZE];
-    char *tmp;
 
-    while (!feof(fp)) {
-        size_t read_len = fread(buffer, sizeof(char), BC_FILE_CHUNK_SIZE, fp);
+#ifdef HAVE_SYS_UIO_H
 
-        tmp = buffer;
+static void
+writer_writev(bc_file_writer_t *w, struct iovec *iov, int iovcnt)
+{
+    while (iovcnt > 0 && w->error == 0) {
+        ssize_t written = writev(w->fd, iov, iovcnt);
+        if (written < 0) {
+            if (errno != EINTR)
+                w->error = errno;
+            continue;
+        }
 
-        if (utf8 && str->len == 0 && read_len > 0) {
-            // skipping BOM before validation, for performance. should be safe
-            // enough
-            size_t skip = bc_utf8_skip_bom((uint8_t*) buffer, read_len);
-            read_len -= skip;
-            tmp += skip;
+        // skip whatever was written, and retry the remaining data.
+        size_t n = written;
+        while (iovcnt > 0 && n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            // nothing written with data pending, retrying would never end.
+            if (written == 0) {
+                w->error = EIO;
+                break;
+            }
+            iov->iov_base = (char*) iov->iov_base + n;
+            iov->iov_len -= n;
         }
+    }
+}
+
+#endif /* HAVE_SYS_UIO_H */
+
+
+void
+bc_file_writer_write(bc_file_writer_t *w, const char *str, size_t len)
+{
+    if (w == NULL || str == NULL || len == 0 || w->error != 0)
+        return;
 
-        *len += read_len;
-        bc_string_append_len(str, tmp, read_len);
+    if (w->len + len <= BC_FILE_WRITER_BUFFER_SIZE) {
+        memcpy(w->buf + w->len, str, len);
+        w->len += len;
+        return;
     }
-    fclose(fp);
 
-    if (utf8 && !bc_utf8_validate_str(str)) {
+#ifdef HAVE_SYS_UIO_H
+    struct iovec iov[2];
+    iov[0].iov_base = w->buf;
+    iov[0].iov_len = w->len;
+    iov[1].iov_base = (char*) str;
+    iov[1].iov_len = len;
+    if (w->len > 0)
+        writer_writev(w, iov, 2);
+    else
+        writer_writev(w, iov + 1, 1);
+#else
+    writer_write(w, w->buf, w->len);
+    writer_write(w, str, len);
+#endif /* HAVE_SYS_UIO_H */
+    w->len = 0;
+}
+
+
+bool
+bc_file_writer_flush(bc_file_writer_t *w, const char *path, bc_error_t **err)
+{
+    if (w == NULL || err == NULL || *err != NULL)
+        return false;
+
+    writer_write(w, w->buf, w->len);
+    w->len = 0;
+
+    if (w->error != 0) {
         *err = bc_error_new_printf(BC_ERROR_FILE,
-            "File content is not valid UTF-8: %s", path);
-        bc_string_free(str, true);
-        return NULL;
+            "Failed to write file (%s): %s", path, strerror(w->error));
+        return false;
     }
+    return true;
+}
 
-    return bc_string_free(str, false);
+
+void
+bc_file_writer_free(bc_file_writer_t *w)
+{
+    if (w == NULL)
+        return;
+    free(w->buf);
+    free(w);
 }
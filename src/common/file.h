@@ -8,5 +8,32 @@
 #include "error.h"
 
 #define BC_FILE_CHUNK_SIZE 1024
+#define BC_FILE_MAP_THRESHOLD (64 * 1024)
+#define BC_FILE_WRITER_BUFFER_SIZE (64 * 1024)
+
+// read-only view of a file. str is not guaranteed to be NUL-terminated.
+typedef struct {
+    const char *str;
+    size_t len;
+    void *map;
+    size_t map_len;
+} bc_file_map_t;
+
+// buffered writer for a file descriptor that is not owned by it. writes that
+// don't fit the buffer are sent together with the buffer in a single writev(2)
+// call, where available. the first error is kept, and reported by
+// bc_file_writer_flush().
+typedef struct {
+    int fd;
+    char *buf;
+    size_t len;
+    int error;
+} bc_file_writer_t;
 
 char* bc_file_get_contents(const char *path, bool utf8, size_t *len, bc_error_t **err);
+bc_file_map_t* bc_file_map(const char *path, bool utf8, bc_error_t **err);
+void bc_file_unmap(bc_file_map_t *map);
+bc_file_writer_t* bc_file_writer_new(int fd);
+void bc_file_writer_write(bc_file_writer_t *w, const char *str, size_t len);
+bool bc_file_writer_flush(bc_file_writer_t *w, const char *path, bc_error_t **err);
+void bc_file_writer_free(bc_file_writer_t *w);
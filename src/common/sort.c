@@ -1,7 +1,7 @@
 // SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
 // SPDX-License-Identifier: BSD-3-Clause
 
-#include <stdbool.h>
+#include <stddef.h>
 #include "utils.h"
 #include "sort.h"
 
@@ -9,31 +9,60 @@
 bc_slist_t*
 bc_slist_sort(bc_slist_t *l, bc_sort_func_t cmp)
 {
-    if (l == NULL) {
+    // bottom-up merge sort, that relinks the list nodes in place. it is
+    // stable, as elements are only moved in front of elements that compare
+    // greater than them.
+
+    if (l == NULL)
         return NULL;
-    }
 
-    bool swapped = false;
-    bc_slist_t *lptr = NULL;
-    bc_slist_t *rptr = NULL;
+    for (size_t width = 1;; width *= 2) {
+        bc_slist_t *left = l;
+        bc_slist_t *tail = NULL;
+        size_t merges = 0;
+        l = NULL;
 
-    do {
-        swapped = false;
-        lptr = l;
+        while (left != NULL) {
+            merges++;
 
-        while (lptr->next != rptr) {
-            if (0 < cmp(lptr->data, lptr->next->data)) {
-                void *tmp = lptr->data;
-                lptr->data = lptr->next->data;
-                lptr->next->data = tmp;
-                swapped = true;
+            bc_slist_t *right = left;
+            size_t left_len = 0;
+            for (; right != NULL && left_len < width; left_len++)
+                right = right->next;
+            size_t right_len = width;
+
+            while (left_len > 0 || (right_len > 0 && right != NULL)) {
+                bc_slist_t *next;
+                if (left_len == 0) {
+                    next = right;
+                    right = right->next;
+                    right_len--;
+                }
+                else if (right_len == 0 || right == NULL ||
+                    0 >= cmp(left->data, right->data))
+                {
+                    next = left;
+                    left = left->next;
+                    left_len--;
+                }
+                else {
+                    next = right;
+                    right = right->next;
+                    right_len--;
+                }
+                if (tail == NULL)
+                    l = next;
+                else
+                    tail->next = next;
+                tail = next;
             }
 
-            lptr = lptr->next;
+            left = right;
         }
 
-        rptr = lptr;
-    } while(swapped);
+        tail->next = NULL;
 
-    return l;
+        if (merges <= 1)
+            return l;
+    }
 }
@@ -1,8 +1,11 @@
 // SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <errno.h>
 #include <stdbool.h>
-#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
 #include "utils.h"
 #include "stdin.h"
 
@@ -14,10 +17,27 @@ bc_stdin_read(size_t *len)
     if (len == NULL)
         return NULL;
 
-    int c;
-    bc_string_t *rv = bc_string_new();
-    while (EOF != (c = fgetc(stdin)))
-        bc_string_append_c(rv, c);
+    // when stdin is redirected from a file, pre-size the buffer to read it
+    // all at once. the extra byte allows us to detect the end of file without
+    // growing the buffer.
+    size_t size_hint = BC_STDIN_CHUNK_SIZE;
+    struct stat st;
+    if (0 == fstat(STDIN_FILENO, &st) && S_ISREG(st.st_mode) && st.st_size > 0)
+        size_hint = st.st_size + 1;
+
+    bc_string_t *rv = bc_string_new_sized(size_hint);
+    while (true) {
+        if (rv->len + 1 >= rv->allocated_len)
+            bc_string_reserve(rv, rv->allocated_len * 2);
+        ssize_t read_len = read(STDIN_FILENO, rv->str + rv->len,
+            rv->allocated_len - rv->len - 1);
+        if (read_len < 0 && errno == EINTR)
+            continue;
+        if (read_len <= 0)
+            break;
+        rv->len += read_len;
+    }
+    rv->str[rv->len] = '\0';
     *len = rv->len;
     return bc_string_free(rv, false);
 }
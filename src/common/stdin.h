@@ -5,4 +5,6 @@
 
 #include <stddef.h>
 
+#define BC_STDIN_CHUNK_SIZE (64 * 1024)
+
 char* bc_stdin_read(size_t *len);
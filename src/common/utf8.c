@@ -5,10 +5,21 @@
 // Based on Bjoern Hoehrmann's algorithm.
 // See http://bjoern.hoehrmann.de/utf-8/decoder/dfa/ for details.
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#ifdef HAVE_IMMINTRIN_H
+#include <immintrin.h>
+#endif /* HAVE_IMMINTRIN_H */
+
 #include "utils.h"
+#include "utf8.h"
 
 #define UTF8_ACCEPT 0
 #define UTF8_REJECT 12
@@ -37,7 +48,7 @@ static const uint8_t utf8d[] = {
 
 
 bool
-bc_utf8_validate(const uint8_t *str, size_t len)
+bc_utf8_validate_dfa(const uint8_t *str, size_t len)
 {
     uint32_t state = 0;
 
@@ -48,6 +59,104 @@ bc_utf8_validate(const uint8_t *str, size_t len)
 }
 
 
+// the functions below return the length of the run of ASCII bytes at the
+// start of str. they are allowed to stop early, the DFA takes care of the
+// remaining bytes.
+
+static size_t
+ascii_prefix_scalar(const uint8_t *str, size_t len)
+{
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        memcpy(&v, str + i, sizeof(v));
+        if (v & UINT64_C(0x8080808080808080))
+            break;
+    }
+    return i;
+}
+
+
+#ifdef __SSE2__
+
+static size_t
+ascii_prefix_sse2(const uint8_t *str, size_t len)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (str + i));
+        int mask = _mm_movemask_epi8(v);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + ascii_prefix_scalar(str + i, len - i);
+}
+
+#endif /* __SSE2__ */
+
+
+#ifdef HAVE_AVX2_DISPATCH
+
+__attribute__((target("avx2"))) static size_t
+ascii_prefix_avx2(const uint8_t *str, size_t len)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (str + i));
+        int mask = _mm256_movemask_epi8(v);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + ascii_prefix_scalar(str + i, len - i);
+}
+
+#endif /* HAVE_AVX2_DISPATCH */
+
+
+typedef size_t (*ascii_prefix_func_t) (const uint8_t *str, size_t len);
+
+
+static ascii_prefix_func_t
+ascii_prefix_func(void)
+{
+#ifdef HAVE_AVX2_DISPATCH
+    if (__builtin_cpu_supports("avx2"))
+        return ascii_prefix_avx2;
+#endif /* HAVE_AVX2_DISPATCH */
+#ifdef __SSE2__
+    return ascii_prefix_sse2;
+#else
+    return ascii_prefix_scalar;
+#endif /* __SSE2__ */
+}
+
+
+bool
+bc_utf8_validate(const uint8_t *str, size_t len)
+{
+    ascii_prefix_func_t ascii_prefix = ascii_prefix_func();
+    uint32_t state = UTF8_ACCEPT;
+    size_t i = 0;
+
+    while (i < len) {
+
+        // skip runs of ASCII between complete code points in blocks, and
+        // feed everything else to the DFA.
+        if (state == UTF8_ACCEPT && str[i] < 0x80) {
+            i += ascii_prefix(str + i, len - i);
+            if (i >= len)
+                break;
+        }
+
+        state = utf8d[256 + state + utf8d[str[i++]]];
+        if (state == UTF8_REJECT)
+            return false;
+    }
+
+    return state == UTF8_ACCEPT;
+}
+
+
 bool
 bc_utf8_validate_str(bc_string_t *str)
 {
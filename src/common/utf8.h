@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include "utils.h"
 
+bool bc_utf8_validate_dfa(const uint8_t *str, size_t len);
 bool bc_utf8_validate(const uint8_t *str, size_t len);
 bool bc_utf8_validate_str(bc_string_t *str);
 size_t bc_utf8_skip_bom(const uint8_t *str, size_t len);
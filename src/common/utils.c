@@ -2,20 +2,126 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #define BC_STRING_CHUNK_SIZE 128
+#define BC_TRIE_ARENA_CHUNK_SIZE 256
+#define BC_TRIE_INITIAL_SIZE 8
 
 #include <string.h>
 #include <strings.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "arena.h"
 #include "utils.h"
 
 
+static bool alloc_stats_enabled = false;
+static bc_alloc_stats_t alloc_stats;
+static bc_alloc_site_t alloc_sites[BC_ALLOC_STATS_MAX_SITES];
+static bc_alloc_site_t alloc_sites_sorted[BC_ALLOC_STATS_MAX_SITES];
+
+
+static void
+alloc_stats_record(const char *file, int line, size_t size)
+{
+    alloc_stats.calls++;
+    alloc_stats.bytes += size;
+
+    // histogram bucket i counts allocations with sizes in [2^i, 2^(i+1))
+    size_t bucket = 0;
+    for (size_t tmp = size; tmp > 1 && bucket < BC_ALLOC_STATS_HISTOGRAM_SIZE - 1;
+            tmp >>= 1)
+        bucket++;
+    alloc_stats.histogram[bucket]++;
+
+    size_t idx = ((size_t) line * 2654435761u) % BC_ALLOC_STATS_MAX_SITES;
+    for (size_t i = 0; i < BC_ALLOC_STATS_MAX_SITES; i++) {
+        bc_alloc_site_t *site = &alloc_sites[idx];
+        if (site->file == NULL) {
+            site->file = file;
+            site->line = line;
+        }
+        if (site->line == line &&
+            (site->file == file || 0 == strcmp(site->file, file)))
+        {
+            site->calls++;
+            site->bytes += size;
+            return;
+        }
+        idx = (idx + 1) % BC_ALLOC_STATS_MAX_SITES;
+    }
+}
+
+
+void
+bc_alloc_stats_enable(bool enable)
+{
+    alloc_stats_enabled = enable;
+}
+
+
+bool
+bc_alloc_stats_enabled(void)
+{
+    return alloc_stats_enabled;
+}
+
+
+void
+bc_alloc_stats_reset(void)
+{
+    memset(&alloc_stats, 0, sizeof(alloc_stats));
+    memset(alloc_sites, 0, sizeof(alloc_sites));
+}
+
+
+void
+bc_alloc_stats_get(bc_alloc_stats_t *stats)
+{
+    if (stats != NULL)
+        *stats = alloc_stats;
+}
+
+
+static int
+sort_alloc_sites(const void *a, const void *b)
+{
+    const bc_alloc_site_t *sa = a;
+    const bc_alloc_site_t *sb = b;
+    if (sa->calls != sb->calls)
+        return sa->calls < sb->calls ? 1 : -1;
+    if (sa->bytes != sb->bytes)
+        return sa->bytes < sb->bytes ? 1 : -1;
+    return 0;
+}
+
+
+size_t
+bc_alloc_stats_get_sites(bc_alloc_site_t *sites, size_t len)
+{
+    // the len most called sites are copied to sites, most called first.
+    if (sites == NULL)
+        return 0;
+    size_t count = 0;
+    for (size_t i = 0; i < BC_ALLOC_STATS_MAX_SITES; i++)
+        if (alloc_sites[i].file != NULL)
+            alloc_sites_sorted[count++] = alloc_sites[i];
+    qsort(alloc_sites_sorted, count, sizeof(bc_alloc_site_t), sort_alloc_sites);
+    if (count > len)
+        count = len;
+    memcpy(sites, alloc_sites_sorted, count * sizeof(bc_alloc_site_t));
+    return count;
+}
+
+
 void*
-bc_malloc(size_t size)
+bc_malloc_at(const char *file, int line, size_t size)
 {
+    if (alloc_stats_enabled)
+        alloc_stats_record(file, line, size);
+
     // simple things simple!
     void *rv = malloc(size);
     if (rv == NULL) {
@@ -27,8 +133,11 @@ bc_malloc(size_t size)
 
 
 void*
-bc_realloc(void *ptr, size_t size)
+bc_realloc_at(const char *file, int line, void *ptr, size_t size)
 {
+    if (alloc_stats_enabled)
+        alloc_stats_record(file, line, size);
+
     // simple things even simpler :P
     void *rv = realloc(ptr, size);
     if (rv == NULL && size != 0) {
@@ -58,6 +167,30 @@ bc_slist_append(bc_slist_t *l, void *data)
 }
 
 
+// same as bc_slist_append, but keeps track of the last node in *tail, to make
+// appending to long lists O(1). *tail may be NULL for a non-empty list, the
+// list is walked once in that case.
+bc_slist_t*
+bc_slist_append_tail(bc_slist_t *l, bc_slist_t **tail, void *data)
+{
+    bc_slist_t *node = bc_malloc(sizeof(bc_slist_t));
+    node->data = data;
+    node->next = NULL;
+    if (l == NULL) {
+        l = node;
+    }
+    else {
+        bc_slist_t *tmp = *tail;
+        if (tmp == NULL)
+            tmp = l;
+        for (; tmp->next != NULL; tmp = tmp->next);
+        tmp->next = node;
+    }
+    *tail = node;
+    return l;
+}
+
+
 bc_slist_t*
 bc_slist_prepend(bc_slist_t *l, void *data)
 {
@@ -118,11 +251,13 @@ bc_slist_length(bc_slist_t *l)
 
 
 char*
-bc_strdup(const char *s)
+bc_strdup_at(const char *file, int line, const char *s)
 {
     if (s == NULL)
         return NULL;
     size_t l = strlen(s);
+    if (alloc_stats_enabled)
+        alloc_stats_record(file, line, l + 1);
     char *tmp = malloc(l + 1);
     if (tmp == NULL)
         return NULL;
@@ -132,11 +267,13 @@ bc_strdup(const char *s)
 
 
 char*
-bc_strndup(const char *s, size_t n)
+bc_strndup_at(const char *file, int line, const char *s, size_t n)
 {
     if (s == NULL)
         return NULL;
     size_t l = strnlen(s, n);
+    if (alloc_stats_enabled)
+        alloc_stats_record(file, line, l + 1);
     char *tmp = malloc(l + 1);
     if (tmp == NULL)
         return NULL;
@@ -147,7 +284,7 @@ bc_strndup(const char *s, size_t n)
 
 
 char*
-bc_strdup_vprintf(const char *format, va_list ap)
+bc_strdup_vprintf_at(const char *file, int line, const char *format, va_list ap)
 {
     if (format == NULL)
         return NULL;
@@ -157,6 +294,8 @@ bc_strdup_vprintf(const char *format, va_list ap)
     va_end(ap2);
     if (l < 0)
         return NULL;
+    if (alloc_stats_enabled)
+        alloc_stats_record(file, line, l + 1);
     char *tmp = malloc(l + 1);
     if (!tmp)
         return NULL;
@@ -170,13 +309,13 @@ bc_strdup_vprintf(const char *format, va_list ap)
 
 
 char*
-bc_strdup_printf(const char *format, ...)
+bc_strdup_printf_at(const char *file, int line, const char *format, ...)
 {
     if (format == NULL)
         return NULL;
     va_list ap;
     va_start(ap, format);
-    char *tmp = bc_strdup_vprintf(format, ap);
+    char *tmp = bc_strdup_vprintf_at(file, line, format, ap);
     va_end(ap);
     return tmp;
 }
@@ -274,7 +413,8 @@ bc_str_split(const char *str, char c, size_t max_pieces)
         return NULL;
     char **rv = bc_malloc(sizeof(char*));
     size_t i, start = 0, count = 0;
-    for (i = 0; i < strlen(str) + 1; i++) {
+    size_t str_len = strlen(str);
+    for (i = 0; i < str_len + 1; i++) {
         if (str[0] == '\0')
             break;
         if ((str[i] == c && (!max_pieces || count + 1 < max_pieces)) || str[i] == '\0') {
@@ -294,14 +434,21 @@ bc_str_split(const char *str, char c, size_t max_pieces)
 char*
 bc_str_replace(const char *str, const char search, const char *replace)
 {
-    char **pieces = bc_str_split(str, search, 0);
-    if (pieces == NULL)
+    if (str == NULL)
         return NULL;
-    char* rv = bc_strv_join(pieces, replace);
-    bc_strv_free(pieces);
-    if (rv == NULL)
+    if (replace == NULL)
         return bc_strdup(str);
-    return rv;
+    bc_string_t *rv = bc_string_new_sized(strlen(str));
+    bc_strview_t iter = bc_strview(str);
+    bc_strview_t piece;
+    bool first = true;
+    while (bc_strview_split_next(&iter, search, &piece)) {
+        if (!first)
+            bc_string_append(rv, replace);
+        bc_string_append_len(rv, piece.str, piece.len);
+        first = false;
+    }
+    return bc_string_free(rv, false);
 }
 
 
@@ -388,6 +535,125 @@ bc_strv_length(char **strv)
 }
 
 
+bc_strview_t
+bc_strview(const char *str)
+{
+    bc_strview_t rv = {str, str == NULL ? 0 : strlen(str)};
+    return rv;
+}
+
+
+bc_strview_t
+bc_strview_len(const char *str, size_t len)
+{
+    bc_strview_t rv = {str, str == NULL ? 0 : len};
+    return rv;
+}
+
+
+char*
+bc_strview_dup(bc_strview_t view)
+{
+    if (view.str == NULL)
+        return NULL;
+    return bc_strndup(view.str, view.len);
+}
+
+
+bool
+bc_strview_equal(bc_strview_t a, bc_strview_t b)
+{
+    if (a.str == NULL || b.str == NULL)
+        return a.str == b.str;
+    return a.len == b.len && 0 == memcmp(a.str, b.str, a.len);
+}
+
+
+bool
+bc_strview_equal_str(bc_strview_t view, const char *str)
+{
+    return bc_strview_equal(view, bc_strview(str));
+}
+
+
+int
+bc_strview_compare(bc_strview_t a, bc_strview_t b)
+{
+    // same ordering as strcmp(), for views without embedded NULs.
+    int rv = memcmp(a.str, b.str, a.len < b.len ? a.len : b.len);
+    if (rv != 0 || a.len == b.len)
+        return rv;
+    return a.len < b.len ? -1 : 1;
+}
+
+
+bc_strview_t
+bc_strview_lstrip(bc_strview_t view)
+{
+    while (view.len > 0 && bc_isspace(view.str[0])) {
+        view.str++;
+        view.len--;
+    }
+    return view;
+}
+
+
+bc_strview_t
+bc_strview_rstrip(bc_strview_t view)
+{
+    while (view.len > 0 && bc_isspace(view.str[view.len - 1]))
+        view.len--;
+    return view;
+}
+
+
+bc_strview_t
+bc_strview_strip(bc_strview_t view)
+{
+    return bc_strview_lstrip(bc_strview_rstrip(view));
+}
+
+
+bool
+bc_strview_split_next(bc_strview_t *iter, char c, bc_strview_t *piece)
+{
+    // iter is consumed piece by piece, and set to a NULL view after the last
+    // one. like bc_str_split, empty pieces are returned, but an empty view
+    // yields a single empty piece.
+    if (iter == NULL || iter->str == NULL)
+        return false;
+    const char *end = memchr(iter->str, c, iter->len);
+    if (end == NULL) {
+        *piece = *iter;
+        iter->str = NULL;
+        iter->len = 0;
+        return true;
+    }
+    piece->str = iter->str;
+    piece->len = end - iter->str;
+    iter->len -= piece->len + 1;
+    iter->str = end + 1;
+    return true;
+}
+
+
+static void
+bc_string_grow(bc_string_t *str, size_t len)
+{
+    // grow geometrically, so that appending to a large string costs amortized
+    // constant time instead of a realloc every BC_STRING_CHUNK_SIZE bytes.
+    if (len + 1 <= str->allocated_len)
+        return;
+    size_t allocated_len = str->allocated_len;
+    if (allocated_len < BC_STRING_CHUNK_SIZE)
+        allocated_len = BC_STRING_CHUNK_SIZE;
+    while (allocated_len < len + 1)
+        allocated_len *= 2;
+    str->allocated_len = allocated_len;
+    str->str = bc_realloc(str->str, str->allocated_len);
+}
+
+
 bc_string_t*
 bc_string_new(void)
 {
@@ -403,6 +669,35 @@ bc_string_new(void)
 }
 
 
+bc_string_t*
+bc_string_new_sized(size_t len)
+{
+    bc_string_t* rv = bc_malloc(sizeof(bc_string_t));
+    rv->str = NULL;
+    rv->len = 0;
+    rv->allocated_len = 0;
+    rv = bc_string_reserve(rv, len);
+    rv->str[0] = '\0';
+    return rv;
+}
+
+
+bc_string_t*
+bc_string_reserve(bc_string_t *str, size_t len)
+{
+    // unlike the growth done by the append functions, reserve the exact
+    // amount requested (rounded up to BC_STRING_CHUNK_SIZE), as callers
+    // usually know the final size of the string.
+    if (str == NULL)
+        return NULL;
+    if (len + 1 <= str->allocated_len)
+        return str;
+    str->allocated_len = ((len / BC_STRING_CHUNK_SIZE) + 1) * BC_STRING_CHUNK_SIZE;
+    str->str = bc_realloc(str->str, str->allocated_len);
+    return str;
+}
+
+
 char*
 bc_string_free(bc_string_t *str, bool free_str)
 {
@@ -423,7 +718,7 @@ bc_string_dup(bc_string_t *str)
 {
     if (str == NULL)
         return NULL;
-    bc_string_t* new = bc_string_new();
+    bc_string_t* new = bc_string_new_sized(str->len);
     return bc_string_append_len(new, str->str, str->len);
 }
 
@@ -437,10 +732,7 @@ bc_string_append_len(bc_string_t *str, const char *suffix, size_t len)
         return str;
     size_t old_len = str->len;
     str->len += len;
-    if (str->len + 1 > str->allocated_len) {
-        str->allocated_len = (((str->len + 1) / BC_STRING_CHUNK_SIZE) + 1) * BC_STRING_CHUNK_SIZE;
-        str->str = bc_realloc(str->str, str->allocated_len);
-    }
+    bc_string_grow(str, str->len);
     memcpy(str->str + old_len, suffix, len);
     str->str[str->len] = '\0';
     return str;
@@ -464,10 +756,7 @@ bc_string_append_c(bc_string_t *str, char c)
         return NULL;
     size_t old_len = str->len;
     str->len += 1;
-    if (str->len + 1 > str->allocated_len) {
-        str->allocated_len = (((str->len + 1) / BC_STRING_CHUNK_SIZE) + 1) * BC_STRING_CHUNK_SIZE;
-        str->str = bc_realloc(str->str, str->allocated_len);
-    }
+    bc_string_grow(str, str->len);
     str->str[old_len] = c;
     str->str[str->len] = '\0';
     return str;
@@ -515,135 +804,128 @@ bc_trie_t*
 bc_trie_new(bc_free_func_t free_func)
 {
     bc_trie_t *trie = bc_malloc(sizeof(bc_trie_t));
-    trie->root = NULL;
+    trie->entries = NULL;
+    trie->len = 0;
+    trie->allocated_len = 0;
+    trie->buckets = NULL;
+    trie->buckets_len = 0;
     trie->free_func = free_func;
+    trie->arena = NULL;
     return trie;
 }
 
 
-static void
-bc_trie_free_node(bc_trie_t *trie, bc_trie_node_t *node)
-{
-    if (trie == NULL || node == NULL)
-        return;
-    if (node->data != NULL && trie->free_func != NULL)
-        trie->free_func(node->data);
-    bc_trie_free_node(trie, node->next);
-    bc_trie_free_node(trie, node->child);
-    free(node);
-}
-
-
 void
 bc_trie_free(bc_trie_t *trie)
 {
     if (trie == NULL)
         return;
-    bc_trie_free_node(trie, trie->root);
+    if (trie->free_func != NULL) {
+        for (size_t i = 0; i < trie->len; i++)
+            trie->free_func(trie->entries[i].data);
+    }
+    free(trie->entries);
+    free(trie->buckets);
+    bc_arena_free(trie->arena);
     free(trie);
 }
 
 
-void
-bc_trie_insert(bc_trie_t *trie, const char *key, void *data)
+static size_t
+bc_trie_hash(const char *key)
 {
-    if (trie == NULL || key == NULL || data == NULL)
-        return;
-
-    bc_trie_node_t *parent = NULL;
-    bc_trie_node_t *previous;
-    bc_trie_node_t *current;
-    bc_trie_node_t *tmp;
-
-    while (1) {
-
-        if (trie->root == NULL || (parent != NULL && parent->child == NULL)) {
-            current = bc_malloc(sizeof(bc_trie_node_t));
-            current->key = *key;
-            current->data = NULL;
-            current->next = NULL;
-            current->child = NULL;
-            if (trie->root == NULL)
-                trie->root = current;
-            else
-                parent->child = current;
-            parent = current;
-            goto clean;
-        }
-
-        tmp = parent == NULL ? trie->root : parent->child;
-        previous = NULL;
-
-        while (tmp != NULL && tmp->key != *key) {
-            previous = tmp;
-            tmp = tmp->next;
-        }
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; key[i] != '\0'; i++) {
+        hash ^= (unsigned char) key[i];
+        hash *= 1099511628211ULL;
+    }
+    return (size_t) hash;
+}
 
-        parent = tmp;
 
-        if (previous == NULL || parent != NULL)
-            goto clean;
+static size_t*
+bc_trie_find_bucket(bc_trie_t *trie, const char *key, size_t hash)
+{
+    // buckets store the index of the entry plus one, 0 means empty bucket.
+    // buckets_len is always a power of 2, and there are always free buckets.
+    size_t mask = trie->buckets_len - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if (trie->buckets[i] == 0)
+            return trie->buckets + i;
+        bc_trie_entry_t *entry = trie->entries + trie->buckets[i] - 1;
+        if (entry->hash == hash && 0 == strcmp(entry->key, key))
+            return trie->buckets + i;
+    }
+}
 
-        current = bc_malloc(sizeof(bc_trie_node_t));
-        current->key = *key;
-        current->data = NULL;
-        current->next = NULL;
-        current->child = NULL;
-        previous->next = current;
-        parent = current;
 
-clean:
-        if (*key == '\0') {
-            if (parent->data != NULL && trie->free_func != NULL)
-                trie->free_func(parent->data);
-            parent->data = data;
-            break;
-        }
-        key++;
+static void
+bc_trie_grow(bc_trie_t *trie)
+{
+    trie->allocated_len = trie->allocated_len == 0 ? BC_TRIE_INITIAL_SIZE :
+        trie->allocated_len * 2;
+    trie->entries = bc_realloc(trie->entries,
+        trie->allocated_len * sizeof(bc_trie_entry_t));
+
+    // keep the load factor of the buckets at most 0.5.
+    trie->buckets_len = trie->allocated_len * 2;
+    free(trie->buckets);
+    trie->buckets = bc_malloc(trie->buckets_len * sizeof(size_t));
+    memset(trie->buckets, 0, trie->buckets_len * sizeof(size_t));
+    size_t mask = trie->buckets_len - 1;
+    for (size_t i = 0; i < trie->len; i++) {
+        size_t j = trie->entries[i].hash & mask;
+        while (trie->buckets[j] != 0)
+            j = (j + 1) & mask;
+        trie->buckets[j] = i + 1;
     }
 }
 
 
-void*
-bc_trie_lookup(bc_trie_t *trie, const char *key)
+void
+bc_trie_insert(bc_trie_t *trie, const char *key, void *data)
 {
-    if (trie == NULL || trie->root == NULL || key == NULL)
-        return NULL;
+    if (trie == NULL || key == NULL || data == NULL)
+        return;
 
-    bc_trie_node_t *parent = trie->root;
-    bc_trie_node_t *tmp;
-    while (1) {
-        for (tmp = parent; tmp != NULL; tmp = tmp->next) {
+    size_t hash = bc_trie_hash(key);
 
-            if (tmp->key == *key) {
-                if (tmp->key == '\0')
-                    return tmp->data;
-                parent = tmp->child;
-                break;
-            }
+    if (trie->buckets != NULL) {
+        size_t *bucket = bc_trie_find_bucket(trie, key, hash);
+        if (*bucket != 0) {
+            bc_trie_entry_t *entry = trie->entries + *bucket - 1;
+            if (entry->data != NULL && trie->free_func != NULL)
+                trie->free_func(entry->data);
+            entry->data = data;
+            return;
         }
-        if (tmp == NULL)
-            return NULL;
-
-        if (*key == '\0')
-            break;
-        key++;
     }
-    return NULL;
+
+    if (trie->len == trie->allocated_len)
+        bc_trie_grow(trie);
+
+    if (trie->arena == NULL)
+        trie->arena = bc_arena_new(BC_TRIE_ARENA_CHUNK_SIZE);
+
+    bc_trie_entry_t *entry = trie->entries + trie->len++;
+    entry->key = bc_arena_strdup(trie->arena, key);
+    entry->data = data;
+    entry->hash = hash;
+    *bc_trie_find_bucket(trie, key, hash) = trie->len;
 }
 
 
-static void
-bc_trie_size_node(bc_trie_node_t *node, size_t *count)
+void*
+bc_trie_lookup(bc_trie_t *trie, const char *key)
 {
-    if (node == NULL || count == NULL)
-        return;
-
-    if (node->key == '\0')
-        (*count)++;
+    if (trie == NULL || trie->buckets == NULL || key == NULL)
+        return NULL;
 
-    bc_trie_size_node(node->next, count);
-    bc_trie_size_node(node->child, count);
+    size_t *bucket = bc_trie_find_bucket(trie, key, bc_trie_hash(key));
+    if (*bucket == 0)
+        return NULL;
+    return trie->entries[*bucket - 1].data;
 }
 
 
@@ -652,32 +934,7 @@ bc_trie_size(bc_trie_t *trie)
 {
     if (trie == NULL)
         return 0;
-
-    size_t count = 0;
-    bc_trie_size_node(trie->root, &count);
-    return count;
-}
-
-
-static void
-bc_trie_foreach_node(bc_trie_node_t *node, bc_string_t *str,
-    bc_trie_foreach_func_t func, void *user_data)
-{
-    if (node == NULL || str == NULL || func == NULL)
-        return;
-
-    if (node->key == '\0')
-        func(str->str, node->data, user_data);
-
-    if (node->child != NULL) {
-        bc_string_t *child = bc_string_dup(str);
-        child = bc_string_append_c(child, node->key);
-        bc_trie_foreach_node(node->child, child, func, user_data);
-        bc_string_free(child, true);
-    }
-
-    if (node->next != NULL)
-        bc_trie_foreach_node(node->next, str, func, user_data);
+    return trie->len;
 }
 
 
@@ -685,12 +942,11 @@ void
 bc_trie_foreach(bc_trie_t *trie, bc_trie_foreach_func_t func,
     void *user_data)
 {
-    if (trie == NULL || trie->root == NULL || func == NULL)
+    if (trie == NULL || func == NULL)
         return;
 
-    bc_string_t *str = bc_string_new();
-    bc_trie_foreach_node(trie->root, str, func, user_data);
-    bc_string_free(str, true);
+    for (size_t i = 0; i < trie->len; i++)
+        func(trie->entries[i].key, trie->entries[i].data, user_data);
 }
 
 
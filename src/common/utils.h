@@ -6,14 +6,45 @@
 #include <stddef.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include "arena.h"
 
 
 // memory
 
 typedef void (*bc_free_func_t) (void *ptr);
 
-void* bc_malloc(size_t size);
-void* bc_realloc(void *ptr, size_t size);
+void* bc_malloc_at(const char *file, int line, size_t size);
+void* bc_realloc_at(const char *file, int line, void *ptr, size_t size);
+
+#define bc_malloc(size) bc_malloc_at(__FILE__, __LINE__, (size))
+#define bc_realloc(ptr, size) bc_realloc_at(__FILE__, __LINE__, (ptr), (size))
+
+
+// allocation stats. disabled by default. allocations done by bc_malloc,
+// bc_realloc and the bc_strdup family are accounted per call site, frees
+// aren't tracked. not thread-safe.
+
+#define BC_ALLOC_STATS_HISTOGRAM_SIZE 32
+#define BC_ALLOC_STATS_MAX_SITES 1024
+
+typedef struct {
+    size_t calls;
+    size_t bytes;
+    size_t histogram[BC_ALLOC_STATS_HISTOGRAM_SIZE];
+} bc_alloc_stats_t;
+
+typedef struct {
+    const char *file;
+    int line;
+    size_t calls;
+    size_t bytes;
+} bc_alloc_site_t;
+
+void bc_alloc_stats_enable(bool enable);
+bool bc_alloc_stats_enabled(void);
+void bc_alloc_stats_reset(void);
+void bc_alloc_stats_get(bc_alloc_stats_t *stats);
+size_t bc_alloc_stats_get_sites(bc_alloc_site_t *sites, size_t len);
 
 
 // slist
@@ -24,6 +55,7 @@ typedef struct _bc_slist_t {
 } bc_slist_t;
 
 bc_slist_t* bc_slist_append(bc_slist_t *l, void *data);
+bc_slist_t* bc_slist_append_tail(bc_slist_t *l, bc_slist_t **tail, void *data);
 bc_slist_t* bc_slist_prepend(bc_slist_t *l, void *data);
 bc_slist_t* bc_slist_append_list(bc_slist_t *l, bc_slist_t *n);
 void bc_slist_free(bc_slist_t *l);
@@ -33,10 +65,17 @@ size_t bc_slist_length(bc_slist_t *l);
 
 // strfuncs
 
-char* bc_strdup(const char *s);
-char* bc_strndup(const char *s, size_t n);
-char* bc_strdup_vprintf(const char *format, va_list ap);
-char* bc_strdup_printf(const char *format, ...);
+char* bc_strdup_at(const char *file, int line, const char *s);
+char* bc_strndup_at(const char *file, int line, const char *s, size_t n);
+char* bc_strdup_vprintf_at(const char *file, int line, const char *format,
+    va_list ap);
+char* bc_strdup_printf_at(const char *file, int line, const char *format, ...);
+
+#define bc_strdup(s) bc_strdup_at(__FILE__, __LINE__, (s))
+#define bc_strndup(s, n) bc_strndup_at(__FILE__, __LINE__, (s), (n))
+#define bc_strdup_vprintf(format, ap) \
+    bc_strdup_vprintf_at(__FILE__, __LINE__, (format), (ap))
+#define bc_strdup_printf(...) bc_strdup_printf_at(__FILE__, __LINE__, __VA_ARGS__)
 bool bc_isspace(int c);
 bool bc_str_starts_with(const char *str, const char *prefix);
 bool bc_str_ends_with(const char *str, const char *suffix);
@@ -52,6 +91,28 @@ char* bc_strv_join(char **strv, const char *separator);
 size_t bc_strv_length(char **strv);
 
 
+// strview
+
+// non-owning, not necessarily NUL-terminated, slice of a string. none of the
+// functions below allocate memory, except for bc_strview_dup.
+
+typedef struct {
+    const char *str;
+    size_t len;
+} bc_strview_t;
+
+bc_strview_t bc_strview(const char *str);
+bc_strview_t bc_strview_len(const char *str, size_t len);
+char* bc_strview_dup(bc_strview_t view);
+bool bc_strview_equal(bc_strview_t a, bc_strview_t b);
+bool bc_strview_equal_str(bc_strview_t view, const char *str);
+int bc_strview_compare(bc_strview_t a, bc_strview_t b);
+bc_strview_t bc_strview_lstrip(bc_strview_t view);
+bc_strview_t bc_strview_rstrip(bc_strview_t view);
+bc_strview_t bc_strview_strip(bc_strview_t view);
+bool bc_strview_split_next(bc_strview_t *iter, char c, bc_strview_t *piece);
+
+
 // string
 
 typedef struct {
@@ -61,6 +122,8 @@ typedef struct {
 } bc_string_t;
 
 bc_string_t* bc_string_new(void);
+bc_string_t* bc_string_new_sized(size_t len);
+bc_string_t* bc_string_reserve(bc_string_t *str, size_t len);
 char* bc_string_free(bc_string_t *str, bool free_str);
 bc_string_t* bc_string_dup(bc_string_t *str);
 bc_string_t* bc_string_append_len(bc_string_t *str, const char *suffix, size_t len);
@@ -72,15 +135,25 @@ bc_string_t* bc_string_append_escaped(bc_string_t *str, const char *suffix);
 
 // trie
 
-typedef struct _bc_trie_node_t {
-    char key;
+// despite the name, this is an insertion-ordered hash table (open addressing,
+// linear probing). the name is kept for historical reasons.
+
+typedef struct {
+    char *key;
     void *data;
-    struct _bc_trie_node_t *next, *child;
-} bc_trie_node_t;
+    size_t hash;
+} bc_trie_entry_t;
 
 struct _bc_trie_t {
-    bc_trie_node_t *root;
+    bc_trie_entry_t *entries;
+    size_t len;
+    size_t allocated_len;
+    size_t *buckets;
+    size_t buckets_len;
     bc_free_func_t free_func;
+
+    // keys are allocated from here, and released together with the trie.
+    bc_arena_t *arena;
 };
 
 typedef struct _bc_trie_t bc_trie_t;
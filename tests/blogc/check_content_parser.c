@@ -6,6 +6,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdlib.h>
+#include "../../src/common/utils.h"
 #include "../../src/blogc/toctree.h"
 #include "../../src/blogc/content-parser.h"
 
@@ -2727,6 +2728,110 @@ test_content_parse_inline_endash_emdash(void **state)
 }
 
 
+static void
+test_content_parse_inline_unmatched(void **state)
+{
+    char *html = blogc_content_parse_inline("*_a*_");
+    assert_non_null(html);
+    assert_string_equal(html, "<em>_a</em>_");
+    free(html);
+    html = blogc_content_parse_inline("__a*b__c*");
+    assert_non_null(html);
+    assert_string_equal(html, "<strong>a*b</strong>c*");
+    free(html);
+    html = blogc_content_parse_inline("*a _b* c_");
+    assert_non_null(html);
+    assert_string_equal(html, "<em>a _b</em> c_");
+    free(html);
+    html = blogc_content_parse_inline("[a [b](c)");
+    assert_non_null(html);
+    assert_string_equal(html, "[a <a href=\"c\">b</a>");
+    free(html);
+    html = blogc_content_parse_inline("[a](b [c](d\\*e");
+    assert_non_null(html);
+    assert_string_equal(html, "[a](b [c](d*e");
+    free(html);
+    html = blogc_content_parse_inline("![a](b \\\\ [c](d");
+    assert_non_null(html);
+    assert_string_equal(html, "![a](b  [c](d");
+    free(html);
+}
+
+
+static void
+test_content_parse_len(void **state)
+{
+    const char *src =
+        "# foo\n"
+        "\n"
+        "- a\n"
+        "- b\n"
+        "\n"
+        "bar baz";
+    size_t l = 0;
+    char *t = NULL;
+    char *html = blogc_content_parse_len(src, strlen(src) - 4, &l, &t, NULL,
+        NULL, NULL);
+    assert_non_null(html);
+    assert_int_equal(l, 0);
+    assert_non_null(t);
+    assert_string_equal(t, "foo");
+    assert_string_equal(html,
+        "<h1 id=\"foo\">foo</h1>\n"
+        "<ul>\n"
+        "<li>a</li>\n"
+        "<li>b</li>\n"
+        "</ul>\n"
+        "<p>bar</p>\n");
+    free(html);
+    free(t);
+    html = blogc_content_parse_len("- a\n- b\nc\n\n- d\n", 15, NULL, NULL,
+        NULL, NULL, NULL);
+    assert_non_null(html);
+    assert_string_equal(html,
+        "<p>- a\n"
+        "- b\n"
+        "c</p>\n"
+        "<ul>\n"
+        "<li>d</li>\n"
+        "</ul>\n");
+    free(html);
+}
+
+
+static void
+test_content_parse_alloc_budget(void **state)
+{
+    bc_string_t *src = bc_string_new();
+    for (size_t i = 0; i < 10; i++)
+        bc_string_append_printf(src,
+            "## Section %zu\n"
+            "\n"
+            "Some *emphasis* and **strong** text with a [link](http://example.com/%zu)\n"
+            "and `code`, over two lines.\n"
+            "\n"
+            "- item 1\n"
+            "- item 2\n"
+            "\n"
+            "    code block\n"
+            "\n", i, i);
+    size_t end_excerpt;
+    char *description = NULL;
+    bc_alloc_stats_reset();
+    bc_alloc_stats_enable(true);
+    char *html = blogc_content_parse(src->str, &end_excerpt, NULL, &description,
+        NULL, NULL);
+    bc_alloc_stats_enable(false);
+    assert_non_null(html);
+    bc_alloc_stats_t stats;
+    bc_alloc_stats_get(&stats);
+    assert_true(stats.calls <= 700);
+    free(html);
+    free(description);
+    bc_string_free(src, true);
+}
+
+
 int
 main(void)
 {
@@ -2736,6 +2841,7 @@ main(void)
         cmocka_unit_test(test_fix_description),
         cmocka_unit_test(test_is_ordered_list_item),
         cmocka_unit_test(test_content_parse),
+        cmocka_unit_test(test_content_parse_len),
         cmocka_unit_test(test_content_parse_crlf),
         cmocka_unit_test(test_content_parse_with_excerpt),
         cmocka_unit_test(test_content_parse_with_excerpt_crlf),
@@ -2779,6 +2885,8 @@ main(void)
         cmocka_unit_test(test_content_parse_inline_line_break),
         cmocka_unit_test(test_content_parse_inline_line_break_crlf),
         cmocka_unit_test(test_content_parse_inline_endash_emdash),
+        cmocka_unit_test(test_content_parse_inline_unmatched),
+        cmocka_unit_test(test_content_parse_alloc_budget),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
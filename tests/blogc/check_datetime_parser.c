@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <cmocka.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <locale.h>
 #include "../../src/common/error.h"
@@ -625,6 +626,29 @@ test_convert_datetime_invalid_format_long(void **state)
 }
 
 
+static void
+test_convert_datetime_timestamp(void **state)
+{
+    bc_error_t *err = NULL;
+    int64_t t1 = 0;
+    int64_t t2 = 0;
+    assert_true(blogc_convert_datetime_timestamp("2010-11-30", &t1, &err));
+    assert_null(err);
+    assert_true(blogc_convert_datetime_timestamp("2010-11-30 12:13:14", &t2,
+        &err));
+    assert_null(err);
+    assert_int_equal(t2 - t1, 12 * 3600 + 13 * 60 + 14);
+    assert_false(blogc_convert_datetime_timestamp("2010-11-30 1", &t1, &err));
+    assert_non_null(err);
+    assert_int_equal(err->type, BLOGC_WARNING_DATETIME_PARSER);
+    assert_string_equal(err->msg,
+        "Invalid datetime string. Found '2010-11-30 1', formats allowed are: "
+        "'yyyy-mm-dd hh:mm:ss', 'yyyy-mm-dd hh:ss', 'yyyy-mm-dd hh' and "
+        "'yyyy-mm-dd'.");
+    bc_error_free(err);
+}
+
+
 int
 main(void)
 {
@@ -634,6 +658,7 @@ main(void)
         cmocka_unit_test(test_convert_datetime_implicit_seconds),
         cmocka_unit_test(test_convert_datetime_implicit_minutes),
         cmocka_unit_test(test_convert_datetime_implicit_hours),
+        cmocka_unit_test(test_convert_datetime_timestamp),
         cmocka_unit_test(test_convert_datetime_invalid_formats),
         cmocka_unit_test(test_convert_datetime_invalid_1st_year),
         cmocka_unit_test(test_convert_datetime_invalid_2nd_year),
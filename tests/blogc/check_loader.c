@@ -9,6 +9,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "../../src/common/error.h"
+#include "../../src/common/file.h"
 #include "../../src/common/utils.h"
 #include "../../src/blogc/template-parser.h"
 #include "../../src/blogc/loader.h"
@@ -44,18 +45,22 @@ test_get_filename(void **state)
 }
 
 
-char*
-__wrap_bc_file_get_contents(const char *path, bool utf8, size_t *len, bc_error_t **err)
+bc_file_map_t*
+__wrap_bc_file_map(const char *path, bool utf8, bc_error_t **err)
 {
     assert_true(utf8);
     assert_null(*err);
     const char *_path = mock_type(const char*);
     if (_path != NULL)
         assert_string_equal(path, _path);
-    char *rv = mock_type(char*);
-    *len = 0;
-    if (rv != NULL)
-        *len = strlen(rv);
+    char *str = mock_type(char*);
+    if (str == NULL)
+        return NULL;
+    bc_file_map_t *rv = bc_malloc(sizeof(bc_file_map_t));
+    rv->str = str;
+    rv->len = strlen(str);
+    rv->map = NULL;
+    rv->map_len = 0;
     return rv;
 }
 
@@ -64,13 +69,13 @@ static void
 test_template_parse_from_file(void **state)
 {
     bc_error_t *err = NULL;
-    will_return(__wrap_bc_file_get_contents, "bola");
-    will_return(__wrap_bc_file_get_contents, bc_strdup("{{ BOLA }}\n"));
-    bc_slist_t *l = blogc_template_parse_from_file("bola", &err);
+    will_return(__wrap_bc_file_map, "bola");
+    will_return(__wrap_bc_file_map, bc_strdup("{{ BOLA }}\n"));
+    blogc_template_t *l = blogc_template_parse_from_file("bola", &err);
     assert_null(err);
     assert_non_null(l);
-    assert_int_equal(bc_slist_length(l), 2);
-    blogc_template_free_ast(l);
+    assert_int_equal(l->nodes_len, 2);
+    blogc_template_free(l);
 }
 
 
@@ -78,25 +83,46 @@ static void
 test_template_parse_from_file_null(void **state)
 {
     bc_error_t *err = NULL;
-    will_return(__wrap_bc_file_get_contents, "bola");
-    will_return(__wrap_bc_file_get_contents, NULL);
-    bc_slist_t *l = blogc_template_parse_from_file("bola", &err);
+    will_return(__wrap_bc_file_map, "bola");
+    will_return(__wrap_bc_file_map, NULL);
+    blogc_template_t *l = blogc_template_parse_from_file("bola", &err);
     assert_null(err);
     assert_null(l);
 }
 
 
+static void
+test_get_source_fields(void **state)
+{
+    assert_int_equal(blogc_get_source_fields(NULL), BLOGC_SOURCE_FIELD_ALL);
+    const char *a = "{% block listing %}{{ TITLE }}{{ DATE_FORMATTED }}{% endblock %}";
+    bc_error_t *err = NULL;
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_int_equal(blogc_get_source_fields(tmpl), 0);
+    blogc_template_free(tmpl);
+    a = "{{ DESCRIPTION }}{% ifdef TOCTREE %}{{ EXCERPT_100 }}{% endif %}";
+    tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_int_equal(blogc_get_source_fields(tmpl),
+        BLOGC_SOURCE_FIELD_CONTENT | BLOGC_SOURCE_FIELD_EXCERPT |
+        BLOGC_SOURCE_FIELD_TOCTREE);
+    blogc_template_free(tmpl);
+}
+
+
 static void
 test_source_parse_from_file(void **state)
 {
     bc_error_t *err = NULL;
-    will_return(__wrap_bc_file_get_contents, "bola.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "--------\n"
         "bola"));
     bc_trie_t *c = bc_trie_new(free);
-    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt", &err);
+    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt",
+        BLOGC_SOURCE_FIELD_ALL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_trie_size(t), 6);
@@ -115,8 +141,8 @@ static void
 test_source_parse_from_file_maxdepth(void **state)
 {
     bc_error_t *err = NULL;
-    will_return(__wrap_bc_file_get_contents, "bola.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "TOCTREE_MAXDEPTH: 1\n"
         "--------\n"
@@ -124,7 +150,8 @@ test_source_parse_from_file_maxdepth(void **state)
         "#### guda"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "TOCTREE_MAXDEPTH", bc_strdup("-1"));
-    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt", &err);
+    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt",
+        BLOGC_SOURCE_FIELD_ALL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_trie_size(t), 8);
@@ -154,15 +181,16 @@ static void
 test_source_parse_from_file_maxdepth2(void **state)
 {
     bc_error_t *err = NULL;
-    will_return(__wrap_bc_file_get_contents, "bola.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "--------\n"
         "### bola\n"
         "#### guda"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "TOCTREE_MAXDEPTH", bc_strdup("1"));
-    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt", &err);
+    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt",
+        BLOGC_SOURCE_FIELD_ALL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_trie_size(t), 7);
@@ -191,10 +219,11 @@ static void
 test_source_parse_from_file_null(void **state)
 {
     bc_error_t *err = NULL;
-    will_return(__wrap_bc_file_get_contents, "bola.txt");
-    will_return(__wrap_bc_file_get_contents, NULL);
+    will_return(__wrap_bc_file_map, "bola.txt");
+    will_return(__wrap_bc_file_map, NULL);
     bc_trie_t *c = bc_trie_new(free);
-    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt", &err);
+    bc_trie_t *t = blogc_source_parse_from_file(c, "bola.txt",
+        BLOGC_SOURCE_FIELD_ALL, &err);
     assert_null(err);
     assert_null(t);
     bc_trie_free(c);
@@ -204,20 +233,20 @@ test_source_parse_from_file_null(void **state)
 static void
 test_source_parse_from_files(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
@@ -228,7 +257,8 @@ test_source_parse_from_files(void **state)
     s = bc_slist_append(s, bc_strdup("bola2.txt"));
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 3);  // it is enough, no need to look at the items
@@ -246,20 +276,20 @@ test_source_parse_from_files(void **state)
 static void
 test_source_parse_from_files_filter_sort(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-02 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2001-02-01 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2011-02-03 04:05:06\n"
         "--------\n"
@@ -271,7 +301,8 @@ test_source_parse_from_files_filter_sort(void **state)
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_SORT", bc_strdup("1"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 3);  // it is enough, no need to look at the items
@@ -290,22 +321,22 @@ test_source_parse_from_files_filter_sort(void **state)
 static void
 test_source_parse_from_files_filter_reverse(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "TAGS: chunda\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "TAGS: bola, chunda\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
@@ -317,16 +348,18 @@ test_source_parse_from_files_filter_reverse(void **state)
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_REVERSE", bc_strdup("1"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 3);  // it is enough, no need to look at the items
-    assert_int_equal(bc_trie_size(c), 5);
+    assert_int_equal(bc_trie_size(c), 6);
     assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola3");
     assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola1");
     assert_string_equal(bc_trie_lookup(c, "DATE_FIRST"), "2003-02-03 04:05:06");
     assert_string_equal(bc_trie_lookup(c, "DATE_LAST"), "2001-02-03 04:05:06");
     assert_string_equal(bc_trie_lookup(c, "FILTER_REVERSE"), "1");
+    assert_string_equal(bc_trie_lookup(c, "TAG_COUNTS"), "bola,:1 chunda:2");
     bc_trie_free(c);
     bc_slist_free_full(s, free);
     bc_slist_free_full(t, (bc_free_func_t) bc_trie_free);
@@ -336,20 +369,20 @@ test_source_parse_from_files_filter_reverse(void **state)
 static void
 test_source_parse_from_files_filter_sort_reverse(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-02 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2001-02-01 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2011-02-03 04:05:06\n"
         "--------\n"
@@ -362,7 +395,8 @@ test_source_parse_from_files_filter_sort_reverse(void **state)
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_SORT", bc_strdup("1"));
     bc_trie_insert(c, "FILTER_REVERSE", bc_strdup("1"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 3);  // it is enough, no need to look at the items
@@ -382,22 +416,22 @@ test_source_parse_from_files_filter_sort_reverse(void **state)
 static void
 test_source_parse_from_files_filter_by_tag(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "TAGS: chunda\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "TAGS: bola, chunda\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
@@ -409,16 +443,18 @@ test_source_parse_from_files_filter_by_tag(void **state)
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_TAG", bc_strdup("chunda"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        0, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 2);  // it is enough, no need to look at the items
-    assert_int_equal(bc_trie_size(c), 5);
+    assert_int_equal(bc_trie_size(c), 6);
     assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola1");
     assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola2");
     assert_string_equal(bc_trie_lookup(c, "DATE_FIRST"), "2001-02-03 04:05:06");
     assert_string_equal(bc_trie_lookup(c, "DATE_LAST"), "2002-02-03 04:05:06");
     assert_string_equal(bc_trie_lookup(c, "FILTER_TAG"), "chunda");
+    assert_string_equal(bc_trie_lookup(c, "TAG_COUNTS"), "chunda:2 bola,:1");
     bc_trie_free(c);
     bc_slist_free_full(s, free);
     bc_slist_free_full(t, (bc_free_func_t) bc_trie_free);
@@ -428,44 +464,44 @@ test_source_parse_from_files_filter_by_tag(void **state)
 static void
 test_source_parse_from_files_filter_by_page(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola4.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola4.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7891\n"
         "DATE: 2004-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola5.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola5.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7892\n"
         "DATE: 2005-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola6.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola6.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7893\n"
         "DATE: 2006-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola7.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola7.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7894\n"
         "DATE: 2007-02-03 04:05:06\n"
         "--------\n"
@@ -482,7 +518,8 @@ test_source_parse_from_files_filter_by_page(void **state)
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_PAGE", bc_strdup("1"));
     bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        0, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 2);  // it is enough, no need to look at the items
@@ -506,44 +543,44 @@ test_source_parse_from_files_filter_by_page(void **state)
 static void
 test_source_parse_from_files_filter_by_page2(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola4.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola4.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7891\n"
         "DATE: 2004-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola5.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola5.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7892\n"
         "DATE: 2005-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola6.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola6.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7893\n"
         "DATE: 2006-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola7.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola7.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7894\n"
         "DATE: 2007-02-03 04:05:06\n"
         "--------\n"
@@ -560,7 +597,8 @@ test_source_parse_from_files_filter_by_page2(void **state)
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_PAGE", bc_strdup("3"));
     bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        0, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 2);  // it is enough, no need to look at the items
@@ -585,44 +623,44 @@ test_source_parse_from_files_filter_by_page2(void **state)
 static void
 test_source_parse_from_files_filter_by_page3(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola4.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola4.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7891\n"
         "DATE: 2004-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola5.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola5.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7892\n"
         "DATE: 2005-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola6.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola6.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7893\n"
         "DATE: 2006-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola7.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola7.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7894\n"
         "DATE: 2007-02-03 04:05:06\n"
         "--------\n"
@@ -639,7 +677,8 @@ test_source_parse_from_files_filter_by_page3(void **state)
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_PAGE", bc_strdup("1"));
     bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        0, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 2);  // it is enough, no need to look at the items
@@ -663,48 +702,48 @@ test_source_parse_from_files_filter_by_page3(void **state)
 static void
 test_source_parse_from_files_filter_sort_and_by_page_and_tag(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "TAGS: chunda\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "TAGS: chunda bola\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola4.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola4.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7891\n"
         "DATE: 2004-02-03 04:05:06\n"
         "TAGS: bola\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola5.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola5.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7892\n"
         "DATE: 2005-02-03 04:05:06\n"
         "TAGS: chunda\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola6.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola6.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7893\n"
         "DATE: 2006-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola7.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola7.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7894\n"
         "DATE: 2007-02-03 04:05:06\n"
         "TAGS: yay chunda\n"
@@ -724,11 +763,12 @@ test_source_parse_from_files_filter_sort_and_by_page_and_tag(void **state)
     bc_trie_insert(c, "FILTER_TAG", bc_strdup("chunda"));
     bc_trie_insert(c, "FILTER_PAGE", bc_strdup("2"));
     bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        0, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 2);  // it is enough, no need to look at the items
-    assert_int_equal(bc_trie_size(c), 12);
+    assert_int_equal(bc_trie_size(c), 14);
     assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola3");
     assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola2");
     assert_string_equal(bc_trie_lookup(c, "DATE_FIRST"), "2003-02-03 04:05:06");
@@ -741,6 +781,68 @@ test_source_parse_from_files_filter_sort_and_by_page_and_tag(void **state)
     assert_string_equal(bc_trie_lookup(c, "PREVIOUS_PAGE"), "1");
     assert_string_equal(bc_trie_lookup(c, "FIRST_PAGE"), "1");
     assert_string_equal(bc_trie_lookup(c, "LAST_PAGE"), "2");
+    assert_string_equal(bc_trie_lookup(c, "TAG_COUNTS"), "yay:1 chunda:4 bola:2");
+    assert_string_equal(bc_trie_lookup(c, "TAG_LAST_PAGES"), "yay:1 chunda:2 bola:1");
+    bc_trie_free(c);
+    bc_slist_free_full(s, free);
+    bc_slist_free_full(t, (bc_free_func_t) bc_trie_free);
+}
+
+
+static void
+test_source_parse_from_files_filter_by_page_content(void **state)
+{
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 123\n"
+        "DATE: 2001-02-03 04:05:06\n"
+        "--------\n"
+        "bola"));
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 456\n"
+        "DATE: 2002-02-03 04:05:06\n"
+        "--------\n"
+        "guda"));
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 789\n"
+        "DATE: 2003-02-03 04:05:06\n"
+        "--------\n"
+        "chunda"));
+
+    // only the source in the selected page is parsed again, with content.
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 456\n"
+        "DATE: 2002-02-03 04:05:06\n"
+        "--------\n"
+        "guda"));
+    bc_error_t *err = NULL;
+    bc_slist_t *s = NULL;
+    s = bc_slist_append(s, bc_strdup("bola1.txt"));
+    s = bc_slist_append(s, bc_strdup("bola2.txt"));
+    s = bc_slist_append(s, bc_strdup("bola3.txt"));
+    bc_trie_t *c = bc_trie_new(free);
+    bc_trie_insert(c, "FILTER_SORT", bc_strdup("1"));
+    bc_trie_insert(c, "FILTER_PAGE", bc_strdup("2"));
+    bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("1"));
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_CONTENT, 1, NULL, &err);
+    assert_null(err);
+    assert_non_null(t);
+    assert_int_equal(bc_slist_length(t), 1);
+    bc_trie_t *source = t->data;
+    assert_string_equal(bc_trie_lookup(source, "ASD"), "456");
+    assert_string_equal(bc_trie_lookup(source, "FILENAME"), "bola2");
+    assert_string_equal(bc_trie_lookup(source, "CONTENT"), "<p>guda</p>\n");
+    assert_null(bc_trie_lookup(source, "RAW_CONTENT"));
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola2");
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola2");
+    assert_string_equal(bc_trie_lookup(c, "CURRENT_PAGE"), "2");
+    assert_string_equal(bc_trie_lookup(c, "PREVIOUS_PAGE"), "1");
+    assert_string_equal(bc_trie_lookup(c, "NEXT_PAGE"), "3");
+    assert_string_equal(bc_trie_lookup(c, "LAST_PAGE"), "3");
     bc_trie_free(c);
     bc_slist_free_full(s, free);
     bc_slist_free_full(t, (bc_free_func_t) bc_trie_free);
@@ -750,44 +852,44 @@ test_source_parse_from_files_filter_sort_and_by_page_and_tag(void **state)
 static void
 test_source_parse_from_files_filter_by_page_invalid(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola4.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola4.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7891\n"
         "DATE: 2004-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola5.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola5.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7892\n"
         "DATE: 2005-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola6.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola6.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7893\n"
         "DATE: 2006-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola7.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola7.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7894\n"
         "DATE: 2007-02-03 04:05:06\n"
         "--------\n"
@@ -804,7 +906,8 @@ test_source_parse_from_files_filter_by_page_invalid(void **state)
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_PAGE", bc_strdup("-1"));
     bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        0, 1, NULL, &err);
     assert_null(err);
     assert_non_null(t);
     assert_int_equal(bc_slist_length(t), 2);  // it is enough, no need to look at the items
@@ -828,44 +931,44 @@ test_source_parse_from_files_filter_by_page_invalid(void **state)
 static void
 test_source_parse_from_files_filter_by_page_invalid2(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2001-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola4.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola4.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7891\n"
         "DATE: 2004-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola5.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola5.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7892\n"
         "DATE: 2005-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola6.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola6.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7893\n"
         "DATE: 2006-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola7.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola7.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 7894\n"
         "DATE: 2007-02-03 04:05:06\n"
         "--------\n"
@@ -882,7 +985,8 @@ test_source_parse_from_files_filter_by_page_invalid2(void **state)
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_PAGE", bc_strdup("5"));
     bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(err);
     assert_null(t);
     bc_trie_free(c);
@@ -893,19 +997,19 @@ test_source_parse_from_files_filter_by_page_invalid2(void **state)
 static void
 test_source_parse_from_files_without_all_dates(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola3.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 789\n"
         "DATE: 2003-02-03 04:05:06\n"
         "--------\n"
@@ -916,7 +1020,8 @@ test_source_parse_from_files_without_all_dates(void **state)
     s = bc_slist_append(s, bc_strdup("bola2.txt"));
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(t);
     assert_non_null(err);
     assert_int_equal(err->type, BLOGC_ERROR_LOADER);
@@ -933,14 +1038,14 @@ test_source_parse_from_files_without_all_dates(void **state)
 static void
 test_source_parse_from_files_filter_sort_without_all_dates(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2002-02-03 04:05:06\n"
         "--------\n"
         "bola"));
-    will_return(__wrap_bc_file_get_contents, "bola2.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 456\n"
         "--------\n"
         "bola"));
@@ -951,7 +1056,8 @@ test_source_parse_from_files_filter_sort_without_all_dates(void **state)
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_SORT", bc_strdup("1"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(t);
     assert_non_null(err);
     assert_int_equal(err->type, BLOGC_ERROR_LOADER);
@@ -969,8 +1075,8 @@ test_source_parse_from_files_filter_sort_without_all_dates(void **state)
 static void
 test_source_parse_from_files_filter_sort_with_wrong_date(void **state)
 {
-    will_return(__wrap_bc_file_get_contents, "bola1.txt");
-    will_return(__wrap_bc_file_get_contents, bc_strdup(
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
         "ASD: 123\n"
         "DATE: 2002-02-03 04:05:ab\n"
         "--------\n"
@@ -982,7 +1088,8 @@ test_source_parse_from_files_filter_sort_with_wrong_date(void **state)
     s = bc_slist_append(s, bc_strdup("bola3.txt"));
     bc_trie_t *c = bc_trie_new(free);
     bc_trie_insert(c, "FILTER_SORT", bc_strdup("1"));
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(t);
     assert_non_null(err);
     assert_int_equal(err->type, BLOGC_ERROR_LOADER);
@@ -997,13 +1104,153 @@ test_source_parse_from_files_filter_sort_with_wrong_date(void **state)
 }
 
 
+static void
+test_source_parse_from_files_shared(void **state)
+{
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 123\n"
+        "--------\n"
+        "bola"));
+    will_return(__wrap_bc_file_map, "bola2.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 456\n"
+        "--------\n"
+        "bola"));
+    bc_error_t *err = NULL;
+    bc_slist_t *s = NULL;
+    s = bc_slist_append(s, bc_strdup("bola1.txt"));
+    s = bc_slist_append(s, bc_strdup("bola2.txt"));
+    bc_trie_t *shared = bc_trie_new((bc_free_func_t) bc_trie_free);
+    bc_trie_t *c = bc_trie_new(free);
+    bc_trie_insert(c, "FILTER_PAGE", bc_strdup("2"));
+    bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("1"));
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, shared, &err);
+    assert_null(err);
+    assert_non_null(t);
+    assert_int_equal(bc_slist_length(t), 1);
+    assert_string_equal(bc_trie_lookup(t->data, "ASD"), "456");
+    assert_string_equal(bc_trie_lookup(t->data, "CONTENT"), "<p>bola</p>\n");
+    assert_int_equal(bc_trie_size(shared), 2);
+    bc_trie_t *bola2 = t->data;
+    bc_trie_free(c);
+    bc_slist_free(t);
+
+    // only the new source is read again
+    will_return(__wrap_bc_file_map, "bola3.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 789\n"
+        "--------\n"
+        "bola"));
+    s = bc_slist_append(s, bc_strdup("bola3.txt"));
+    s = bc_slist_append(s, bc_strdup("bola2.txt"));
+    c = bc_trie_new(free);
+    t = blogc_source_parse_from_files(c, s, BLOGC_SOURCE_FIELD_ALL, 1, shared,
+        &err);
+    assert_null(err);
+    assert_non_null(t);
+    assert_int_equal(bc_slist_length(t), 4);
+    assert_string_equal(bc_trie_lookup(t->data, "ASD"), "123");
+    assert_ptr_equal(t->next->data, bola2);
+    assert_string_equal(bc_trie_lookup(t->next->next->data, "ASD"), "789");
+    assert_ptr_equal(t->next->next->next->data, bola2);
+    assert_int_equal(bc_trie_size(shared), 3);
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola1");
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola2");
+    bc_trie_free(c);
+    bc_slist_free(t);
+
+    // sources parsed with another toctree depth are not shared
+    will_return(__wrap_bc_file_map, "bola1.txt");
+    will_return(__wrap_bc_file_map, bc_strdup(
+        "ASD: 123\n"
+        "--------\n"
+        "bola"));
+    bc_slist_t *s2 = bc_slist_append(NULL, bc_strdup("bola1.txt"));
+    c = bc_trie_new(free);
+    bc_trie_insert(c, "TOCTREE_MAXDEPTH", bc_strdup("1"));
+    t = blogc_source_parse_from_files(c, s2, BLOGC_SOURCE_FIELD_ALL, 1, shared,
+        &err);
+    assert_null(err);
+    assert_int_equal(bc_slist_length(t), 1);
+    assert_int_equal(bc_trie_size(shared), 4);
+    bc_trie_free(c);
+    bc_slist_free(t);
+    bc_slist_free_full(s2, free);
+
+    bc_slist_free_full(s, free);
+    bc_trie_free(shared);
+}
+
+
+static bc_trie_t*
+new_source(const char *filename)
+{
+    bc_trie_t *rv = bc_trie_new(free);
+    bc_trie_insert(rv, "FILENAME", bc_strdup(filename));
+    return rv;
+}
+
+
+static void
+test_source_filter_page(void **state)
+{
+    bc_trie_t *s[] = {new_source("bola1"), new_source("bola2"),
+        new_source("bola3")};
+
+    bc_trie_t *c = bc_trie_new(free);
+    bc_slist_t *t = blogc_source_filter_page(c, s, NULL, 3);
+    assert_int_equal(bc_slist_length(t), 3);
+    assert_int_equal(bc_trie_size(c), 2);
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola1");
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola3");
+    bc_slist_free(t);
+    bc_trie_free(c);
+
+    c = bc_trie_new(free);
+    bc_trie_insert(c, "FILTER_PAGE", bc_strdup("2"));
+    bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("2"));
+    t = blogc_source_filter_page(c, s, NULL, 3);
+    assert_int_equal(bc_slist_length(t), 1);
+    assert_ptr_equal(t->data, s[2]);
+    assert_int_equal(bc_trie_size(c), 8);
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_FIRST"), "bola3");
+    assert_string_equal(bc_trie_lookup(c, "FILENAME_LAST"), "bola3");
+    assert_string_equal(bc_trie_lookup(c, "CURRENT_PAGE"), "2");
+    assert_string_equal(bc_trie_lookup(c, "PREVIOUS_PAGE"), "1");
+    assert_null(bc_trie_lookup(c, "NEXT_PAGE"));
+    assert_string_equal(bc_trie_lookup(c, "FIRST_PAGE"), "1");
+    assert_string_equal(bc_trie_lookup(c, "LAST_PAGE"), "2");
+    bc_slist_free(t);
+    bc_trie_free(c);
+
+    // only the given positions are considered
+    size_t positions[] = {0, 2};
+    c = bc_trie_new(free);
+    bc_trie_insert(c, "FILTER_PAGE", bc_strdup("1"));
+    bc_trie_insert(c, "FILTER_PER_PAGE", bc_strdup("1"));
+    t = blogc_source_filter_page(c, s, positions, 2);
+    assert_int_equal(bc_slist_length(t), 1);
+    assert_ptr_equal(t->data, s[0]);
+    assert_string_equal(bc_trie_lookup(c, "NEXT_PAGE"), "2");
+    assert_string_equal(bc_trie_lookup(c, "LAST_PAGE"), "2");
+    bc_slist_free(t);
+    bc_trie_free(c);
+
+    for (size_t i = 0; i < 3; i++)
+        bc_trie_free(s[i]);
+}
+
+
 static void
 test_source_parse_from_files_null(void **state)
 {
     bc_error_t *err = NULL;
     bc_slist_t *s = NULL;
     bc_trie_t *c = bc_trie_new(free);
-    bc_slist_t *t = blogc_source_parse_from_files(c, s, &err);
+    bc_slist_t *t = blogc_source_parse_from_files(c, s,
+        BLOGC_SOURCE_FIELD_ALL, 1, NULL, &err);
     assert_null(err);
     assert_null(t);
     assert_int_equal(bc_slist_length(t), 0);
@@ -1021,6 +1268,7 @@ main(void)
         cmocka_unit_test(test_get_filename),
         cmocka_unit_test(test_template_parse_from_file),
         cmocka_unit_test(test_template_parse_from_file_null),
+        cmocka_unit_test(test_get_source_fields),
         cmocka_unit_test(test_source_parse_from_file),
         cmocka_unit_test(test_source_parse_from_file_maxdepth),
         cmocka_unit_test(test_source_parse_from_file_maxdepth2),
@@ -1034,12 +1282,15 @@ main(void)
         cmocka_unit_test(test_source_parse_from_files_filter_by_page2),
         cmocka_unit_test(test_source_parse_from_files_filter_by_page3),
         cmocka_unit_test(test_source_parse_from_files_filter_sort_and_by_page_and_tag),
+        cmocka_unit_test(test_source_parse_from_files_filter_by_page_content),
         cmocka_unit_test(test_source_parse_from_files_filter_by_page_invalid),
         cmocka_unit_test(test_source_parse_from_files_filter_by_page_invalid2),
         cmocka_unit_test(test_source_parse_from_files_without_all_dates),
         cmocka_unit_test(test_source_parse_from_files_filter_sort_without_all_dates),
         cmocka_unit_test(test_source_parse_from_files_filter_sort_with_wrong_date),
+        cmocka_unit_test(test_source_parse_from_files_shared),
         cmocka_unit_test(test_source_parse_from_files_null),
+        cmocka_unit_test(test_source_filter_page),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
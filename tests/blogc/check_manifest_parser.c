@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../../src/common/error.h"
+#include "../../src/common/utils.h"
+#include "../../src/blogc/manifest-parser.h"
+
+
+static void
+test_manifest_parse_empty(void **state)
+{
+    bc_error_t *err = NULL;
+    bc_slist_t *l = blogc_manifest_parse("", 0, &err);
+    assert_null(err);
+    assert_null(l);
+    const char *a =
+        "\n"
+        "# comment\n"
+        "   \n";
+    l = blogc_manifest_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_null(l);
+}
+
+
+static void
+test_manifest_parse(void **state)
+{
+    const char *a =
+        "# posts\n"
+        "-t templates/main.html -o build/post/foo/index.html content/post/foo.txt\n"
+        "\n"
+        "  -l -D FILTER_PAGE=2 -tmain.html \\\n"
+        "    -o build/page/2/index.html a.txt\tb.txt";
+    bc_error_t *err = NULL;
+    bc_slist_t *l = blogc_manifest_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_non_null(l);
+    char **argv = l->data;
+    assert_int_equal(bc_strv_length(argv), 5);
+    assert_string_equal(argv[0], "-t");
+    assert_string_equal(argv[1], "templates/main.html");
+    assert_string_equal(argv[2], "-o");
+    assert_string_equal(argv[3], "build/post/foo/index.html");
+    assert_string_equal(argv[4], "content/post/foo.txt");
+    argv = l->next->data;
+    assert_int_equal(bc_strv_length(argv), 8);
+    assert_string_equal(argv[0], "-l");
+    assert_string_equal(argv[1], "-D");
+    assert_string_equal(argv[2], "FILTER_PAGE=2");
+    assert_string_equal(argv[3], "-tmain.html");
+    assert_string_equal(argv[4], "-o");
+    assert_string_equal(argv[5], "build/page/2/index.html");
+    assert_string_equal(argv[6], "a.txt");
+    assert_string_equal(argv[7], "b.txt");
+    assert_null(l->next->next);
+    bc_slist_free_full(l, (bc_free_func_t) bc_strv_free);
+}
+
+
+static void
+test_manifest_parse_quotes(void **state)
+{
+    const char *a =
+        "-D 'SITE_TITLE=Chunda'\\''s website' -D \"A=\\\"b\\\" \\c\" -e '' a\\ b.txt\r\n"
+        "-l -e\"\"\n";
+    bc_error_t *err = NULL;
+    bc_slist_t *l = blogc_manifest_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_non_null(l);
+    char **argv = l->data;
+    assert_int_equal(bc_strv_length(argv), 7);
+    assert_string_equal(argv[0], "-D");
+    assert_string_equal(argv[1], "SITE_TITLE=Chunda's website");
+    assert_string_equal(argv[2], "-D");
+    assert_string_equal(argv[3], "A=\"b\" \\c");
+    assert_string_equal(argv[4], "-e");
+    assert_string_equal(argv[5], "");
+    assert_string_equal(argv[6], "a b.txt");
+    argv = l->next->data;
+    assert_int_equal(bc_strv_length(argv), 2);
+    assert_string_equal(argv[0], "-l");
+    assert_string_equal(argv[1], "-e");
+    assert_null(l->next->next);
+    bc_slist_free_full(l, (bc_free_func_t) bc_strv_free);
+}
+
+
+static void
+test_manifest_parse_invalid(void **state)
+{
+    const char *a =
+        "-t main.html a.txt\n"
+        "-t 'main.html a.txt\n";
+    bc_error_t *err = NULL;
+    bc_slist_t *l = blogc_manifest_parse(a, strlen(a), &err);
+    assert_null(l);
+    assert_non_null(err);
+    assert_int_equal(err->type, BLOGC_ERROR_MANIFEST_PARSER);
+    assert_string_equal(err->msg,
+        "Found unterminated quote.\n"
+        "Error occurred near line 2, position 4: -t 'main.html a.txt");
+    bc_error_free(err);
+}
+
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_manifest_parse_empty),
+        cmocka_unit_test(test_manifest_parse),
+        cmocka_unit_test(test_manifest_parse_quotes),
+        cmocka_unit_test(test_manifest_parse_invalid),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include "../../src/common/arena.h"
 #include "../../src/common/error.h"
 #include "../../src/common/utils.h"
 #include "../../src/blogc/renderer.h"
@@ -50,6 +51,46 @@ create_sources(size_t count)
 }
 
 
+static void
+render_chunks(const char *str, size_t len, void *user_data)
+{
+    bc_slist_t **chunks = user_data;
+    *chunks = bc_slist_append(*chunks, bc_strndup(str, len));
+}
+
+
+static void
+test_render_to(void **state)
+{
+    const char *str =
+        "foo\n"
+        "{% block listing %}{{ GUDA }}{% ifdef BOLA %}bola{% endif %}\n"
+        "{% endblock %}"
+        "bar";
+    bc_error_t *err = NULL;
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
+    assert_non_null(l);
+    assert_null(err);
+    bc_slist_t *s = create_sources(2);
+    assert_non_null(s);
+    bc_slist_t *chunks = NULL;
+    blogc_render_to(l, s, NULL, NULL, true, render_chunks, &chunks);
+    assert_int_equal(bc_slist_length(chunks), 8);
+    const char *expected[] = {"foo\n", "zxc", "bola", "\n", "zxc2", "bola",
+        "\n", "bar"};
+    size_t i = 0;
+    for (bc_slist_t *tmp = chunks; tmp != NULL; tmp = tmp->next)
+        assert_string_equal(tmp->data, expected[i++]);
+    char *out = blogc_render(l, s, NULL, NULL, true);
+    assert_string_equal(out, "foo\nzxcbola\nzxc2bola\nbar");
+    free(out);
+    blogc_render_to(l, s, NULL, NULL, true, NULL, NULL);
+    blogc_template_free(l);
+    bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
+    bc_slist_free_full(chunks, free);
+}
+
+
 static void
 test_render_entry(void **state)
 {
@@ -73,7 +114,7 @@ test_render_entry(void **state)
         "{% foreach TAGS_ASD %}yay{% endforeach %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -98,7 +139,7 @@ test_render_entry(void **state)
         "lol foo haha lol bar haha lol baz haha \n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -122,7 +163,7 @@ test_render_listing(void **state)
         "{% endblock %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(3);
@@ -149,7 +190,7 @@ test_render_listing(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -174,7 +215,7 @@ test_render_listing_entry(void **state)
         "{% endblock %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(3);
@@ -202,7 +243,7 @@ test_render_listing_entry(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -228,7 +269,7 @@ test_render_listing_entry2(void **state)
         "{% endblock %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(3);
@@ -263,7 +304,7 @@ test_render_listing_entry2(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -289,7 +330,7 @@ test_render_listing_entry3(void **state)
         "{% endblock %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(3);
@@ -325,7 +366,7 @@ test_render_listing_entry3(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -351,7 +392,7 @@ test_render_listing_entry4(void **state)
         "{% endblock %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(3);
@@ -390,7 +431,7 @@ test_render_listing_entry4(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -413,7 +454,7 @@ test_render_listing_empty(void **state)
         "{% endblock %}\n"
         "{% block listing_empty %}vazio{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     char *out = blogc_render(l, NULL, NULL, NULL, true);
@@ -423,7 +464,7 @@ test_render_listing_empty(void **state)
         "\n"
         "\n"
         "vazio\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     free(out);
 }
 
@@ -441,7 +482,7 @@ test_render_ifdef(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -451,7 +492,7 @@ test_render_ifdef(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -470,7 +511,7 @@ test_render_ifdef2(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -482,7 +523,7 @@ test_render_ifdef2(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -501,7 +542,7 @@ test_render_ifdef3(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -515,7 +556,7 @@ test_render_ifdef3(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -536,7 +577,7 @@ test_render_ifdef4(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -551,7 +592,7 @@ test_render_ifdef4(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -572,7 +613,7 @@ test_render_ifdef5(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -585,7 +626,7 @@ test_render_ifdef5(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -606,7 +647,7 @@ test_render_ifdef6(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -617,7 +658,7 @@ test_render_ifdef6(void **state)
         "lol\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -639,7 +680,7 @@ test_render_ifdef7(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -655,7 +696,7 @@ test_render_ifdef7(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -675,7 +716,7 @@ test_render_ifndef(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -690,7 +731,7 @@ test_render_ifndef(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -711,7 +752,7 @@ test_render_if_eq(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -727,7 +768,7 @@ test_render_if_eq(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -748,7 +789,7 @@ test_render_if_neq(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -764,7 +805,7 @@ test_render_if_neq(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -785,7 +826,7 @@ test_render_if_lt(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -801,7 +842,7 @@ test_render_if_lt(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -822,7 +863,7 @@ test_render_if_gt(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -838,7 +879,7 @@ test_render_if_gt(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -861,7 +902,7 @@ test_render_if_lt_eq(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -879,7 +920,7 @@ test_render_if_lt_eq(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -902,7 +943,7 @@ test_render_if_gt_eq(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -920,7 +961,7 @@ test_render_if_gt_eq(void **state)
         "\n"
         "\n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -934,7 +975,7 @@ test_render_foreach(void **state)
         "{% foreach TAGS %} {{ FOREACH_ITEM }} {% endforeach %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -944,7 +985,7 @@ test_render_foreach(void **state)
         "\n"
         " foo  bar  baz \n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -959,7 +1000,7 @@ test_render_foreach_if(void **state)
         "{% endif %} {% endforeach %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -969,7 +1010,7 @@ test_render_foreach_if(void **state)
         "\n"
         "   bar   \n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -985,7 +1026,7 @@ test_render_foreach_if_else(void **state)
         "{% endif %} {% endforeach %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -995,7 +1036,7 @@ test_render_foreach_if_else(void **state)
         "\n"
         "foo yay baz \n"
         "\n");
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -1016,7 +1057,7 @@ test_render_outside_block(void **state)
         "{{ BOLA }}\n"
         "{% ifndef CHUNDA %}lol{% endif %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -1029,7 +1070,7 @@ test_render_outside_block(void **state)
         "\n"
         "lol\n");
     bc_trie_free(c);
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -1049,7 +1090,7 @@ test_render_prefer_local_variable(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -1068,7 +1109,7 @@ test_render_prefer_local_variable(void **state)
         "\n"
         "\n");
     bc_trie_free(c);
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -1085,7 +1126,7 @@ test_render_respect_variable_scope(void **state)
         "{% ifdef BOLA %}{{ BOLA }}{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = create_sources(1);
@@ -1100,7 +1141,7 @@ test_render_respect_variable_scope(void **state)
         "asd\n"
         "\n");
     bc_trie_free(c);
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -1117,7 +1158,7 @@ test_render_ifcount_bug(void **state)
         "{% endif %}\n"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *l = blogc_template_parse(str, strlen(str), &err);
+    blogc_template_t *l = blogc_template_parse(str, strlen(str), &err);
     assert_non_null(l);
     assert_null(err);
     bc_slist_t *s = NULL;
@@ -1131,7 +1172,7 @@ test_render_ifcount_bug(void **state)
         "\n"
         "\n");
     bc_trie_free(c);
-    blogc_template_free_ast(l);
+    blogc_template_free(l);
     bc_slist_free_full(s, (bc_free_func_t) bc_trie_free);
     free(out);
 }
@@ -1237,6 +1278,73 @@ test_format_date_without_date(void **state)
 }
 
 
+static void
+test_format_date_cached(void **state)
+{
+    bc_trie_t *g = bc_trie_new(free);
+    bc_trie_insert(g, "DATE_FORMAT", bc_strdup("%H -- %M"));
+    bc_trie_t *l = bc_trie_new(free);
+    bc_trie_insert(l, "DATE_FORMAT", bc_strdup("%R"));
+    for (size_t i = 0; i < 2; i++) {
+        char *date = blogc_format_date("2015-01-02 03:04:05", g, l);
+        assert_string_equal(date, "03:04");
+        free(date);
+        date = blogc_format_date("2015-01-02 03:04:05", g, NULL);
+        assert_string_equal(date, "03 -- 04");
+        free(date);
+        date = blogc_format_date("2015-01-02 05:06:07", g, NULL);
+        assert_string_equal(date, "05 -- 06");
+        free(date);
+        date = blogc_format_date("bola", g, NULL);
+        assert_string_equal(date, "bola");
+        free(date);
+    }
+    blogc_format_date_cache_free();
+    bc_trie_free(g);
+    bc_trie_free(l);
+}
+
+static void
+test_get_operand(void **state)
+{
+    bc_trie_t *g = bc_trie_new(free);
+    bc_trie_insert(g, "DATE", bc_strdup("2010-11-12 13:14:15"));
+    bc_trie_insert(g, "DATE_FORMAT", bc_strdup("%R"));
+    bc_trie_t *l = bc_trie_new(free);
+    bc_trie_insert(l, "TITLE", bc_strdup("chunda2"));
+    bc_arena_t *arena = bc_arena_new(0);
+    blogc_template_operand_t op;
+
+    // plain and truncated values are borrowed
+    blogc_template_parse_operand(arena, "TITLE", &op);
+    bc_strview_t v = blogc_get_operand(&op, g, l, NULL, NULL);
+    assert_ptr_equal(v.str, bc_trie_lookup(l, "TITLE"));
+    assert_int_equal(v.len, 7);
+    blogc_template_parse_operand(arena, "TITLE_2", &op);
+    v = blogc_get_operand(&op, g, l, NULL, NULL);
+    assert_ptr_equal(v.str, bc_trie_lookup(l, "TITLE"));
+    assert_int_equal(v.len, 2);
+
+    // formatted dates are memoized, and borrowed as well
+    blogc_template_parse_operand(arena, "DATE_FORMATTED_2", &op);
+    v = blogc_get_operand(&op, g, l, NULL, NULL);
+    assert_int_equal(v.len, 2);
+    assert_memory_equal(v.str, "13", 2);
+    const char *formatted = v.str;
+    v = blogc_get_operand(&op, g, l, NULL, NULL);
+    assert_ptr_equal(v.str, formatted);
+    blogc_format_date_cache_free();
+
+    blogc_template_parse_operand(arena, "BOLA", &op);
+    v = blogc_get_operand(&op, g, l, NULL, NULL);
+    assert_null(v.str);
+
+    bc_arena_free(arena);
+    bc_trie_free(g);
+    bc_trie_free(l);
+}
+
+
 static void
 test_format_variable(void **state)
 {
@@ -1354,11 +1462,13 @@ test_split_list_variable(void **state)
     bc_trie_insert(g, "TAGS", bc_strdup("asd  lol hehe"));
     bc_trie_t *l = bc_trie_new(free);
     bc_trie_insert(l, "TAGS", bc_strdup("asd  lol XD"));
-    bc_slist_t *tmp = blogc_split_list_variable("TAGS", g, l);
+    bc_arena_t *arena = bc_arena_new(0);
+    bc_slist_t *tmp = blogc_split_list_variable("TAGS", g, l, arena);
     assert_string_equal(tmp->data, "asd");
     assert_string_equal(tmp->next->data, "lol");
     assert_string_equal(tmp->next->next->data, "XD");
-    bc_slist_free_full(tmp, free);
+    assert_null(tmp->next->next->next);
+    bc_arena_free(arena);
     bc_trie_free(g);
     bc_trie_free(l);
 }
@@ -1371,8 +1481,10 @@ test_split_list_variable_not_found(void **state)
     bc_trie_insert(g, "TAGS", bc_strdup("asd  lol hehe"));
     bc_trie_t *l = bc_trie_new(free);
     bc_trie_insert(l, "TAGS", bc_strdup("asd  lol XD"));
-    bc_slist_t *tmp = blogc_split_list_variable("TAG", g, l);
+    bc_arena_t *arena = bc_arena_new(0);
+    bc_slist_t *tmp = blogc_split_list_variable("TAG", g, l, arena);
     assert_null(tmp);
+    bc_arena_free(arena);
     bc_trie_free(g);
     bc_trie_free(l);
 }
@@ -1383,6 +1495,7 @@ main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_render_entry),
+        cmocka_unit_test(test_render_to),
         cmocka_unit_test(test_render_listing),
         cmocka_unit_test(test_render_listing_entry),
         cmocka_unit_test(test_render_listing_entry2),
@@ -1418,6 +1531,8 @@ main(void)
         cmocka_unit_test(test_format_date_with_global_format),
         cmocka_unit_test(test_format_date_without_format),
         cmocka_unit_test(test_format_date_without_date),
+        cmocka_unit_test(test_format_date_cached),
+        cmocka_unit_test(test_get_operand),
         cmocka_unit_test(test_format_variable),
         cmocka_unit_test(test_format_variable_with_date),
         cmocka_unit_test(test_format_variable_foreach),
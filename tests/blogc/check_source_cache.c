@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../../src/common/error.h"
+#include "../../src/common/file.h"
+#include "../../src/common/utils.h"
+#include "../../src/blogc/cache.h"
+#include "../../src/blogc/source-cache.h"
+#include "../../src/blogc/source-parser.h"
+
+
+static int
+setup(void **state)
+{
+    char *dir = bc_strdup("/tmp/blogc_check_source_cache_XXXXXX");
+    assert_non_null(mkdtemp(dir));
+    *state = dir;
+    return 0;
+}
+
+
+static int
+teardown(void **state)
+{
+    char *cmd = bc_strdup_printf("rm -rf '%s'", (char*) *state);
+    assert_int_equal(system(cmd), 0);
+    free(cmd);
+    free(*state);
+    return 0;
+}
+
+
+static void
+test_source_cache_hash(void **state)
+{
+    const char *a = "VAR1: asd\n----\nbola\n";
+    uint64_t h = blogc_source_cache_hash(a, strlen(a), -1, BLOGC_SOURCE_FIELD_ALL);
+    assert_true(h == blogc_source_cache_hash(a, strlen(a), -1, BLOGC_SOURCE_FIELD_ALL));
+    assert_false(h == blogc_source_cache_hash(a, strlen(a) - 1, -1, BLOGC_SOURCE_FIELD_ALL));
+    assert_false(h == blogc_source_cache_hash(a, strlen(a), 2, BLOGC_SOURCE_FIELD_ALL));
+    assert_false(h == blogc_source_cache_hash(a, strlen(a), -1, BLOGC_SOURCE_FIELD_CONTENT));
+}
+
+
+static void
+test_source_cache_get_put(void **state)
+{
+    const char *dir = *state;
+    const char *a =
+        "VAR1: asd asd\n"
+        "VAR2: 123chunda\n"
+        "EMPTY:\n"
+        "----------\n"
+        "# This is a test\n"
+        "\n"
+        "bola\n";
+    assert_null(blogc_source_cache_get(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL));
+
+    bc_error_t *err = NULL;
+    bc_trie_t *source = blogc_source_parse(a, strlen(a), -1, &err);
+    assert_null(err);
+    assert_non_null(source);
+    assert_true(blogc_source_cache_put(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL, source));
+
+    bc_trie_t *cached = blogc_source_cache_get(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL);
+    assert_non_null(cached);
+    assert_int_equal(bc_trie_size(cached), bc_trie_size(source));
+    assert_int_equal(bc_trie_size(cached), 9);
+    const char *keys[] = {"VAR1", "VAR2", "EMPTY", "RAW_CONTENT", "FIRST_HEADER",
+        "DESCRIPTION", "TOCTREE", "CONTENT", "EXCERPT"};
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+        assert_string_equal(bc_trie_lookup(cached, keys[i]),
+            bc_trie_lookup(source, keys[i]));
+    assert_string_equal(bc_trie_lookup(cached, "EMPTY"), "");
+    bc_trie_free(cached);
+
+    // any change in the key is a miss
+    assert_null(blogc_source_cache_get(dir, a, strlen(a), 1,
+        BLOGC_SOURCE_FIELD_ALL));
+    assert_null(blogc_source_cache_get(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_CONTENT));
+    assert_null(blogc_source_cache_get(dir, a, strlen(a) - 1, -1,
+        BLOGC_SOURCE_FIELD_ALL));
+    assert_null(blogc_source_cache_get(NULL, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL));
+
+    bc_trie_free(source);
+}
+
+
+static void
+test_source_cache_get_invalid(void **state)
+{
+    const char *dir = *state;
+    const char *a = "VAR1: asd asd\n----------\nbola\n";
+
+    bc_error_t *err = NULL;
+    bc_trie_t *source = blogc_source_parse(a, strlen(a), -1, &err);
+    assert_null(err);
+    assert_true(blogc_source_cache_put(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL, source));
+    bc_trie_free(source);
+
+    char *path = blogc_cache_path(dir,
+        blogc_source_cache_hash(a, strlen(a), -1, BLOGC_SOURCE_FIELD_ALL));
+    size_t len;
+    char *content = bc_file_get_contents(path, false, &len, &err);
+    assert_null(err);
+    assert_non_null(content);
+
+    // truncated entries are ignored
+    FILE *fp = fopen(path, "wb");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(content, 1, len - 1, fp), len - 1);
+    fclose(fp);
+    assert_null(blogc_source_cache_get(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL));
+
+    // and so are entries with garbage after them
+    fp = fopen(path, "wb");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(content, 1, len, fp), len);
+    assert_int_equal(fwrite("bola", 1, 4, fp), 4);
+    fclose(fp);
+    assert_null(blogc_source_cache_get(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL));
+
+    // and entries with a wrong magic
+    content[0] = 'X';
+    fp = fopen(path, "wb");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(content, 1, len, fp), len);
+    fclose(fp);
+    assert_null(blogc_source_cache_get(dir, a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_ALL));
+
+    free(content);
+    free(path);
+}
+
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_source_cache_hash),
+        cmocka_unit_test_setup_teardown(test_source_cache_get_put, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_source_cache_get_invalid, setup, teardown),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
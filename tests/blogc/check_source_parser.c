@@ -45,6 +45,74 @@ test_source_parse(void **state)
 }
 
 
+static void
+test_source_parse_fields(void **state)
+{
+    const char *a =
+        "VAR1: asd asd\n"
+        "----------\n"
+        "# This is a test\n"
+        "\n"
+        "bola\n"
+        "\n"
+        "...\n"
+        "\n"
+        "guda\n";
+    bc_error_t *err = NULL;
+    bc_trie_t *source = blogc_source_parse_fields(a, strlen(a), -1, 0, &err);
+    assert_null(err);
+    assert_non_null(source);
+    assert_int_equal(bc_trie_size(source), 1);
+    assert_string_equal(bc_trie_lookup(source, "VAR1"), "asd asd");
+    bc_trie_free(source);
+
+    source = blogc_source_parse_fields(a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_RAW_CONTENT, &err);
+    assert_null(err);
+    assert_non_null(source);
+    assert_int_equal(bc_trie_size(source), 2);
+    assert_string_equal(bc_trie_lookup(source, "RAW_CONTENT"),
+        "# This is a test\n"
+        "\n"
+        "bola\n"
+        "\n"
+        "...\n"
+        "\n"
+        "guda\n");
+    bc_trie_free(source);
+
+    source = blogc_source_parse_fields(a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_CONTENT, &err);
+    assert_null(err);
+    assert_non_null(source);
+    assert_int_equal(bc_trie_size(source), 4);
+    assert_string_equal(bc_trie_lookup(source, "CONTENT"),
+        "<h1 id=\"this-is-a-test\">This is a test</h1>\n"
+        "<p>bola</p>\n"
+        "<p>guda</p>\n");
+    assert_string_equal(bc_trie_lookup(source, "FIRST_HEADER"), "This is a test");
+    assert_string_equal(bc_trie_lookup(source, "DESCRIPTION"), "bola");
+    assert_null(bc_trie_lookup(source, "EXCERPT"));
+    assert_null(bc_trie_lookup(source, "TOCTREE"));
+    bc_trie_free(source);
+
+    source = blogc_source_parse_fields(a, strlen(a), -1,
+        BLOGC_SOURCE_FIELD_EXCERPT | BLOGC_SOURCE_FIELD_TOCTREE, &err);
+    assert_null(err);
+    assert_non_null(source);
+    assert_int_equal(bc_trie_size(source), 6);
+    assert_string_equal(bc_trie_lookup(source, "EXCERPT"),
+        "<h1 id=\"this-is-a-test\">This is a test</h1>\n"
+        "<p>bola</p>\n");
+    assert_string_equal(bc_trie_lookup(source, "TOCTREE"),
+        "<ul>\n"
+        "    <li><a href=\"#this-is-a-test\">This is a test</a></li>\n"
+        "</ul>\n");
+    assert_null(bc_trie_lookup(source, "RAW_CONTENT"));
+    bc_trie_free(source);
+}
+
+
 static void
 test_source_parse_crlf(void **state)
 {
@@ -723,6 +791,7 @@ main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_source_parse),
+        cmocka_unit_test(test_source_parse_fields),
         cmocka_unit_test(test_source_parse_crlf),
         cmocka_unit_test(test_source_parse_with_spaces),
         cmocka_unit_test(test_source_parse_with_excerpt),
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include "../../src/common/utils.h"
+#include "../../src/blogc/tag-index.h"
+
+
+static bc_trie_t*
+new_source(const char *tags)
+{
+    bc_trie_t *rv = bc_trie_new(free);
+    if (tags != NULL)
+        bc_trie_insert(rv, "TAGS", bc_strdup(tags));
+    return rv;
+}
+
+
+static void
+test_tag_index_empty(void **state)
+{
+    blogc_tag_index_t *index = blogc_tag_index_new(NULL, 0);
+    assert_non_null(index);
+    assert_int_equal(index->tags_len, 0);
+    assert_null(blogc_tag_index_lookup(index, "foo"));
+    assert_null(blogc_tag_index_lookup(index, NULL));
+    blogc_tag_index_free(index);
+    assert_null(blogc_tag_index_lookup(NULL, "foo"));
+}
+
+
+static void
+test_tag_index(void **state)
+{
+    bc_trie_t *s[] = {new_source("foo bar"), new_source(NULL),
+        new_source(" bar  baz bar"), new_source("foo")};
+    blogc_tag_index_t *index = blogc_tag_index_new(s, 4);
+    assert_non_null(index);
+    assert_int_equal(index->tags_len, 3);
+
+    blogc_tag_posting_t *p = index->tags[0];
+    assert_string_equal(p->tag, "foo");
+    assert_int_equal(p->sources_len, 2);
+    assert_int_equal(p->sources[0], 0);
+    assert_int_equal(p->sources[1], 3);
+    assert_ptr_equal(blogc_tag_index_lookup(index, "foo"), p);
+
+    p = index->tags[1];
+    assert_string_equal(p->tag, "bar");
+    assert_int_equal(p->sources_len, 2);
+    assert_int_equal(p->sources[0], 0);
+    assert_int_equal(p->sources[1], 2);
+    assert_ptr_equal(blogc_tag_index_lookup(index, "bar"), p);
+
+    p = index->tags[2];
+    assert_string_equal(p->tag, "baz");
+    assert_int_equal(p->sources_len, 1);
+    assert_int_equal(p->sources[0], 2);
+    assert_ptr_equal(blogc_tag_index_lookup(index, "baz"), p);
+
+    assert_null(blogc_tag_index_lookup(index, "ba"));
+    assert_null(blogc_tag_index_lookup(index, ""));
+
+    blogc_tag_index_free(index);
+    for (size_t i = 0; i < 4; i++)
+        bc_trie_free(s[i]);
+}
+
+
+static void
+test_tag_index_grow(void **state)
+{
+    bc_trie_t *s[100];
+    for (size_t i = 0; i < 100; i++) {
+        char *tags = bc_strdup_printf("all tag%zu", i);
+        s[i] = new_source(tags);
+        free(tags);
+    }
+    blogc_tag_index_t *index = blogc_tag_index_new(s, 100);
+    assert_int_equal(index->tags_len, 101);
+    blogc_tag_posting_t *p = blogc_tag_index_lookup(index, "all");
+    assert_int_equal(p->sources_len, 100);
+    for (size_t i = 0; i < 100; i++)
+        assert_int_equal(p->sources[i], i);
+    p = blogc_tag_index_lookup(index, "tag42");
+    assert_int_equal(p->sources_len, 1);
+    assert_int_equal(p->sources[0], 42);
+    assert_ptr_equal(index->tags[43], p);
+    blogc_tag_index_free(index);
+    for (size_t i = 0; i < 100; i++)
+        bc_trie_free(s[i]);
+}
+
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_tag_index_empty),
+        cmocka_unit_test(test_tag_index),
+        cmocka_unit_test(test_tag_index_grow),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
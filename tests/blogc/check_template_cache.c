@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../../src/common/error.h"
+#include "../../src/common/file.h"
+#include "../../src/common/utils.h"
+#include "../../src/blogc/cache.h"
+#include "../../src/blogc/template-cache.h"
+#include "../../src/blogc/template-parser.h"
+
+
+static int
+setup(void **state)
+{
+    char *dir = bc_strdup("/tmp/blogc_check_template_cache_XXXXXX");
+    assert_non_null(mkdtemp(dir));
+    *state = dir;
+    return 0;
+}
+
+
+static int
+teardown(void **state)
+{
+    char *cmd = bc_strdup_printf("rm -rf '%s'", (char*) *state);
+    assert_int_equal(system(cmd), 0);
+    free(cmd);
+    free(*state);
+    return 0;
+}
+
+
+static void
+assert_operand_equal(const blogc_template_operand_t *a,
+    const blogc_template_operand_t *b)
+{
+    if (a->name == NULL) {
+        assert_null(b->name);
+        return;
+    }
+    assert_string_equal(a->name, b->name);
+    assert_string_equal(a->base, b->base);
+    assert_int_equal(a->len, b->len);
+    assert_int_equal(a->formatter, b->formatter);
+    assert_int_equal(a->special, b->special);
+    assert_ptr_equal(a->funcvar, b->funcvar);
+    assert_int_equal(a->literal, b->literal);
+}
+
+
+static void
+test_template_cache_get_put(void **state)
+{
+    const char *dir = *state;
+    const char *a =
+        "<h1>{{ TITLE }}</h1>\n"
+        "{% block listing_once %}{{ DATE_FORMATTED }}{% endblock %}\n"
+        "{% block listing %}\n"
+        "{% if FOO != \"bola\" %}{{ CONTENT_10 }}{% else %}{{ BAR }}{% endif %}\n"
+        "{% ifdef BAR %}{% if BAR >= BAZ %}{{ BLOGC_SYSINFO_HOSTNAME }}{% endif %}\n"
+        "{% else %}{% ifndef CHUNDA %}asd{% endif %}{% endif %}\n"
+        "{% foreach TAGS %}{{ FOREACH_ITEM }} {% endforeach -%}\n"
+        "{% endblock %}\n";
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    bc_error_t *err = NULL;
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_non_null(tmpl);
+    assert_true(blogc_template_cache_put(dir, a, strlen(a), tmpl));
+
+    blogc_template_t *cached = blogc_template_cache_get(dir, a, strlen(a));
+    assert_non_null(cached);
+    assert_int_equal(cached->nodes_len, tmpl->nodes_len);
+    for (size_t i = 0; i < tmpl->nodes_len; i++) {
+        blogc_template_node_t *n1 = tmpl->nodes + i;
+        blogc_template_node_t *n2 = cached->nodes + i;
+        assert_int_equal(n1->type, n2->type);
+        assert_int_equal(n1->op, n2->op);
+        assert_int_equal(n1->jump, n2->jump);
+        for (size_t j = 0; j < 2; j++) {
+            if (n1->data[j] == NULL)
+                assert_null(n2->data[j]);
+            else
+                assert_string_equal(n1->data[j], n2->data[j]);
+            assert_operand_equal(&n1->operands[j], &n2->operands[j]);
+        }
+    }
+    blogc_template_free(cached);
+
+    assert_null(blogc_template_cache_get(dir, a, strlen(a) - 1));
+    assert_null(blogc_template_cache_get(NULL, a, strlen(a)));
+
+    blogc_template_free(tmpl);
+}
+
+
+static void
+write_entry(const char *path, const char *content, size_t len, char *node,
+    const blogc_template_cache_node_t *n)
+{
+    // writes the entry with a single node replaced, restoring the original.
+    blogc_template_cache_node_t orig;
+    if (node != NULL) {
+        memcpy(&orig, node, sizeof(orig));
+        memcpy(node, n, sizeof(orig));
+    }
+    FILE *fp = fopen(path, "wb");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(content, 1, len, fp), len);
+    fclose(fp);
+    if (node != NULL)
+        memcpy(node, &orig, sizeof(orig));
+}
+
+
+static void
+test_template_cache_get_invalid(void **state)
+{
+    const char *dir = *state;
+    const char *a = "{% block entry %}{{ TITLE }}{% endblock %}";
+
+    bc_error_t *err = NULL;
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_true(blogc_template_cache_put(dir, a, strlen(a), tmpl));
+    blogc_template_free(tmpl);
+
+    char *path = blogc_cache_path(dir, blogc_template_cache_hash(a, strlen(a)));
+    size_t len;
+    char *content = bc_file_get_contents(path, false, &len, &err);
+    assert_null(err);
+    assert_non_null(content);
+
+    // truncated entries are ignored
+    FILE *fp = fopen(path, "wb");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(content, 1, len - 1, fp), len - 1);
+    fclose(fp);
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    // and so are entries with jumps out of the template
+    blogc_template_cache_node_t n;
+    char *node = content + sizeof(blogc_template_cache_header_t);
+    memcpy(&n, node, sizeof(n));
+    n.jump = 10;
+    write_entry(path, content, len, node, &n);
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    // backward jumps
+    memcpy(&n, node, sizeof(n));
+    n.jump = 0;
+    write_entry(path, content, len, node, &n);
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    // jumps that don't land on the matching 'endblock'
+    memcpy(&n, node, sizeof(n));
+    n.jump = 1;
+    write_entry(path, content, len, node, &n);
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    // blocks without name
+    memcpy(&n, node, sizeof(n));
+    n.data[0] = BLOGC_TEMPLATE_CACHE_NULL;
+    write_entry(path, content, len, node, &n);
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    // variables without name
+    node += sizeof(n);
+    memcpy(&n, node, sizeof(n));
+    n.data[0] = BLOGC_TEMPLATE_CACHE_NULL;
+    write_entry(path, content, len, node, &n);
+    assert_null(blogc_template_cache_get(dir, a, strlen(a)));
+
+    // the untouched entry is still valid
+    write_entry(path, content, len, NULL, NULL);
+    tmpl = blogc_template_cache_get(dir, a, strlen(a));
+    assert_non_null(tmpl);
+    blogc_template_free(tmpl);
+    free(content);
+    free(path);
+
+    // foreach statements without name
+    const char *b = "{% foreach TAGS %}{{ FOREACH_ITEM }}{% endforeach %}";
+    tmpl = blogc_template_parse(b, strlen(b), &err);
+    assert_null(err);
+    assert_true(blogc_template_cache_put(dir, b, strlen(b), tmpl));
+    blogc_template_free(tmpl);
+
+    path = blogc_cache_path(dir, blogc_template_cache_hash(b, strlen(b)));
+    content = bc_file_get_contents(path, false, &len, &err);
+    assert_null(err);
+    assert_non_null(content);
+    node = content + sizeof(blogc_template_cache_header_t);
+    memcpy(&n, node, sizeof(n));
+    assert_int_equal(n.type, BLOGC_TEMPLATE_NODE_FOREACH);
+    n.data[0] = BLOGC_TEMPLATE_CACHE_NULL;
+    write_entry(path, content, len, node, &n);
+    assert_null(blogc_template_cache_get(dir, b, strlen(b)));
+
+    free(content);
+    free(path);
+}
+
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_template_cache_get_put, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_template_cache_get_invalid, setup, teardown),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
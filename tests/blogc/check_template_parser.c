@@ -12,10 +12,9 @@
 
 
 static void
-blogc_assert_template_node(bc_slist_t *l, const char *data,
+blogc_assert_template_node(blogc_template_node_t *node, const char *data,
     const blogc_template_node_type_t type)
 {
-    blogc_template_node_t *node = l->data;
     if (data == NULL)
         assert_null(node->data[0]);
     else
@@ -25,10 +24,9 @@ blogc_assert_template_node(bc_slist_t *l, const char *data,
 
 
 static void
-blogc_assert_template_if_node(bc_slist_t *l, const char *variable,
+blogc_assert_template_if_node(blogc_template_node_t *node, const char *variable,
     blogc_template_operator_t operator, const char *operand)
 {
-    blogc_template_node_t *node = l->data;
     assert_string_equal(node->data[0], variable);
     assert_int_equal(node->op, operator);
     assert_string_equal(node->data[1], operand);
@@ -57,82 +55,84 @@ test_template_parse(void **state)
         "{% block listing_entry %}lol{% endblock %}\n"
         "{% block listing_empty %}empty{% endblock %}";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_null(err);
+    assert_non_null(tmpl);
+    blogc_template_node_t *ast = tmpl->nodes;
     assert_non_null(ast);
     blogc_assert_template_node(ast, "Test",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next, "entry",
+    blogc_assert_template_node(ast + 1, "entry",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(ast->next->next, "",
+    blogc_assert_template_node(ast + 2, "",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next, "CHUNDA",
+    blogc_assert_template_node(ast + 3, "CHUNDA",
         BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(ast->next->next->next->next, "\nbola\n",
+    blogc_assert_template_node(ast + 4, "\nbola\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next, NULL,
+    blogc_assert_template_node(ast + 5, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(ast->next->next->next->next->next->next, "\n",
+    blogc_assert_template_node(ast + 6, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    bc_slist_t *tmp = ast->next->next->next->next->next->next->next;
+    blogc_template_node_t *tmp = ast + 7;
     blogc_assert_template_node(tmp, "BOLA", BLOGC_TEMPLATE_NODE_IFNDEF);
-    blogc_assert_template_node(tmp->next, "\nbolao", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 1, "\nbolao", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 2, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
+    blogc_assert_template_node(tmp + 3, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next;
+    tmp += 4;
     blogc_assert_template_node(tmp, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next, "\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, "listing",
+    blogc_assert_template_node(tmp + 1, "\n", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 2, "listing",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next, "BOLA",
+    blogc_assert_template_node(tmp + 3, "BOLA",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next,
+    blogc_assert_template_node(tmp + 4,
         NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 5, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "listing_once", BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "asd", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 8,
         NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 9,
         "", BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next->next->next->next->next->next->next;
+    tmp += 10;
     blogc_assert_template_node(tmp, "BOLA", BLOGC_TEMPLATE_NODE_FOREACH);
-    blogc_assert_template_node(tmp->next, "hahaha",
+    blogc_assert_template_node(tmp + 1, "hahaha",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, NULL,
+    blogc_assert_template_node(tmp + 2, NULL,
         BLOGC_TEMPLATE_NODE_ENDFOREACH);
-    blogc_assert_template_node(tmp->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 3, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_if_node(tmp->next->next->next->next, "BOLA",
+    blogc_assert_template_if_node(tmp + 4, "BOLA",
         BLOGC_TEMPLATE_OP_EQ, "\"1\\\"0\"");
-    blogc_assert_template_node(tmp->next->next->next->next->next, "aee",
+    blogc_assert_template_node(tmp + 5, "aee",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 6, NULL,
         BLOGC_TEMPLATE_NODE_ELSE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "fffuuuuuuu", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 8,
         NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    tmp = tmp->next->next->next->next->next->next->next->next->next;
+    tmp += 9;
     blogc_assert_template_node(tmp, "\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "listing_entry", BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next, "lol", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 1, "listing_entry", BLOGC_TEMPLATE_NODE_BLOCK);
+    blogc_assert_template_node(tmp + 2, "lol", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 3, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 4, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "listing_empty",
+    blogc_assert_template_node(tmp + 5, "listing_empty",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next, "empty",
+    blogc_assert_template_node(tmp + 6, "empty",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 7, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    assert_null(tmp->next->next->next->next->next->next->next->next);
-    blogc_template_free_ast(ast);
+    assert_int_equal(tmp + 8 - ast, tmpl->nodes_len);
+    blogc_template_free(tmpl);
 }
 
 
@@ -155,68 +155,70 @@ test_template_parse_crlf(void **state)
         "{%- foreach BOLA %}hahaha{% endforeach %}\r\n"
         "{% if BOLA == \"1\\\"0\" %}aee{% else %}fffuuuuuuu{% endif %}";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_null(err);
+    assert_non_null(tmpl);
+    blogc_template_node_t *ast = tmpl->nodes;
     assert_non_null(ast);
     blogc_assert_template_node(ast, "Test",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next, "entry",
+    blogc_assert_template_node(ast + 1, "entry",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(ast->next->next, "",
+    blogc_assert_template_node(ast + 2, "",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next, "CHUNDA",
+    blogc_assert_template_node(ast + 3, "CHUNDA",
         BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(ast->next->next->next->next, "\r\nbola\r\n",
+    blogc_assert_template_node(ast + 4, "\r\nbola\r\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next, NULL,
+    blogc_assert_template_node(ast + 5, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(ast->next->next->next->next->next->next, "\r\n",
+    blogc_assert_template_node(ast + 6, "\r\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    bc_slist_t *tmp = ast->next->next->next->next->next->next->next;
+    blogc_template_node_t *tmp = ast + 7;
     blogc_assert_template_node(tmp, "BOLA", BLOGC_TEMPLATE_NODE_IFNDEF);
-    blogc_assert_template_node(tmp->next, "\r\nbolao", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next, "\r\n",
+    blogc_assert_template_node(tmp + 1, "\r\nbolao", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 2, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
+    blogc_assert_template_node(tmp + 3, "\r\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next;
+    tmp += 4;
     blogc_assert_template_node(tmp, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next, "\r\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, "listing",
+    blogc_assert_template_node(tmp + 1, "\r\n", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 2, "listing",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next, "BOLA",
+    blogc_assert_template_node(tmp + 3, "BOLA",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next,
+    blogc_assert_template_node(tmp + 4,
         NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "\r\n",
+    blogc_assert_template_node(tmp + 5, "\r\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "listing_once", BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "asd", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 8,
         NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 9,
         "", BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next->next->next->next->next->next->next;
+    tmp += 10;
     blogc_assert_template_node(tmp, "BOLA", BLOGC_TEMPLATE_NODE_FOREACH);
-    blogc_assert_template_node(tmp->next, "hahaha",
+    blogc_assert_template_node(tmp + 1, "hahaha",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, NULL,
+    blogc_assert_template_node(tmp + 2, NULL,
         BLOGC_TEMPLATE_NODE_ENDFOREACH);
-    blogc_assert_template_node(tmp->next->next->next, "\r\n",
+    blogc_assert_template_node(tmp + 3, "\r\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_if_node(tmp->next->next->next->next, "BOLA",
+    blogc_assert_template_if_node(tmp + 4, "BOLA",
         BLOGC_TEMPLATE_OP_EQ, "\"1\\\"0\"");
-    blogc_assert_template_node(tmp->next->next->next->next->next, "aee",
+    blogc_assert_template_node(tmp + 5, "aee",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 6, NULL,
         BLOGC_TEMPLATE_NODE_ELSE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "fffuuuuuuu", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 8,
         NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    assert_null(tmp->next->next->next->next->next->next->next->next->next);
-    blogc_template_free_ast(ast);
+    assert_int_equal(tmp + 9 - ast, tmpl->nodes_len);
+    blogc_template_free(tmpl);
 }
 
 
@@ -247,105 +249,107 @@ test_template_parse_html(void **state)
         "    </body>\n"
         "</html>\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_null(err);
+    assert_non_null(tmpl);
+    blogc_template_node_t *ast = tmpl->nodes;
     assert_non_null(ast);
     blogc_assert_template_node(ast, "<html>\n    <head>\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next, "entry",
+    blogc_assert_template_node(ast + 1, "entry",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(ast->next->next,
+    blogc_assert_template_node(ast + 2,
         "\n        <title>My cool blog >> ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next, "TITLE",
+    blogc_assert_template_node(ast + 3, "TITLE",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(ast->next->next->next->next,
+    blogc_assert_template_node(ast + 4,
         "</title>\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next, NULL,
+    blogc_assert_template_node(ast + 5, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(ast->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 6,
         "\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 7,
         "listing_once", BLOGC_TEMPLATE_NODE_BLOCK);
-    bc_slist_t *tmp = ast->next->next->next->next->next->next->next->next;
+    blogc_template_node_t *tmp = ast + 8;
     blogc_assert_template_node(tmp,
         "\n        <title>My cool blog - Main page</title>\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next,
+    blogc_assert_template_node(tmp + 1, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
+    blogc_assert_template_node(tmp + 2,
         "\n    </head>\n    <body>\n        <h1>My cool blog</h1>\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, "entry",
+    blogc_assert_template_node(tmp + 3, "entry",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next,
+    blogc_assert_template_node(tmp + 4,
         "\n        <h2>", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "TITLE", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "</h2>\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "DATE", BLOGC_TEMPLATE_NODE_IFDEF);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, "<h4>Published in: ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "DATE", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next, "</h4>",
+    blogc_assert_template_node(tmp + 1, "DATE", BLOGC_TEMPLATE_NODE_VARIABLE);
+    blogc_assert_template_node(tmp + 2, "</h4>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 3, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next->next, "\n        <pre>",
+    blogc_assert_template_node(tmp + 4, "\n        <pre>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "CONTENT", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "</pre>\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, "\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "listing_once",
+    blogc_assert_template_node(tmp + 1, "listing_once",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next, "<ul>",
+    blogc_assert_template_node(tmp + 2, "<ul>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 3, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next, "\n        ",
+    blogc_assert_template_node(tmp + 4, "\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "listing", BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "<p><a href=\"", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "FILENAME", BLOGC_TEMPLATE_NODE_VARIABLE);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, ".html\">", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "TITLE",
+    blogc_assert_template_node(tmp + 1, "TITLE",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next, "</a>",
+    blogc_assert_template_node(tmp + 2, "</a>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, "DATE",
+    blogc_assert_template_node(tmp + 3, "DATE",
         BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(tmp->next->next->next->next, " - ",
+    blogc_assert_template_node(tmp + 4, " - ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "DATE",
+    blogc_assert_template_node(tmp + 5, "DATE",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "</p>", BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next, "\n        ",
+    blogc_assert_template_node(tmp + 1, "\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, "listing_once",
+    blogc_assert_template_node(tmp + 2, "listing_once",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next, "</ul>",
+    blogc_assert_template_node(tmp + 3, "</ul>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 4, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "\n    </body>\n</html>\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    assert_null(tmp->next->next->next->next->next->next);
-    blogc_template_free_ast(ast);
+    assert_int_equal(tmp + 6 - ast, tmpl->nodes_len);
+    blogc_template_free(tmpl);
 }
 
 
@@ -376,105 +380,107 @@ test_template_parse_html_whitespace(void **state)
         "    </body>\n"
         "</html>\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_null(err);
+    assert_non_null(tmpl);
+    blogc_template_node_t *ast = tmpl->nodes;
     assert_non_null(ast);
     blogc_assert_template_node(ast, "<html>\n    <head>\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next, "entry",
+    blogc_assert_template_node(ast + 1, "entry",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(ast->next->next,
+    blogc_assert_template_node(ast + 2,
         "\n        <title>My cool blog >> ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next, "TITLE",
+    blogc_assert_template_node(ast + 3, "TITLE",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(ast->next->next->next->next,
+    blogc_assert_template_node(ast + 4,
         "</title>\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next, NULL,
+    blogc_assert_template_node(ast + 5, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(ast->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 6,
         "\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 7,
         "listing_once", BLOGC_TEMPLATE_NODE_BLOCK);
-    bc_slist_t *tmp = ast->next->next->next->next->next->next->next->next;
+    blogc_template_node_t *tmp = ast + 8;
     blogc_assert_template_node(tmp,
         "\n        <title>My cool blog - Main page</title>\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next,
+    blogc_assert_template_node(tmp + 1, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
+    blogc_assert_template_node(tmp + 2,
         "\n    </head>\n    <body>\n        <h1>My cool blog</h1>\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, "entry",
+    blogc_assert_template_node(tmp + 3, "entry",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next,
+    blogc_assert_template_node(tmp + 4,
         "\n        <h2>", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "TITLE", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "</h2>\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "DATE", BLOGC_TEMPLATE_NODE_IFDEF);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, "<h4>Published in: ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "DATE", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next, "</h4>",
+    blogc_assert_template_node(tmp + 1, "DATE", BLOGC_TEMPLATE_NODE_VARIABLE);
+    blogc_assert_template_node(tmp + 2, "</h4>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 3, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next->next, "\n        <pre>",
+    blogc_assert_template_node(tmp + 4, "\n        <pre>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "CONTENT", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "</pre>\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, "\n        ", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "listing_once",
+    blogc_assert_template_node(tmp + 1, "listing_once",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next, "<ul>",
+    blogc_assert_template_node(tmp + 2, "<ul>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 3, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next, "\n        ",
+    blogc_assert_template_node(tmp + 4, "\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "listing", BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "<p><a href=\"", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "FILENAME", BLOGC_TEMPLATE_NODE_VARIABLE);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, ".html\">", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next, "TITLE",
+    blogc_assert_template_node(tmp + 1, "TITLE",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next, "</a>",
+    blogc_assert_template_node(tmp + 2, "</a>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next, "DATE",
+    blogc_assert_template_node(tmp + 3, "DATE",
         BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(tmp->next->next->next->next, " - ",
+    blogc_assert_template_node(tmp + 4, " - ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "DATE",
+    blogc_assert_template_node(tmp + 5, "DATE",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "</p>", BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next, "\n        ",
+    blogc_assert_template_node(tmp + 1, "\n        ",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, "listing_once",
+    blogc_assert_template_node(tmp + 2, "listing_once",
         BLOGC_TEMPLATE_NODE_BLOCK);
-    blogc_assert_template_node(tmp->next->next->next, "</ul>",
+    blogc_assert_template_node(tmp + 3, "</ul>",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 4, NULL,
         BLOGC_TEMPLATE_NODE_ENDBLOCK);
-    blogc_assert_template_node(tmp->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 5,
         "\n    </body>\n</html>\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    assert_null(tmp->next->next->next->next->next->next);
-    blogc_template_free_ast(ast);
+    assert_int_equal(tmp + 6 - ast, tmpl->nodes_len);
+    blogc_template_free(tmpl);
 }
 
 
@@ -486,29 +492,31 @@ test_template_parse_ifdef_and_var_outside_block(void **state)
         "{{ BOLA }}\n"
         "{% ifndef CHUNDA %}{{ CHUNDA }}{% endif %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_null(err);
+    assert_non_null(tmpl);
+    blogc_template_node_t *ast = tmpl->nodes;
     assert_non_null(ast);
     blogc_assert_template_node(ast, "GUDA", BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(ast->next, "bola",
+    blogc_assert_template_node(ast + 1, "bola",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next, NULL,
+    blogc_assert_template_node(ast + 2, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(ast->next->next->next, "\n",
+    blogc_assert_template_node(ast + 3, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next, "BOLA",
+    blogc_assert_template_node(ast + 4, "BOLA",
         BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(ast->next->next->next->next->next, "\n",
+    blogc_assert_template_node(ast + 5, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 6,
         "CHUNDA", BLOGC_TEMPLATE_NODE_IFNDEF);
-    bc_slist_t *tmp = ast->next->next->next->next->next->next->next;
+    blogc_template_node_t *tmp = ast + 7;
     blogc_assert_template_node(tmp, "CHUNDA", BLOGC_TEMPLATE_NODE_VARIABLE);
-    blogc_assert_template_node(tmp->next, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next, "\n",
+    blogc_assert_template_node(tmp + 1, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
+    blogc_assert_template_node(tmp + 2, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    assert_null(tmp->next->next->next);
-    blogc_template_free_ast(ast);
+    assert_int_equal(tmp + 3 - ast, tmpl->nodes_len);
+    blogc_template_free(tmpl);
 }
 
 
@@ -533,50 +541,178 @@ test_template_parse_nested_else(void **state)
         "{% endif %}\n"
         "{% endif %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_null(err);
+    assert_non_null(tmpl);
+    blogc_template_node_t *ast = tmpl->nodes;
     assert_non_null(ast);
     blogc_assert_template_node(ast, "GUDA", BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(ast->next, "\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next, "BOLA", BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(ast->next->next->next, "\nasd\n",
+    blogc_assert_template_node(ast + 1, "\n", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(ast + 2, "BOLA", BLOGC_TEMPLATE_NODE_IFDEF);
+    blogc_assert_template_node(ast + 3, "\nasd\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next, NULL,
+    blogc_assert_template_node(ast + 4, NULL,
         BLOGC_TEMPLATE_NODE_ELSE);
-    blogc_assert_template_node(ast->next->next->next->next->next, "\n",
+    blogc_assert_template_node(ast + 5, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(ast->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 6,
         "CHUNDA", BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(ast->next->next->next->next->next->next->next,
+    blogc_assert_template_node(ast + 7,
         "\nqwe\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    bc_slist_t *tmp = ast->next->next->next->next->next->next->next->next;
+    blogc_template_node_t *tmp = ast + 8;
     blogc_assert_template_node(tmp, NULL, BLOGC_TEMPLATE_NODE_ELSE);
-    blogc_assert_template_node(tmp->next, "\nrty\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, NULL,
+    blogc_assert_template_node(tmp + 1, "\nrty\n", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 2, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 3, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 4, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 5, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 6,
         "LOL", BLOGC_TEMPLATE_NODE_IFDEF);
-    blogc_assert_template_node(tmp->next->next->next->next->next->next->next,
+    blogc_assert_template_node(tmp + 7,
         "\nzxc\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    tmp = tmp->next->next->next->next->next->next->next->next;
+    tmp += 8;
     blogc_assert_template_node(tmp, NULL, BLOGC_TEMPLATE_NODE_ELSE);
-    blogc_assert_template_node(tmp->next, "\nbnm\n", BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next, NULL,
+    blogc_assert_template_node(tmp + 1, "\nbnm\n", BLOGC_TEMPLATE_NODE_CONTENT);
+    blogc_assert_template_node(tmp + 2, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 3, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    blogc_assert_template_node(tmp->next->next->next->next, NULL,
+    blogc_assert_template_node(tmp + 4, NULL,
         BLOGC_TEMPLATE_NODE_ENDIF);
-    blogc_assert_template_node(tmp->next->next->next->next->next, "\n",
+    blogc_assert_template_node(tmp + 5, "\n",
         BLOGC_TEMPLATE_NODE_CONTENT);
-    assert_null(tmp->next->next->next->next->next->next);
-    blogc_template_free_ast(ast);
+    assert_int_equal(tmp + 6 - ast, tmpl->nodes_len);
+    blogc_template_free(tmpl);
+}
+
+
+static void
+test_template_parse_jumps(void **state)
+{
+    const char *a =
+        "{% block listing %}"
+        "{% ifdef A %}a"
+        "{% if B == C %}b{% endif %}"
+        "{% else %}"
+        "{% foreach D %}d{% endforeach %}"
+        "{% endif %}"
+        "{% endblock %}";
+    bc_error_t *err = NULL;
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_non_null(tmpl);
+    assert_int_equal(tmpl->nodes_len, 12);
+    blogc_template_node_t *ast = tmpl->nodes;
+    blogc_assert_template_node(ast, "listing", BLOGC_TEMPLATE_NODE_BLOCK);
+    assert_int_equal(ast[0].jump, 11);
+    blogc_assert_template_node(ast + 1, "A", BLOGC_TEMPLATE_NODE_IFDEF);
+    assert_int_equal(ast[1].jump, 6);
+    blogc_assert_template_if_node(ast + 3, "B", BLOGC_TEMPLATE_OP_EQ, "C");
+    assert_int_equal(ast[3].jump, 5);
+    blogc_assert_template_node(ast + 5, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
+    assert_int_equal(ast[5].jump, 3);
+    blogc_assert_template_node(ast + 6, NULL, BLOGC_TEMPLATE_NODE_ELSE);
+    assert_int_equal(ast[6].jump, 10);
+    blogc_assert_template_node(ast + 7, "D", BLOGC_TEMPLATE_NODE_FOREACH);
+    assert_int_equal(ast[7].jump, 9);
+    blogc_assert_template_node(ast + 9, NULL, BLOGC_TEMPLATE_NODE_ENDFOREACH);
+    assert_int_equal(ast[9].jump, 7);
+    blogc_assert_template_node(ast + 10, NULL, BLOGC_TEMPLATE_NODE_ENDIF);
+    assert_int_equal(ast[10].jump, 1);
+    blogc_assert_template_node(ast + 11, NULL, BLOGC_TEMPLATE_NODE_ENDBLOCK);
+    assert_int_equal(ast[11].jump, 0);
+    blogc_template_free(tmpl);
+}
+
+
+static void
+test_template_parse_operands(void **state)
+{
+    const char *a =
+        "{{ TITLE }}{{ TITLE_5 }}{{ DATE_FORMATTED_10 }}{{ BOLA_FORMATTED }}"
+        "{% if FOREACH_ITEM_2 != \"a\\\"b\" %}{% endif %}"
+        "{% ifdef BLOGC_SYSINFO_USERNAME %}{% endif %}";
+    bc_error_t *err = NULL;
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_non_null(tmpl);
+    assert_int_equal(tmpl->nodes_len, 8);
+    blogc_template_node_t *ast = tmpl->nodes;
+    blogc_template_operand_t *op = &ast[0].operands[0];
+    assert_string_equal(op->name, "TITLE");
+    assert_ptr_equal(op->base, op->name);
+    assert_int_equal(op->len, -1);
+    assert_int_equal(op->formatter, BLOGC_TEMPLATE_FORMATTER_NONE);
+    assert_int_equal(op->special, BLOGC_TEMPLATE_SPECIAL_NONE);
+    assert_null(op->funcvar);
+    assert_false(op->literal);
+    op = &ast[1].operands[0];
+    assert_string_equal(op->name, "TITLE_5");
+    assert_string_equal(op->base, "TITLE");
+    assert_int_equal(op->len, 5);
+    assert_int_equal(op->formatter, BLOGC_TEMPLATE_FORMATTER_NONE);
+    op = &ast[2].operands[0];
+    assert_string_equal(op->base, "DATE");
+    assert_int_equal(op->len, 10);
+    assert_int_equal(op->formatter, BLOGC_TEMPLATE_FORMATTER_DATE);
+    op = &ast[3].operands[0];
+    assert_string_equal(op->base, "BOLA");
+    assert_int_equal(op->len, -1);
+    assert_int_equal(op->formatter, BLOGC_TEMPLATE_FORMATTER_UNKNOWN);
+    op = &ast[4].operands[0];
+    assert_string_equal(op->base, "FOREACH_ITEM");
+    assert_int_equal(op->len, 2);
+    assert_int_equal(op->special, BLOGC_TEMPLATE_SPECIAL_FOREACH_ITEM);
+    op = &ast[4].operands[1];
+    assert_string_equal(op->name, "a\\\"b");
+    assert_true(op->literal);
+    op = &ast[6].operands[0];
+    assert_string_equal(op->name, "BLOGC_SYSINFO_USERNAME");
+    assert_non_null(op->funcvar);
+    assert_null(ast[5].operands[0].name);
+    blogc_template_free(tmpl);
+}
+
+
+static void
+test_template_uses_variable(void **state)
+{
+    const char *a =
+        "{{ TITLE }}{{ CONTENT_10 }}{{ DATE_FORMATTED }}"
+        "{% if BOLA != \"EXCERPT\" %}{% endif %}"
+        "{% if GUDA == CHUNDA %}{% endif %}"
+        "{% ifndef LOL %}{% endif %}"
+        "{% foreach TAGS %}{% endforeach %}";
+    bc_error_t *err = NULL;
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    assert_null(err);
+    assert_non_null(tmpl);
+    assert_true(blogc_template_uses_variable(tmpl, "TITLE"));
+    assert_true(blogc_template_uses_variable(tmpl, "CONTENT"));
+    assert_true(blogc_template_uses_variable(tmpl, "CONTENT_10"));
+    assert_true(blogc_template_uses_variable(tmpl, "DATE"));
+    assert_true(blogc_template_uses_variable(tmpl, "DATE_FORMATTED"));
+    assert_true(blogc_template_uses_variable(tmpl, "BOLA"));
+    assert_true(blogc_template_uses_variable(tmpl, "GUDA"));
+    assert_true(blogc_template_uses_variable(tmpl, "CHUNDA"));
+    assert_true(blogc_template_uses_variable(tmpl, "LOL"));
+    assert_true(blogc_template_uses_variable(tmpl, "TAGS"));
+    assert_false(blogc_template_uses_variable(tmpl, "EXCERPT"));
+    assert_false(blogc_template_uses_variable(tmpl, "CONTENT_1"));
+    assert_false(blogc_template_uses_variable(tmpl, "TOCTREE"));
+    assert_false(blogc_template_uses_variable(tmpl, NULL));
+    assert_false(blogc_template_uses_variable(NULL, "TITLE"));
+
+    // nameless foreach statements can't match anything
+    for (size_t i = 0; i < tmpl->nodes_len; i++)
+        if (tmpl->nodes[i].type == BLOGC_TEMPLATE_NODE_FOREACH)
+            tmpl->nodes[i].data[0] = NULL;
+    assert_false(blogc_template_uses_variable(tmpl, "TAGS"));
+    blogc_template_free(tmpl);
 }
 
 
@@ -585,9 +721,9 @@ test_template_parse_invalid_block_start(void **state)
 {
     const char *a = "{% ASD %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Must begin with lowercase letter.\n"
@@ -595,9 +731,9 @@ test_template_parse_invalid_block_start(void **state)
     bc_error_free(err);
     a = "{%-- block entry %}\n";
     err = NULL;
-    ast = blogc_template_parse(a, strlen(a), &err);
+    tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Duplicated whitespace cleaner before statement.\n"
@@ -605,9 +741,9 @@ test_template_parse_invalid_block_start(void **state)
     bc_error_free(err);
     a = "{% block entry --%}\n";
     err = NULL;
-    ast = blogc_template_parse(a, strlen(a), &err);
+    tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Duplicated whitespace cleaner after statement.\n"
@@ -623,9 +759,9 @@ test_template_parse_invalid_block_nested(void **state)
         "{% block entry %}\n"
         "{% block listing %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Blocks can't be nested.\n"
@@ -641,9 +777,9 @@ test_template_parse_invalid_foreach_nested(void **state)
         "{% foreach A %}\n"
         "{% foreach B %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'foreach' statements can't be nested.\n"
@@ -657,9 +793,9 @@ test_template_parse_invalid_block_not_open(void **state)
 {
     const char *a = "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'endblock' statement without an open 'block' statement.\n"
@@ -673,9 +809,9 @@ test_template_parse_invalid_endif_not_open(void **state)
 {
     const char *a = "{% block listing %}{% endif %}{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'endif' statement without an open 'if', 'ifdef' or 'ifndef' statement.\n"
@@ -690,9 +826,9 @@ test_template_parse_invalid_endif_not_open_inside_block(void **state)
 {
     const char *a = "{% ifdef BOLA %}{% block listing %}{% endif %}{% endblock %}";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'endif' statement without an open 'if', 'ifdef' or 'ifndef' statement.\n"
@@ -707,9 +843,9 @@ test_template_parse_invalid_else_not_open_inside_block(void **state)
 {
     const char *a = "{% ifdef BOLA %}{% block listing %}{% else %}{% endif %}{% endblock %}";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'else' statement without an open 'if', 'ifdef' or 'ifndef' statement.\n"
@@ -724,9 +860,9 @@ test_template_parse_invalid_endforeach_not_open(void **state)
 {
     const char *a = "{% endforeach %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'endforeach' statement without an open 'foreach' statement.\n"
@@ -741,9 +877,9 @@ test_template_parse_invalid_endforeach_not_open_inside_block(void **state)
     const char *a = "{% foreach TAGS %}{% block entry %}{% endforeach %}"
         "{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'endforeach' statement without an open 'foreach' statement.\n"
@@ -759,9 +895,9 @@ test_template_parse_invalid_endforeach_not_open_inside_block2(void **state)
     const char *a = "{% block entry %}{% foreach TAGS %}"
         "{% endforeach %}{% endforeach %}{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'endforeach' statement without an open 'foreach' statement.\n"
@@ -777,9 +913,9 @@ test_template_parse_invalid_endforeach_not_closed_inside_block(void **state)
     const char *a = "{% block entry %}{% foreach TAGS %}{% endblock %}"
         "{% endforeach %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "An open 'foreach' statement was not closed inside a 'entry' block!");
@@ -793,9 +929,9 @@ test_template_parse_invalid_endforeach_not_closed_inside_block2(void **state)
     const char *a = "{% block entry %}{% foreach TAGS %}{% endforeach %}"
         "{% foreach TAGS %}{% endblock %}{% endforeach %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "An open 'foreach' statement was not closed inside a 'entry' block!");
@@ -808,9 +944,9 @@ test_template_parse_invalid_block_name(void **state)
 {
     const char *a = "{% chunda %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement type: Allowed types are: 'block', 'endblock', 'if', "
@@ -825,9 +961,9 @@ test_template_parse_invalid_block_type_start(void **state)
 {
     const char *a = "{% block ENTRY %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid block syntax. Must begin with lowercase letter.\n"
@@ -841,9 +977,9 @@ test_template_parse_invalid_block_type(void **state)
 {
     const char *a = "{% block chunda %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid block type. Allowed types are: 'entry', 'listing', 'listing_once', "
@@ -858,9 +994,9 @@ test_template_parse_invalid_ifdef_start(void **state)
 {
     const char *a = "{% block entry %}{% ifdef guda %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid variable name. Must begin with uppercase letter.\n"
@@ -875,9 +1011,9 @@ test_template_parse_invalid_foreach_start(void **state)
 {
     const char *a = "{% block entry %}{% foreach guda %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid foreach variable name. Must begin with uppercase letter.\n"
@@ -892,9 +1028,9 @@ test_template_parse_invalid_ifdef_variable(void **state)
 {
     const char *a = "{% block entry %}{% ifdef BoLA %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid variable name. Must be uppercase letter, number or '_'.\n"
@@ -909,9 +1045,9 @@ test_template_parse_invalid_ifdef_variable2(void **state)
 {
     const char *a = "{% block entry %}{% ifdef 0123 %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid variable name. Must begin with uppercase letter.\n"
@@ -926,9 +1062,9 @@ test_template_parse_invalid_foreach_variable(void **state)
 {
     const char *a = "{% block entry %}{% foreach BoLA %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid foreach variable name. Must be uppercase letter, number or '_'.\n"
@@ -943,9 +1079,9 @@ test_template_parse_invalid_foreach_variable2(void **state)
 {
     const char *a = "{% block entry %}{% foreach 0123 %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid foreach variable name. Must begin with uppercase letter.\n"
@@ -960,9 +1096,9 @@ test_template_parse_invalid_if_operator(void **state)
 {
     const char *a = "{% block entry %}{% if BOLA = \"asd\" %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid 'if' operator. Must be '<', '>', '<=', '>=', '==' or '!='.\n"
@@ -977,9 +1113,9 @@ test_template_parse_invalid_if_operand(void **state)
 {
     const char *a = "{% block entry %}{% if BOLA == asd %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid 'if' operand. Must be double-quoted static string or variable.\n"
@@ -994,9 +1130,9 @@ test_template_parse_invalid_if_operand2(void **state)
 {
     const char *a = "{% block entry %}{% if BOLA == \"asd %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Found an open double-quoted string.\n"
@@ -1011,9 +1147,9 @@ test_template_parse_invalid_if_operand3(void **state)
 {
     const char *a = "{% block entry %}{% if BOLA == 0123 %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid 'if' operand. Must be double-quoted static string or variable.\n"
@@ -1028,9 +1164,9 @@ test_template_parse_invalid_else1(void **state)
 {
     const char *a = "{% else %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "'else' statement without an open 'if', 'ifdef' or 'ifndef' statement.\n"
@@ -1044,9 +1180,9 @@ test_template_parse_invalid_else2(void **state)
 {
     const char *a = "{% if BOLA == \"123\" %}{% if GUDA == \"1\" %}{% else %}{% else %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "More than one 'else' statement for an open 'if', 'ifdef' or 'ifndef' "
@@ -1068,9 +1204,9 @@ test_template_parse_invalid_else3(void **state)
         "{% else %}\n"
         "{% else %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "More than one 'else' statement for an open 'if', 'ifdef' or 'ifndef' "
@@ -1084,9 +1220,9 @@ test_template_parse_invalid_block_end(void **state)
 {
     const char *a = "{% block entry }}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Must end with '%}'.\n"
@@ -1100,9 +1236,9 @@ test_template_parse_invalid_variable_name(void **state)
 {
     const char *a = "{% block entry %}{{ bola }}{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid variable name. Must begin with uppercase letter.\n"
@@ -1117,9 +1253,9 @@ test_template_parse_invalid_variable_name2(void **state)
 {
     const char *a = "{% block entry %}{{ Bola }}{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid variable name. Must be uppercase letter, number or '_'.\n"
@@ -1134,9 +1270,9 @@ test_template_parse_invalid_variable_name3(void **state)
 {
     const char *a = "{% block entry %}{{ 0123 }}{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid variable name. Must begin with uppercase letter.\n"
@@ -1151,9 +1287,9 @@ test_template_parse_invalid_variable_end(void **state)
 {
     const char *a = "{% block entry %}{{ BOLA %}{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Must end with '}}'.\n"
@@ -1168,9 +1304,9 @@ test_template_parse_invalid_close(void **state)
 {
     const char *a = "{% block entry %%\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Must end with '}'.\n"
@@ -1184,9 +1320,9 @@ test_template_parse_invalid_close2(void **state)
 {
     const char *a = "{% block entry %}{{ BOLA }%{% endblock %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "Invalid statement syntax. Must end with '}'.\n"
@@ -1201,9 +1337,9 @@ test_template_parse_invalid_endif_not_closed(void **state)
 {
     const char *a = "{% block entry %}{% endblock %}{% ifdef BOLA %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg, "1 open 'if', 'ifdef' and/or 'ifndef' statements "
         "were not closed!");
@@ -1216,9 +1352,9 @@ test_template_parse_invalid_endif_not_closed_inside_block(void **state)
 {
     const char *a = "{% block listing %}{% ifdef BOLA %}{% endblock %}{% endif %}";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "1 open 'if', 'ifdef' and/or 'ifndef' statements were not closed inside "
@@ -1232,9 +1368,9 @@ test_template_parse_invalid_else_not_closed_inside_block(void **state)
 {
     const char *a = "{% block listing %}{% ifdef BOLA %}{% else %}{% endblock %}{% endif %}";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg,
         "1 open 'if', 'ifdef' and/or 'ifndef' statements were not closed inside "
@@ -1248,9 +1384,9 @@ test_template_parse_invalid_block_not_closed(void **state)
 {
     const char *a = "{% block entry %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg, "An open block was not closed!");
     bc_error_free(err);
@@ -1262,25 +1398,57 @@ test_template_parse_invalid_foreach_not_closed(void **state)
 {
     const char *a = "{% foreach ASD %}\n";
     bc_error_t *err = NULL;
-    bc_slist_t *ast = blogc_template_parse(a, strlen(a), &err);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
     assert_non_null(err);
-    assert_null(ast);
+    assert_null(tmpl);
     assert_int_equal(err->type, BLOGC_ERROR_TEMPLATE_PARSER);
     assert_string_equal(err->msg, "An open 'foreach' statement was not closed!");
     bc_error_free(err);
 }
 
 
+static void
+test_template_parse_alloc_budget(void **state)
+{
+    const char *a =
+        "{% block entry %}\n"
+        "<h1>{{ TITLE }}</h1>\n"
+        "{% ifdef DATE %}<p>{{ DATE_FORMATTED }}</p>{% endif %}\n"
+        "{% foreach TAGS %}<a href=\"{{ FOREACH_ITEM }}\">{{ FOREACH_ITEM }}</a>{% endforeach %}\n"
+        "{{ CONTENT }}\n"
+        "{% endblock %}\n"
+        "{% block listing %}\n"
+        "{% if TITLE != \"bola\" %}<li>{{ TITLE }}</li>{% else %}<li>bola</li>{% endif %}\n"
+        "{% endblock %}\n";
+    bc_error_t *err = NULL;
+    bc_alloc_stats_reset();
+    bc_alloc_stats_enable(true);
+    blogc_template_t *tmpl = blogc_template_parse(a, strlen(a), &err);
+    bc_alloc_stats_enable(false);
+    assert_null(err);
+    assert_non_null(tmpl);
+    bc_alloc_stats_t stats;
+    bc_alloc_stats_get(&stats);
+    // nodes and strings come from the template arena
+    assert_true(stats.calls <= 8);
+    blogc_template_free(tmpl);
+}
+
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_template_parse),
+        cmocka_unit_test(test_template_parse_alloc_budget),
         cmocka_unit_test(test_template_parse_crlf),
         cmocka_unit_test(test_template_parse_html),
         cmocka_unit_test(test_template_parse_html_whitespace),
         cmocka_unit_test(test_template_parse_ifdef_and_var_outside_block),
         cmocka_unit_test(test_template_parse_nested_else),
+        cmocka_unit_test(test_template_parse_jumps),
+        cmocka_unit_test(test_template_parse_operands),
+        cmocka_unit_test(test_template_uses_variable),
         cmocka_unit_test(test_template_parse_invalid_block_start),
         cmocka_unit_test(test_template_parse_invalid_block_nested),
         cmocka_unit_test(test_template_parse_invalid_foreach_nested),
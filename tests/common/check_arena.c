@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../src/common/arena.h"
+
+
+static void
+test_arena_alloc(void **state)
+{
+    bc_arena_t *arena = bc_arena_new(0);
+    assert_non_null(arena);
+    assert_int_equal(arena->chunk_size, BC_ARENA_CHUNK_SIZE);
+    assert_null(arena->chunks);
+    char *a = bc_arena_alloc(arena, 10);
+    assert_non_null(a);
+    memset(a, 'a', 10);
+    char *b = bc_arena_alloc(arena, 1);
+    assert_non_null(b);
+    assert_true(b >= a + 10);
+    assert_int_equal(((uintptr_t) b) % alignof(max_align_t), 0);
+    memset(b, 'b', 1);
+    assert_non_null(arena->chunks);
+    assert_null(arena->chunks->next);
+    assert_int_equal(a[9], 'a');
+    bc_arena_free(arena);
+    assert_null(bc_arena_alloc(NULL, 10));
+    bc_arena_free(NULL);
+}
+
+
+static void
+test_arena_alloc_chunks(void **state)
+{
+    bc_arena_t *arena = bc_arena_new(128);
+    assert_int_equal(arena->chunk_size, 128);
+    char *a = bc_arena_alloc(arena, 16);
+    bc_arena_chunk_t *first = arena->chunks;
+    for (size_t i = 0; i < 10; i++)
+        bc_arena_alloc(arena, 16);
+    assert_ptr_not_equal(arena->chunks, first);
+    assert_non_null(arena->chunks->next);
+
+    // big allocations get a chunk of their own, behind the current chunk.
+    bc_arena_chunk_t *current = arena->chunks;
+    char *big = bc_arena_alloc(arena, 1000);
+    memset(big, 'x', 1000);
+    assert_ptr_equal(arena->chunks, current);
+    assert_int_equal(current->next->len, 1008);
+    assert_int_equal(current->next->used, 1008);
+    char *c = bc_arena_alloc(arena, 16);
+    assert_ptr_equal(arena->chunks, current);
+    assert_non_null(a);
+    assert_non_null(c);
+    bc_arena_free(arena);
+}
+
+
+static void
+test_arena_strdup(void **state)
+{
+    bc_arena_t *arena = bc_arena_new(0);
+    char *str = bc_arena_strdup(arena, "bola");
+    assert_string_equal(str, "bola");
+    assert_null(bc_arena_strdup(arena, NULL));
+    assert_null(bc_arena_strdup(NULL, "bola"));
+    bc_arena_free(arena);
+}
+
+
+static void
+test_arena_strndup(void **state)
+{
+    bc_arena_t *arena = bc_arena_new(0);
+    char *str = bc_arena_strndup(arena, "bolaguda", 4);
+    assert_string_equal(str, "bola");
+    str = bc_arena_strndup(arena, "bolaguda", 30);
+    assert_string_equal(str, "bolaguda");
+    str = bc_arena_strndup(arena, "bolaguda", 8);
+    assert_string_equal(str, "bolaguda");
+    str = bc_arena_strndup(arena, "bolaguda", 0);
+    assert_string_equal(str, "");
+    assert_null(bc_arena_strndup(arena, NULL, 10));
+    assert_null(bc_arena_strndup(NULL, "bola", 10));
+    bc_arena_free(arena);
+}
+
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_arena_alloc),
+        cmocka_unit_test(test_arena_alloc_chunks),
+        cmocka_unit_test(test_arena_strdup),
+        cmocka_unit_test(test_arena_strndup),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
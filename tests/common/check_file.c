@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2014-2024 Rafael G. Martins <rafael@rafaelmartins.eng.br>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../../src/common/error.h"
+#include "../../src/common/file.h"
+#include "../../src/common/utils.h"
+
+
+static char*
+create_file(const char *content, size_t len)
+{
+    char *path = bc_strdup("/tmp/blogc_check_file_XXXXXX");
+    int fd = mkstemp(path);
+    assert_true(fd >= 0);
+    assert_int_equal(write(fd, content, len), len);
+    close(fd);
+    return path;
+}
+
+
+static void
+test_file_get_contents(void **state)
+{
+    char *path = create_file("bola\nguda\n", 10);
+    bc_error_t *err = NULL;
+    size_t len;
+    char *c = bc_file_get_contents(path, true, &len, &err);
+    assert_null(err);
+    assert_string_equal(c, "bola\nguda\n");
+    assert_int_equal(len, 10);
+    free(c);
+    unlink(path);
+    free(path);
+
+    path = create_file("", 0);
+    c = bc_file_get_contents(path, true, &len, &err);
+    assert_null(err);
+    assert_string_equal(c, "");
+    assert_int_equal(len, 0);
+    free(c);
+    unlink(path);
+    free(path);
+}
+
+
+static void
+test_file_get_contents_bom(void **state)
+{
+    char *path = create_file("\xef\xbb\xbf" "bola\n", 8);
+    bc_error_t *err = NULL;
+    size_t len;
+    char *c = bc_file_get_contents(path, true, &len, &err);
+    assert_null(err);
+    assert_string_equal(c, "bola\n");
+    assert_int_equal(len, 5);
+    free(c);
+    c = bc_file_get_contents(path, false, &len, &err);
+    assert_null(err);
+    assert_string_equal(c, "\xef\xbb\xbf" "bola\n");
+    assert_int_equal(len, 8);
+    free(c);
+    unlink(path);
+    free(path);
+}
+
+
+static void
+test_file_get_contents_error(void **state)
+{
+    bc_error_t *err = NULL;
+    size_t len;
+    char *c = bc_file_get_contents("/tmp/blogc_check_file_nonexistent", true,
+        &len, &err);
+    assert_null(c);
+    assert_non_null(err);
+    assert_int_equal(err->type, BC_ERROR_FILE);
+    assert_string_equal(err->msg, "Failed to open file "
+        "(/tmp/blogc_check_file_nonexistent): No such file or directory");
+    bc_error_free(err);
+    err = NULL;
+
+    char *path = create_file("bola\xff\xfe", 6);
+    c = bc_file_get_contents(path, true, &len, &err);
+    assert_null(c);
+    assert_non_null(err);
+    assert_int_equal(err->type, BC_ERROR_FILE);
+    char *msg = bc_strdup_printf("File content is not valid UTF-8: %s", path);
+    assert_string_equal(err->msg, msg);
+    free(msg);
+    bc_error_free(err);
+    err = NULL;
+    c = bc_file_get_contents(path, false, &len, &err);
+    assert_null(err);
+    assert_int_equal(len, 6);
+    free(c);
+    unlink(path);
+    free(path);
+}
+
+
+static void
+test_file_map(void **state)
+{
+    // small files are read into memory
+    char *path = create_file("\xef\xbb\xbf" "bola\n", 8);
+    bc_error_t *err = NULL;
+    bc_file_map_t *m = bc_file_map(path, true, &err);
+    assert_null(err);
+    assert_non_null(m);
+    assert_null(m->map);
+    assert_int_equal(m->len, 5);
+    assert_memory_equal(m->str, "bola\n", 5);
+    bc_file_unmap(m);
+    unlink(path);
+    free(path);
+
+    // big files are mapped
+    size_t len = BC_FILE_MAP_THRESHOLD + 3 + 10;
+    char *content = bc_malloc(len);
+    memcpy(content, "\xef\xbb\xbf", 3);
+    memset(content + 3, 'a', len - 3);
+    path = create_file(content, len);
+    m = bc_file_map(path, true, &err);
+    assert_null(err);
+    assert_non_null(m);
+    assert_non_null(m->map);
+    assert_int_equal(m->map_len, len);
+    assert_int_equal(m->len, len - 3);
+    assert_memory_equal(m->str, content + 3, len - 3);
+    bc_file_unmap(m);
+    m = bc_file_map(path, false, &err);
+    assert_null(err);
+    assert_non_null(m);
+    assert_int_equal(m->len, len);
+    assert_memory_equal(m->str, content, len);
+    bc_file_unmap(m);
+    unlink(path);
+    free(path);
+
+    content[len - 1] = '\xff';
+    path = create_file(content, len);
+    m = bc_file_map(path, true, &err);
+    assert_null(m);
+    assert_non_null(err);
+    assert_int_equal(err->type, BC_ERROR_FILE);
+    bc_error_free(err);
+    unlink(path);
+    free(path);
+    free(content);
+}
+
+
+static void
+test_file_writer(void **state)
+{
+    char *path = create_file("", 0);
+    int fd = open(path, O_WRONLY | O_TRUNC);
+    assert_true(fd >= 0);
+
+    size_t len = BC_FILE_WRITER_BUFFER_SIZE * 2 + 10;
+    char *content = bc_malloc(len);
+    for (size_t i = 0; i < len; i++)
+        content[i] = 'a' + (i % 26);
+    content[5] = '\0';
+
+    bc_file_writer_t *w = bc_file_writer_new(fd);
+    bc_file_writer_write(w, content, 10);
+    assert_int_equal(w->len, 10);
+    bc_file_writer_write(w, NULL, 10);
+    bc_file_writer_write(w, content + 10, 0);
+    assert_int_equal(w->len, 10);
+
+    // doesn't fit in the buffer, goes straight to the file with the buffer
+    bc_file_writer_write(w, content + 10, BC_FILE_WRITER_BUFFER_SIZE);
+    assert_int_equal(w->len, 0);
+    bc_file_writer_write(w, content + 10 + BC_FILE_WRITER_BUFFER_SIZE,
+        BC_FILE_WRITER_BUFFER_SIZE);
+    assert_int_equal(w->len, BC_FILE_WRITER_BUFFER_SIZE);
+
+    bc_error_t *err = NULL;
+    assert_true(bc_file_writer_flush(w, path, &err));
+    assert_null(err);
+    assert_int_equal(w->len, 0);
+    bc_file_writer_free(w);
+    close(fd);
+
+    size_t c_len;
+    char *c = bc_file_get_contents(path, false, &c_len, &err);
+    assert_null(err);
+    assert_int_equal(c_len, len);
+    assert_memory_equal(c, content, len);
+    free(c);
+
+    // write errors are reported when flushing
+    fd = open(path, O_RDONLY);
+    assert_true(fd >= 0);
+    w = bc_file_writer_new(fd);
+    bc_file_writer_write(w, content, 10);
+    assert_true(w->error == 0);
+    assert_false(bc_file_writer_flush(w, path, &err));
+    assert_non_null(err);
+    assert_int_equal(err->type, BC_ERROR_FILE);
+    bc_error_free(err);
+    bc_file_writer_free(w);
+    close(fd);
+
+    unlink(path);
+    free(path);
+    free(content);
+}
+
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_file_get_contents),
+        cmocka_unit_test(test_file_get_contents_bom),
+        cmocka_unit_test(test_file_get_contents_error),
+        cmocka_unit_test(test_file_map),
+        cmocka_unit_test(test_file_writer),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
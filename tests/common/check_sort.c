@@ -128,6 +128,58 @@ test_slist_sort_mixed2(void **state)
 }
 
 
+static int
+sort_first_char_func(void *a, void *b)
+{
+    return ((char*) a)[0] - ((char*) b)[0];
+}
+
+
+static void
+test_slist_sort_stable(void **state)
+{
+    bc_slist_t *l = NULL;
+    l = bc_slist_append(l, bc_strdup("b1"));
+    l = bc_slist_append(l, bc_strdup("a1"));
+    l = bc_slist_append(l, bc_strdup("b2"));
+    l = bc_slist_append(l, bc_strdup("c1"));
+    l = bc_slist_append(l, bc_strdup("a2"));
+    l = bc_slist_append(l, bc_strdup("b3"));
+    l = bc_slist_append(l, bc_strdup("a3"));
+
+    l = bc_slist_sort(l, (bc_sort_func_t) sort_first_char_func);
+
+    assert_non_null(l);
+    assert_string_equal(l->data, "a1");
+    assert_string_equal(l->next->data, "a2");
+    assert_string_equal(l->next->next->data, "a3");
+    assert_string_equal(l->next->next->next->data, "b1");
+    assert_string_equal(l->next->next->next->next->data, "b2");
+    assert_string_equal(l->next->next->next->next->next->data, "b3");
+    assert_string_equal(l->next->next->next->next->next->next->data, "c1");
+    assert_null(l->next->next->next->next->next->next->next);
+
+    bc_slist_free_full(l, free);
+}
+
+
+static void
+test_slist_sort_large(void **state)
+{
+    bc_slist_t *l = NULL;
+    for (size_t i = 0; i < 10000; i++)
+        l = bc_slist_prepend(l, bc_strdup_printf("%05zu", (i * 7919) % 10007));
+
+    l = bc_slist_sort(l, (bc_sort_func_t) sort_func);
+
+    assert_int_equal(bc_slist_length(l), 10000);
+    for (bc_slist_t *tmp = l; tmp->next != NULL; tmp = tmp->next)
+        assert_true(strcmp(tmp->data, tmp->next->data) < 0);
+
+    bc_slist_free_full(l, free);
+}
+
+
 int
 main(void)
 {
@@ -138,6 +190,8 @@ main(void)
         cmocka_unit_test(test_slist_sort_reverse),
         cmocka_unit_test(test_slist_sort_mixed1),
         cmocka_unit_test(test_slist_sort_mixed2),
+        cmocka_unit_test(test_slist_sort_stable),
+        cmocka_unit_test(test_slist_sort_large),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -8,14 +8,34 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <sys/types.h>
+#include <unistd.h>
 #include "../../src/common/stdin.h"
+#include "../../src/common/utils.h"
 
+static const char *input = NULL;
+static size_t input_len = 0;
+static size_t read_calls = 0;
 
-int
-__wrap_fgetc(FILE *stream)
+
+ssize_t
+__wrap_read(int fd, void *buf, size_t count)
 {
-    assert_int_equal(fileno(stream), fileno(stdin));
-    return mock_type(int);
+    assert_int_equal(fd, STDIN_FILENO);
+    assert_true(count > 0);
+    read_calls++;
+    if (input == NULL) {
+        const char *chunk = mock_type(const char*);
+        size_t chunk_len = strlen(chunk);
+        assert_true(chunk_len <= count);
+        memcpy(buf, chunk, chunk_len);
+        return chunk_len;
+    }
+    size_t len = input_len < count ? input_len : count;
+    memcpy(buf, input, len);
+    input += len;
+    input_len -= len;
+    return len;
 }
 
 
@@ -23,18 +43,16 @@ static void
 test_read(void **state)
 {
     assert_null(bc_stdin_read(NULL));
-    will_return(__wrap_fgetc, EOF);
+    will_return(__wrap_read, "");
     size_t len;
     char *t = bc_stdin_read(&len);
     assert_non_null(t);
     assert_string_equal(t, "");
     assert_int_equal(len, 0);
     free(t);
-    will_return(__wrap_fgetc, 'b');
-    will_return(__wrap_fgetc, 'o');
-    will_return(__wrap_fgetc, 'l');
-    will_return(__wrap_fgetc, 'a');
-    will_return(__wrap_fgetc, EOF);
+    will_return(__wrap_read, "bo");
+    will_return(__wrap_read, "la");
+    will_return(__wrap_read, "");
     t = bc_stdin_read(&len);
     assert_non_null(t);
     assert_string_equal(t, "bola");
@@ -43,11 +61,36 @@ test_read(void **state)
 }
 
 
+static void
+test_read_large(void **state)
+{
+    // a multi-megabyte file list must be read in a few big chunks
+    bc_string_t *s = bc_string_new();
+    for (size_t i = 0; i < 200000; i++)
+        bc_string_append_printf(s, "content/post/post-%06zu.txt\n", i);
+
+    input = s->str;
+    input_len = s->len;
+    read_calls = 0;
+    size_t len;
+    char *t = bc_stdin_read(&len);
+    assert_non_null(t);
+    assert_int_equal(len, s->len);
+    assert_string_equal(t, s->str);
+    assert_true(read_calls < 100);
+    free(t);
+    input = NULL;
+
+    bc_string_free(s, true);
+}
+
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_read),
+        cmocka_unit_test(test_read_large),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -71,6 +71,71 @@ test_utf8_invalid_str(void **state)
 }
 
 
+static void
+test_utf8_validate_ascii_runs(void **state)
+{
+    // non-ASCII bytes around the block boundaries of the ASCII fast path
+    uint8_t buf[100];
+    for (size_t pos = 0; pos < 70; pos++) {
+        memset(buf, 'a', sizeof(buf));
+        buf[pos] = 0xc2;
+        buf[pos + 1] = 0xab;
+        assert_true(bc_utf8_validate(buf, sizeof(buf)));
+        assert_false(bc_utf8_validate(buf, pos + 1));
+        buf[pos + 1] = 'a';
+        assert_false(bc_utf8_validate(buf, sizeof(buf)));
+        for (size_t b = 0; b < 256; b++) {
+            memset(buf, 'a', sizeof(buf));
+            buf[pos] = b;
+            assert_int_equal(bc_utf8_validate(buf, sizeof(buf)),
+                bc_utf8_validate_dfa(buf, sizeof(buf)));
+        }
+    }
+}
+
+
+static void
+test_utf8_validate_dfa_oracle(void **state)
+{
+    static const char *pieces[] = {
+        "\xc2\xab", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xef\xbb\xbf",
+        "\xed\xa0\x80",  // surrogate
+        "\xc0\xaf",  // overlong
+        "\xf4\x90\x80\x80",  // out of range
+        "\xe2\x82",  // truncated
+        "\x80", "\xff",
+    };
+    size_t n_pieces = sizeof(pieces) / sizeof(pieces[0]);
+
+    uint32_t seed = 42;
+    uint8_t buf[512];
+    for (size_t i = 0; i < 20000; i++) {
+        size_t len = 0;
+        while (len < sizeof(buf) - 8) {
+            seed = seed * 1103515245 + 12345;
+            uint32_t r = seed >> 16;
+            if (r % 8 == 0)
+                break;
+            if (r % 4 != 0) {
+                size_t run = (r >> 3) % 70;
+                if (len + run > sizeof(buf) - 8)
+                    run = sizeof(buf) - 8 - len;
+                memset(buf + len, 'a' + (r % 26), run);
+                len += run;
+                continue;
+            }
+            // valid pieces are far more common than invalid ones
+            const char *piece = pieces[(r >> 3) % 4 != 0 ? (r >> 5) % 4 :
+                (r >> 5) % n_pieces];
+            memcpy(buf + len, piece, strlen(piece));
+            len += strlen(piece);
+        }
+        assert_int_equal(bc_utf8_validate(buf, len),
+            bc_utf8_validate_dfa(buf, len));
+    }
+}
+
+
 static void
 test_utf8_skip_bom(void **state)
 {
@@ -94,6 +159,8 @@ main(void)
         cmocka_unit_test(test_utf8_invalid),
         cmocka_unit_test(test_utf8_valid_str),
         cmocka_unit_test(test_utf8_invalid_str),
+        cmocka_unit_test(test_utf8_validate_ascii_runs),
+        cmocka_unit_test(test_utf8_validate_dfa_oracle),
         cmocka_unit_test(test_utf8_skip_bom),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -7,6 +7,7 @@
 #include <cmocka.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../../src/common/utils.h"
 
 #define BC_STRING_CHUNK_SIZE 128
@@ -30,6 +31,47 @@ test_slist_append(void **state)
 }
 
 
+static void
+test_slist_append_tail(void **state)
+{
+    bc_slist_t *l = NULL;
+    bc_slist_t *tail = NULL;
+    l = bc_slist_append_tail(l, &tail, (void*) bc_strdup("bola"));
+    assert_non_null(l);
+    assert_ptr_equal(tail, l);
+    assert_string_equal(l->data, "bola");
+    assert_null(l->next);
+    l = bc_slist_append_tail(l, &tail, (void*) bc_strdup("guda"));
+    assert_non_null(l);
+    assert_ptr_equal(tail, l->next);
+    assert_string_equal(l->data, "bola");
+    assert_string_equal(l->next->data, "guda");
+    assert_null(l->next->next);
+
+    // unknown tail of a non-empty list
+    tail = NULL;
+    l = bc_slist_append_tail(l, &tail, (void*) bc_strdup("chunda"));
+    assert_non_null(l);
+    assert_ptr_equal(tail, l->next->next);
+    assert_string_equal(l->data, "bola");
+    assert_string_equal(l->next->data, "guda");
+    assert_string_equal(l->next->next->data, "chunda");
+    assert_null(l->next->next->next);
+    bc_slist_free_full(l, free);
+
+    l = NULL;
+    tail = NULL;
+    for (size_t i = 0; i < 10000; i++)
+        l = bc_slist_append_tail(l, &tail, (void*) i);
+    assert_int_equal(bc_slist_length(l), 10000);
+    size_t i = 0;
+    for (bc_slist_t *tmp = l; tmp != NULL; tmp = tmp->next, i++)
+        assert_int_equal((size_t) tmp->data, i);
+    assert_null(tail->next);
+    bc_slist_free(l);
+}
+
+
 static void
 test_slist_prepend(void **state)
 {
@@ -357,6 +399,73 @@ test_strv_length(void **state)
 }
 
 
+static void
+test_strview(void **state)
+{
+    bc_strview_t v = bc_strview(NULL);
+    assert_null(v.str);
+    assert_int_equal(v.len, 0);
+    assert_null(bc_strview_dup(v));
+    v = bc_strview("  \tbola guda\n ");
+    assert_int_equal(v.len, 14);
+    assert_false(bc_strview_equal_str(v, "bola guda"));
+    bc_strview_t s = bc_strview_lstrip(v);
+    assert_int_equal(s.len, 11);
+    assert_memory_equal(s.str, "bola guda\n ", 11);
+    s = bc_strview_rstrip(v);
+    assert_int_equal(s.len, 12);
+    assert_memory_equal(s.str, "  \tbola guda", 12);
+    s = bc_strview_strip(v);
+    assert_true(bc_strview_equal_str(s, "bola guda"));
+    assert_true(bc_strview_equal(s, bc_strview_len("bola guda!", 9)));
+    assert_false(bc_strview_equal(s, bc_strview_len("bola guda!", 10)));
+    char *str = bc_strview_dup(s);
+    assert_string_equal(str, "bola guda");
+    free(str);
+    assert_int_equal(bc_strview_compare(bc_strview("a"), bc_strview("a")), 0);
+    assert_true(bc_strview_compare(bc_strview("a"), bc_strview("b")) < 0);
+    assert_true(bc_strview_compare(bc_strview("b"), bc_strview("a")) > 0);
+    assert_true(bc_strview_compare(bc_strview("ab"), bc_strview("a")) > 0);
+    assert_true(bc_strview_compare(bc_strview_len("ab", 1), bc_strview("ab")) < 0);
+    assert_true(bc_strview_compare(bc_strview("\xc3"), bc_strview("a")) > 0);
+    assert_int_equal(bc_strview_compare(bc_strview(""), bc_strview("")), 0);
+    s = bc_strview_strip(bc_strview(" \t "));
+    assert_int_equal(s.len, 0);
+    assert_true(bc_strview_equal_str(s, ""));
+}
+
+
+static void
+test_strview_split_next(void **state)
+{
+    bc_strview_t piece;
+    bc_strview_t iter = bc_strview("a  b ");
+    assert_true(bc_strview_split_next(&iter, ' ', &piece));
+    assert_true(bc_strview_equal_str(piece, "a"));
+    assert_true(bc_strview_split_next(&iter, ' ', &piece));
+    assert_true(bc_strview_equal_str(piece, ""));
+    assert_true(bc_strview_split_next(&iter, ' ', &piece));
+    assert_true(bc_strview_equal_str(piece, "b"));
+    assert_true(bc_strview_split_next(&iter, ' ', &piece));
+    assert_true(bc_strview_equal_str(piece, ""));
+    assert_null(iter.str);
+    assert_false(bc_strview_split_next(&iter, ' ', &piece));
+    iter = bc_strview("");
+    assert_true(bc_strview_split_next(&iter, ' ', &piece));
+    assert_int_equal(piece.len, 0);
+    assert_false(bc_strview_split_next(&iter, ' ', &piece));
+    iter = bc_strview("KEY=val=ue");
+    assert_true(bc_strview_split_next(&iter, '=', &piece));
+    assert_true(bc_strview_equal_str(piece, "KEY"));
+    assert_true(bc_strview_equal_str(iter, "val=ue"));
+    iter = bc_strview_len("ab,cd", 4);
+    assert_true(bc_strview_split_next(&iter, ',', &piece));
+    assert_true(bc_strview_split_next(&iter, ',', &piece));
+    assert_true(bc_strview_equal_str(piece, "c"));
+    assert_false(bc_strview_split_next(&iter, ',', &piece));
+}
+
+
 static void
 test_string_new(void **state)
 {
@@ -369,6 +478,58 @@ test_string_new(void **state)
 }
 
 
+static void
+test_string_new_sized(void **state)
+{
+    bc_string_t *str = bc_string_new_sized(0);
+    assert_non_null(str);
+    assert_string_equal(str->str, "");
+    assert_int_equal(str->len, 0);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE);
+    assert_null(bc_string_free(str, true));
+    str = bc_string_new_sized(BC_STRING_CHUNK_SIZE);
+    assert_non_null(str);
+    assert_string_equal(str->str, "");
+    assert_int_equal(str->len, 0);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 2);
+    assert_null(bc_string_free(str, true));
+    str = bc_string_new_sized(1000);
+    assert_non_null(str);
+    assert_string_equal(str->str, "");
+    assert_int_equal(str->len, 0);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 8);
+    for (int i = 0; i < 1000; i++)
+        str = bc_string_append_c(str, 'c');
+    assert_int_equal(str->len, 1000);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 8);
+    assert_null(bc_string_free(str, true));
+}
+
+
+static void
+test_string_reserve(void **state)
+{
+    bc_string_t *str = bc_string_new();
+    str = bc_string_append(str, "guda");
+    str = bc_string_reserve(str, 100);
+    assert_non_null(str);
+    assert_string_equal(str->str, "guda");
+    assert_int_equal(str->len, 4);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE);
+    str = bc_string_reserve(str, 1204);
+    assert_non_null(str);
+    assert_string_equal(str->str, "guda");
+    assert_int_equal(str->len, 4);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 10);
+    str = bc_string_reserve(str, 10);
+    assert_non_null(str);
+    assert_string_equal(str->str, "guda");
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 10);
+    assert_null(bc_string_free(str, true));
+    assert_null(bc_string_reserve(NULL, 10));
+}
+
+
 static void
 test_string_free(void **state)
 {
@@ -473,7 +634,7 @@ test_string_append_len(void **state)
         "pdnqokswiondusnuymqwaryrmdgscbnuilxtypuynckancsfnwtgokxhegoifakimxbba"
         "fkeannglvsxprqzfekdinssqymtfexf");
     assert_int_equal(str->len, 1204);
-    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 10);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 16);
     assert_null(bc_string_free(str, true));
     str = bc_string_new();
     str = bc_string_append_len(str, NULL, 0);
@@ -548,7 +709,7 @@ test_string_append(void **state)
         "pdnqokswiondusnuymqwaryrmdgscbnuilxtypuynckancsfnwtgokxhegoifakimxbba"
         "fkeannglvsxprqzfekdinssqymtfexf");
     assert_int_equal(str->len, 1204);
-    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 10);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 16);
     assert_null(bc_string_free(str, true));
     str = bc_string_new();
     str = bc_string_append(str, NULL);
@@ -581,12 +742,50 @@ test_string_append_c(void **state)
         "ccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccc"
         "cccccccccccccccccccccccccccccccccccccccccccccccccccc");
     assert_int_equal(str->len, 604);
-    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 5);
+    assert_int_equal(str->allocated_len, BC_STRING_CHUNK_SIZE * 8);
     assert_null(bc_string_free(str, true));
     assert_null(bc_string_append_c(NULL, 0));
 }
 
 
+static void
+test_string_append_growth(void **state)
+{
+    // building a 2MB string one char at a time must not realloc for every
+    // BC_STRING_CHUNK_SIZE bytes appended.
+    size_t reallocs = 0;
+    bc_string_t *str = bc_string_new();
+    size_t allocated_len = str->allocated_len;
+    for (size_t i = 0; i < 2 * 1024 * 1024; i++) {
+        str = bc_string_append_c(str, 'a' + (i % 26));
+        if (str->allocated_len != allocated_len) {
+            allocated_len = str->allocated_len;
+            reallocs++;
+        }
+    }
+    assert_int_equal(str->len, 2 * 1024 * 1024);
+    assert_int_equal(str->str[str->len - 1], 'a' + ((str->len - 1) % 26));
+    assert_int_equal(str->str[str->len], '\0');
+    assert_true(reallocs <= 15);
+    assert_null(bc_string_free(str, true));
+    char buffer[1024];
+    memset(buffer, 'a', sizeof(buffer));
+    reallocs = 0;
+    str = bc_string_new();
+    allocated_len = str->allocated_len;
+    for (size_t i = 0; i < 2 * 1024; i++) {
+        str = bc_string_append_len(str, buffer, sizeof(buffer));
+        if (str->allocated_len != allocated_len) {
+            allocated_len = str->allocated_len;
+            reallocs++;
+        }
+    }
+    assert_int_equal(str->len, 2 * 1024 * 1024);
+    assert_true(reallocs <= 15);
+    assert_null(bc_string_free(str, true));
+}
+
+
 static void
 test_string_append_printf(void **state)
 {
@@ -628,7 +827,11 @@ test_trie_new(void **state)
 {
     bc_trie_t *trie = bc_trie_new(free);
     assert_non_null(trie);
-    assert_null(trie->root);
+    assert_null(trie->entries);
+    assert_int_equal(trie->len, 0);
+    assert_int_equal(trie->allocated_len, 0);
+    assert_null(trie->buckets);
+    assert_int_equal(trie->buckets_len, 0);
     assert_true(trie->free_func == free);
     bc_trie_free(trie);
 }
@@ -640,197 +843,84 @@ test_trie_insert(void **state)
     bc_trie_t *trie = bc_trie_new(free);
 
     bc_trie_insert(trie, "bola", bc_strdup("guda"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
-
+    assert_int_equal(trie->len, 1);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
 
     bc_trie_insert(trie, "chu", bc_strdup("nda"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
-
-    assert_true(trie->root->next->key == 'c');
-    assert_null(trie->root->next->data);
-    assert_true(trie->root->next->child->key == 'h');
-    assert_null(trie->root->next->child->data);
-    assert_true(trie->root->next->child->child->key == 'u');
-    assert_null(trie->root->next->child->child->data);
-    assert_true(trie->root->next->child->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->child->data, "nda");
-
+    assert_int_equal(trie->len, 2);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
+    assert_string_equal(trie->entries[1].key, "chu");
+    assert_string_equal(trie->entries[1].data, "nda");
 
     bc_trie_insert(trie, "bote", bc_strdup("aba"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
-
-    assert_true(trie->root->next->key == 'c');
-    assert_null(trie->root->next->data);
-    assert_true(trie->root->next->child->key == 'h');
-    assert_null(trie->root->next->child->data);
-    assert_true(trie->root->next->child->child->key == 'u');
-    assert_null(trie->root->next->child->child->data);
-    assert_true(trie->root->next->child->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->child->data, "nda");
-
-    assert_true(trie->root->child->child->next->key == 't');
-    assert_null(trie->root->child->child->next->data);
-    assert_true(trie->root->child->child->next->child->key == 'e');
-    assert_null(trie->root->child->child->next->child->data);
-    assert_true(trie->root->child->child->next->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->next->child->child->data, "aba");
-
+    assert_int_equal(trie->len, 3);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
+    assert_string_equal(trie->entries[1].key, "chu");
+    assert_string_equal(trie->entries[1].data, "nda");
+    assert_string_equal(trie->entries[2].key, "bote");
+    assert_string_equal(trie->entries[2].data, "aba");
 
     bc_trie_insert(trie, "bo", bc_strdup("haha"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
-
-    assert_true(trie->root->next->key == 'c');
-    assert_null(trie->root->next->data);
-    assert_true(trie->root->next->child->key == 'h');
-    assert_null(trie->root->next->child->data);
-    assert_true(trie->root->next->child->child->key == 'u');
-    assert_null(trie->root->next->child->child->data);
-    assert_true(trie->root->next->child->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->child->data, "nda");
-
-    assert_true(trie->root->child->child->next->key == 't');
-    assert_null(trie->root->child->child->next->data);
-    assert_true(trie->root->child->child->next->child->key == 'e');
-    assert_null(trie->root->child->child->next->child->data);
-    assert_true(trie->root->child->child->next->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->next->child->child->data, "aba");
-
-    assert_true(trie->root->child->child->next->next->key == '\0');
-    assert_string_equal(trie->root->child->child->next->next->data, "haha");
+    assert_int_equal(trie->len, 4);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
+    assert_string_equal(trie->entries[1].key, "chu");
+    assert_string_equal(trie->entries[1].data, "nda");
+    assert_string_equal(trie->entries[2].key, "bote");
+    assert_string_equal(trie->entries[2].data, "aba");
+    assert_string_equal(trie->entries[3].key, "bo");
+    assert_string_equal(trie->entries[3].data, "haha");
 
     bc_trie_free(trie);
 
-
     trie = bc_trie_new(free);
 
     bc_trie_insert(trie, "chu", bc_strdup("nda"));
-    assert_true(trie->root->key == 'c');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'h');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'u');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->data, "nda");
-
-
     bc_trie_insert(trie, "bola", bc_strdup("guda"));
-    assert_true(trie->root->key == 'c');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'h');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'u');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->data, "nda");
-
-    assert_true(trie->root->next->key == 'b');
-    assert_null(trie->root->next->data);
-    assert_true(trie->root->next->child->key == 'o');
-    assert_null(trie->root->next->child->data);
-    assert_true(trie->root->next->child->child->key == 'l');
-    assert_null(trie->root->next->child->child->data);
-    assert_true(trie->root->next->child->child->child->key == 'a');
-    assert_null(trie->root->next->child->child->child->data);
-    assert_true(trie->root->next->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->child->child->data, "guda");
+    bc_trie_insert(trie, "bote", bc_strdup("aba"));
+    bc_trie_insert(trie, "bo", bc_strdup("haha"));
+    assert_int_equal(trie->len, 4);
+    assert_string_equal(trie->entries[0].key, "chu");
+    assert_string_equal(trie->entries[0].data, "nda");
+    assert_string_equal(trie->entries[1].key, "bola");
+    assert_string_equal(trie->entries[1].data, "guda");
+    assert_string_equal(trie->entries[2].key, "bote");
+    assert_string_equal(trie->entries[2].data, "aba");
+    assert_string_equal(trie->entries[3].key, "bo");
+    assert_string_equal(trie->entries[3].data, "haha");
 
+    bc_trie_free(trie);
+}
 
-    bc_trie_insert(trie, "bote", bc_strdup("aba"));
-    assert_true(trie->root->key == 'c');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'h');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'u');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->data, "nda");
-
-    assert_true(trie->root->next->key == 'b');
-    assert_null(trie->root->next->data);
-    assert_true(trie->root->next->child->key == 'o');
-    assert_null(trie->root->next->child->data);
-    assert_true(trie->root->next->child->child->key == 'l');
-    assert_null(trie->root->next->child->child->data);
-    assert_true(trie->root->next->child->child->child->key == 'a');
-    assert_null(trie->root->next->child->child->child->data);
-    assert_true(trie->root->next->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->child->child->data, "guda");
-
-    assert_true(trie->root->next->child->child->next->key == 't');
-    assert_null(trie->root->next->child->child->next->data);
-    assert_true(trie->root->next->child->child->next->child->key == 'e');
-    assert_null(trie->root->next->child->child->next->child->data);
-    assert_true(trie->root->next->child->child->next->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->next->child->child->data, "aba");
 
+static void
+test_trie_insert_grow(void **state)
+{
+    bc_trie_t *trie = bc_trie_new(free);
 
-    bc_trie_insert(trie, "bo", bc_strdup("haha"));
-    assert_true(trie->root->key == 'c');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'h');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'u');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->data, "nda");
-
-    assert_true(trie->root->next->key == 'b');
-    assert_null(trie->root->next->data);
-    assert_true(trie->root->next->child->key == 'o');
-    assert_null(trie->root->next->child->data);
-    assert_true(trie->root->next->child->child->key == 'l');
-    assert_null(trie->root->next->child->child->data);
-    assert_true(trie->root->next->child->child->child->key == 'a');
-    assert_null(trie->root->next->child->child->child->data);
-    assert_true(trie->root->next->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->child->child->data, "guda");
-
-    assert_true(trie->root->next->child->child->next->key == 't');
-    assert_null(trie->root->next->child->child->next->data);
-    assert_true(trie->root->next->child->child->next->child->key == 'e');
-    assert_null(trie->root->next->child->child->next->child->data);
-    assert_true(trie->root->next->child->child->next->child->child->key == '\0');
-    assert_string_equal(trie->root->next->child->child->next->child->child->data, "aba");
-
-    assert_true(trie->root->next->child->child->next->next->key == '\0');
-    assert_string_equal(trie->root->next->child->child->next->next->data, "haha");
+    for (size_t i = 0; i < 1000; i++) {
+        char *key = bc_strdup_printf("KEY_%zu", i);
+        bc_trie_insert(trie, key, bc_strdup_printf("value %zu", i));
+        free(key);
+    }
+    assert_int_equal(trie->len, 1000);
+    assert_int_equal(trie->allocated_len, 1024);
+    assert_int_equal(trie->buckets_len, 2048);
+    assert_int_equal(bc_trie_size(trie), 1000);
+
+    for (size_t i = 0; i < 1000; i++) {
+        char *key = bc_strdup_printf("KEY_%zu", i);
+        char *value = bc_strdup_printf("value %zu", i);
+        assert_string_equal(trie->entries[i].key, key);
+        assert_string_equal(bc_trie_lookup(trie, key), value);
+        free(value);
+        free(key);
+    }
+    assert_null(bc_trie_lookup(trie, "KEY_1000"));
+    assert_null(bc_trie_lookup(trie, "KEY_"));
 
     bc_trie_free(trie);
 }
@@ -842,28 +932,15 @@ test_trie_insert_duplicated(void **state)
     bc_trie_t *trie = bc_trie_new(free);
 
     bc_trie_insert(trie, "bola", bc_strdup("guda"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
+    assert_int_equal(trie->len, 1);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
 
     bc_trie_insert(trie, "bola", bc_strdup("asdf"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "asdf");
+    assert_int_equal(trie->len, 1);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "asdf");
+    assert_string_equal(bc_trie_lookup(trie, "bola"), "asdf");
 
     bc_trie_free(trie);
 
@@ -972,8 +1049,8 @@ test_trie_size(void **state)
 
 
 static size_t counter;
-static char *expected_keys[] = {"chu", "copa", "bola", "bote", "bo", "b", "test", "testa"};
-static char *expected_datas[] = {"nda", "bu", "guda", "aba", "haha", "c", "asd", "lol"};
+static char *expected_keys[] = {"chu", "bola", "bote", "bo", "copa", "b", "test", "testa"};
+static char *expected_datas[] = {"nda", "guda", "aba", "haha", "bu", "c", "asd", "lol"};
 
 static void
 mock_foreach(const char *key, void *data, void *user_data)
@@ -1015,39 +1092,22 @@ test_trie_inserted_after_prefix(void **state)
     bc_trie_t *trie = bc_trie_new(free);
 
     bc_trie_insert(trie, "bola", bc_strdup("guda"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
+    assert_int_equal(trie->len, 1);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
 
     bc_trie_insert(trie, "bolaoo", bc_strdup("asdf"));
-    assert_true(trie->root->key == 'b');
-    assert_null(trie->root->data);
-    assert_true(trie->root->child->key == 'o');
-    assert_null(trie->root->child->data);
-    assert_true(trie->root->child->child->key == 'l');
-    assert_null(trie->root->child->child->data);
-    assert_true(trie->root->child->child->child->key == 'a');
-    assert_null(trie->root->child->child->child->data);
-    assert_true(trie->root->child->child->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->data, "guda");
-    assert_non_null(trie->root->child->child->child->child->next);
-    assert_true(trie->root->child->child->child->child->next->key == 'o');
-    assert_null(trie->root->child->child->child->child->next->data);
-    assert_true(trie->root->child->child->child->child->next->child->key == 'o');
-    assert_null(trie->root->child->child->child->child->next->child->data);
-    assert_true(trie->root->child->child->child->child->next->child->child->key == '\0');
-    assert_string_equal(trie->root->child->child->child->child->next->child->child->data, "asdf");
+    assert_int_equal(trie->len, 2);
+    assert_string_equal(trie->entries[0].key, "bola");
+    assert_string_equal(trie->entries[0].data, "guda");
+    assert_string_equal(trie->entries[1].key, "bolaoo");
+    assert_string_equal(trie->entries[1].data, "asdf");
 
     assert_int_equal(bc_trie_size(trie), 2);
     assert_string_equal(bc_trie_lookup(trie, "bola"), "guda");
     assert_string_equal(bc_trie_lookup(trie, "bolaoo"), "asdf");
+    assert_null(bc_trie_lookup(trie, "bolao"));
+    assert_null(bc_trie_lookup(trie, "bol"));
 
     bc_trie_free(trie);
 }
@@ -1081,6 +1141,57 @@ test_shell_quote(void **state)
 }
 
 
+static void
+test_alloc_stats(void **state)
+{
+    bc_alloc_stats_reset();
+    bc_alloc_stats_enable(true);
+    assert_true(bc_alloc_stats_enabled());
+    int line = __LINE__ + 1;
+    char *a = bc_malloc(10);
+    char *b = bc_strdup("bola");
+    char *c = bc_strdup_printf("%s%d", "guda", 12);
+    c = bc_realloc(c, 300);
+    bc_alloc_stats_enable(false);
+    assert_false(bc_alloc_stats_enabled());
+    char *d = bc_malloc(10);
+
+    bc_alloc_stats_t stats;
+    bc_alloc_stats_get(&stats);
+    assert_int_equal(stats.calls, 4);
+    assert_int_equal(stats.bytes, 10 + 5 + 7 + 300);
+    assert_int_equal(stats.histogram[2], 2);
+    assert_int_equal(stats.histogram[3], 1);
+    assert_int_equal(stats.histogram[8], 1);
+
+    // only len entries are written
+    bc_alloc_site_t sites[5];
+    memset(sites, 0, sizeof(sites));
+    assert_int_equal(bc_alloc_stats_get_sites(sites, 2), 2);
+    assert_null(sites[2].file);
+    assert_int_equal(bc_alloc_stats_get_sites(sites, 5), 4);
+    for (size_t i = 0; i < 4; i++) {
+        assert_string_equal(sites[i].file, __FILE__);
+        assert_int_equal(sites[i].calls, 1);
+    }
+    assert_int_equal(sites[0].line, line + 3);
+    assert_int_equal(sites[0].bytes, 300);
+    assert_int_equal(sites[1].line, line);
+    assert_int_equal(sites[1].bytes, 10);
+
+    bc_alloc_stats_reset();
+    bc_alloc_stats_get(&stats);
+    assert_int_equal(stats.calls, 0);
+    assert_int_equal(stats.bytes, 0);
+    assert_int_equal(bc_alloc_stats_get_sites(sites, 5), 0);
+
+    free(a);
+    free(b);
+    free(c);
+    free(d);
+}
+
+
 int
 main(void)
 {
@@ -1088,6 +1199,7 @@ main(void)
 
         // slist
         cmocka_unit_test(test_slist_append),
+        cmocka_unit_test(test_slist_append_tail),
         cmocka_unit_test(test_slist_prepend),
         cmocka_unit_test(test_slist_append_list),
         cmocka_unit_test(test_slist_free),
@@ -1109,19 +1221,27 @@ main(void)
         cmocka_unit_test(test_strv_join),
         cmocka_unit_test(test_strv_length),
 
+        // strview
+        cmocka_unit_test(test_strview),
+        cmocka_unit_test(test_strview_split_next),
+
         // string
         cmocka_unit_test(test_string_new),
+        cmocka_unit_test(test_string_new_sized),
+        cmocka_unit_test(test_string_reserve),
         cmocka_unit_test(test_string_free),
         cmocka_unit_test(test_string_dup),
         cmocka_unit_test(test_string_append_len),
         cmocka_unit_test(test_string_append),
         cmocka_unit_test(test_string_append_c),
+        cmocka_unit_test(test_string_append_growth),
         cmocka_unit_test(test_string_append_printf),
         cmocka_unit_test(test_string_append_escaped),
 
         // trie
         cmocka_unit_test(test_trie_new),
         cmocka_unit_test(test_trie_insert),
+        cmocka_unit_test(test_trie_insert_grow),
         cmocka_unit_test(test_trie_insert_duplicated),
         cmocka_unit_test(test_trie_keep_data),
         cmocka_unit_test(test_trie_lookup),
@@ -1131,6 +1251,7 @@ main(void)
 
         // shell
         cmocka_unit_test(test_shell_quote),
+        cmocka_unit_test(test_alloc_stats),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }